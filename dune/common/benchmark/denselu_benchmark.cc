@@ -0,0 +1,127 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark for solving with the same matrix for many right-hand sides.
+ *
+ * For random nxn FieldMatrix objects, `rhs` right-hand sides are solved
+ * with DenseMatrix::solve, which factorizes the matrix in every call, with
+ * one DenseLU and one DenseCholesky for all right-hand sides, and with the
+ * multi-RHS solve of DenseLU.  The time per right-hand side is printed,
+ * including the factorization.
+ *
+ * Usage: ./denselu_benchmark [options]
+ *
+ * options:
+ * -rhs: default: 16. Number of right-hand sides per matrix.
+ * -repeat: default: 100000. Number of matrices.
+ * -nohdr: default: 0. Suppress output of the header.
+ *
+ * options can be passed at the command-line (-key value).
+ */
+
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <dune/common/densecholesky.hh>
+#include <dune/common/denselu.hh>
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+#include <dune/common/timer.hh>
+
+// prevents the compiler from removing the computation of value
+template<class T>
+void use(const T& value)
+{
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+// Returns the time per right-hand side of repeat calls of f
+template<class F>
+double measure(F&& f, std::size_t rhs, std::size_t repeat)
+{
+  Dune::Timer watch;
+  for (std::size_t r = 0; r < repeat; ++r)
+    f();
+  return watch.elapsed() / (rhs * repeat);
+}
+
+template<int n>
+void run(std::size_t rhs, std::size_t repeat)
+{
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  // symmetric positive definite, so that all variants apply
+  Dune::FieldMatrix<double,n,n> A;
+  for (int i = 0; i < n; ++i)
+  {
+    for (int j = 0; j < i; ++j)
+      A[i][j] = A[j][i] = dist(rng);
+    A[i][i] = 2.0*n;
+  }
+  std::vector<Dune::FieldVector<double,n>> b(rhs), x(rhs);
+  Dune::DynamicMatrix<double> B(n, rhs), X(n, rhs);
+  for (std::size_t k = 0; k < rhs; ++k)
+    for (int i = 0; i < n; ++i)
+      B[i][k] = b[k][i] = dist(rng);
+
+  const double solve = measure([&]{
+    for (std::size_t k = 0; k < rhs; ++k)
+      A.solve(x[k], b[k]);
+    use(x);
+  }, rhs, repeat);
+  const double lu = measure([&]{
+    Dune::DenseLU<Dune::FieldMatrix<double,n,n>> factorization(A);
+    for (std::size_t k = 0; k < rhs; ++k)
+      factorization.solve(x[k], b[k]);
+    use(x);
+  }, rhs, repeat);
+  const double cholesky = measure([&]{
+    Dune::DenseCholesky<Dune::FieldMatrix<double,n,n>> factorization(A);
+    for (std::size_t k = 0; k < rhs; ++k)
+      factorization.solve(x[k], b[k]);
+    use(x);
+  }, rhs, repeat);
+  const double multi = measure([&]{
+    Dune::DenseLU<Dune::FieldMatrix<double,n,n>>(A).solve(X, B);
+    use(X);
+  }, rhs, repeat);
+
+  std::cout << std::setw(6) << n
+            << std::setw(16) << solve
+            << std::setw(16) << lu
+            << std::setw(16) << cholesky
+            << std::setw(16) << multi
+            << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  Dune::ParameterTree options;
+  Dune::ParameterTreeParser::readOptions(argc, argv, options);
+
+  const std::size_t rhs = options.get("rhs", 16);
+  const std::size_t repeat = options.get("repeat", 100000);
+
+  std::cout << std::left << std::scientific;
+  if (options.get("nohdr", 0) == 0)
+    std::cout << std::setw(6) << "n"
+              << std::setw(16) << "solve"
+              << std::setw(16) << "DenseLU"
+              << std::setw(16) << "DenseCholesky"
+              << std::setw(16) << "multi-RHS"
+              << std::endl;
+  run<4>(rhs, repeat);
+  run<8>(rhs, repeat);
+  run<16>(rhs, repeat);
+  run<32>(rhs, repeat / 10);
+  return 0;
+}
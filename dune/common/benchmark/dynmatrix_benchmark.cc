@@ -0,0 +1,123 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark for the BLAS and LAPACK fast path of DynamicMatrix.
+ *
+ * For square matrices of several sizes, the time per call of mv, mtv,
+ * rightmultiply, solve and invert is printed, once for the generic
+ * implementation of DenseMatrix and once for DynamicMatrix, which forwards
+ * to BLAS and LAPACK from DUNE_DYNAMICMATRIX_BLAS_THRESHOLD on.  Each
+ * operation is repeated until about `flops` floating point operations are
+ * done.
+ *
+ * Usage: ./dynmatrix_benchmark [options]
+ *
+ * options:
+ * -flops: default: 1e9. Number of floating point operations per measurement.
+ * -nohdr: default: 0. Suppress output of the header.
+ *
+ * options can be passed at the command-line (-key value).
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+#include <dune/common/timer.hh>
+
+// prevents the compiler from removing the computation of value
+template<class T>
+void use(const T& value)
+{
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+// Returns the time per call of f, which does about work operations
+template<class F>
+double measure(F&& f, double work, double flops)
+{
+  const std::size_t repeat = std::max(1.0, flops / work);
+  Dune::Timer watch;
+  for (std::size_t r = 0; r < repeat; ++r)
+    f();
+  return watch.elapsed() / repeat;
+}
+
+// Measures the operations on matrix type M, which is either DynamicMatrix or
+// its base class DenseMatrix
+template<class M>
+void run(const std::string& name, const Dune::DynamicMatrix<double>& matrix,
+         const Dune::DynamicVector<double>& x, double flops)
+{
+  const double n = matrix.N();
+  const M& A = matrix;
+  Dune::DynamicVector<double> y(x.size());
+
+  std::cout << std::setw(6) << matrix.N() << std::setw(10) << name;
+  std::cout << std::setw(16) << measure([&]{ A.mv(x, y); use(y); }, 2*n*n, flops);
+  std::cout << std::setw(16) << measure([&]{ A.mtv(x, y); use(y); }, 2*n*n, flops);
+  Dune::DynamicMatrix<double> product;
+  std::cout << std::setw(16) << measure([&]{
+    product = matrix;
+    static_cast<M&>(product).rightmultiply(matrix);
+    use(product);
+  }, 2*n*n*n, flops);
+  std::cout << std::setw(16) << measure([&]{ A.solve(y, x); use(y); }, 2*n*n*n/3, flops);
+  Dune::DynamicMatrix<double> inverse;
+  std::cout << std::setw(16) << measure([&]{
+    inverse = matrix;
+    static_cast<M&>(inverse).invert();
+    use(inverse);
+  }, 2*n*n*n, flops);
+  std::cout << std::endl;
+}
+
+void run(std::size_t n, double flops)
+{
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  Dune::DynamicMatrix<double> matrix(n, n);
+  Dune::DynamicVector<double> x(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    x[i] = dist(rng);
+    for (std::size_t j = 0; j < n; ++j)
+      matrix[i][j] = dist(rng) / n;
+    matrix[i][i] += (i % 2 ? -1.0 : 1.0);
+  }
+
+  run<Dune::DenseMatrix<Dune::DynamicMatrix<double>>>("generic", matrix, x, flops);
+  run<Dune::DynamicMatrix<double>>("dynamic", matrix, x, flops);
+}
+
+int main(int argc, char** argv)
+{
+  Dune::ParameterTree options;
+  Dune::ParameterTreeParser::readOptions(argc, argv, options);
+
+  const double flops = options.get("flops", 1e9);
+
+  std::cout << std::left << std::scientific;
+  if (options.get("nohdr", 0) == 0)
+    std::cout << std::setw(6) << "n"
+              << std::setw(10) << "variant"
+              << std::setw(16) << "mv"
+              << std::setw(16) << "mtv"
+              << std::setw(16) << "rightmultiply"
+              << std::setw(16) << "solve"
+              << std::setw(16) << "invert"
+              << std::endl;
+  for (std::size_t n : {16, 32, 48, 64, 96, 128, 256, 512})
+    run(n, flops);
+  return 0;
+}
@@ -0,0 +1,191 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark for FieldMatrixBatch.
+ *
+ * Applies mv, mtv, rightmultiply, solve, invert, determinant and the
+ * Cholesky solve to `size` random symmetric positive definite 3x3, 4x4 and
+ * 8x8 matrices, once with a loop over the FieldMatrix objects and once with
+ * a FieldMatrixBatch of 4 and of 8 lanes. Each
+ * operation is repeated `repeat` times and the time per matrix is printed.
+ * Packing the matrices into the batch is not included in the times.
+ *
+ * Usage: ./fmatrixbatch_benchmark [options]
+ *
+ * options:
+ * -size: default: 100000. Number of matrices.
+ * -repeat: default: 10. Number of repetitions of each operation.
+ * -nohdr: default: 0. Suppress output of the header.
+ *
+ * options can be passed at the command-line (-key value).
+ */
+
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <dune/common/densecholesky.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fmatrixbatch.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+#include <dune/common/timer.hh>
+
+// prevents the compiler from removing the computation of value
+template<class T>
+void use(const T& value)
+{
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+// Returns the time per matrix of repeat calls of f
+template<class F>
+double measure(F&& f, std::size_t size, std::size_t repeat)
+{
+  Dune::Timer watch;
+  for (std::size_t r = 0; r < repeat; ++r)
+    f();
+  return watch.elapsed() / (size * repeat);
+}
+
+// Measures the loop over the matrices
+template<int n>
+std::vector<double> measureLoop(const std::vector<Dune::FieldMatrix<double,n,n>>& matrices,
+                                const std::vector<Dune::FieldVector<double,n>>& x,
+                                std::size_t repeat)
+{
+  const std::size_t size = matrices.size();
+  std::vector<Dune::FieldVector<double,n>> y(size);
+  std::vector<double> det(size);
+  std::vector<double> times;
+
+  times.push_back(measure([&]{
+    for (std::size_t k = 0; k < size; ++k)
+      matrices[k].mv(x[k], y[k]);
+    use(y);
+  }, size, repeat));
+  times.push_back(measure([&]{
+    for (std::size_t k = 0; k < size; ++k)
+      matrices[k].mtv(x[k], y[k]);
+    use(y);
+  }, size, repeat));
+  auto product = matrices;
+  times.push_back(measure([&]{
+    for (std::size_t k = 0; k < size; ++k)
+      product[k].rightmultiply(matrices[k]);
+    use(product);
+  }, size, repeat));
+  times.push_back(measure([&]{
+    for (std::size_t k = 0; k < size; ++k)
+      matrices[k].solve(y[k], x[k]);
+    use(y);
+  }, size, repeat));
+  auto inverse = matrices;
+  times.push_back(measure([&]{
+    for (std::size_t k = 0; k < size; ++k)
+      inverse[k].invert();
+    use(inverse);
+  }, size, repeat));
+  times.push_back(measure([&]{
+    for (std::size_t k = 0; k < size; ++k)
+      det[k] = matrices[k].determinant();
+    use(det);
+  }, size, repeat));
+  times.push_back(measure([&]{
+    for (std::size_t k = 0; k < size; ++k)
+      Dune::DenseCholesky<Dune::FieldMatrix<double,n,n>>(matrices[k]).solve(y[k], x[k]);
+    use(y);
+  }, size, repeat));
+  return times;
+}
+
+// Measures the batch of the matrices
+template<int n, std::size_t lanes>
+std::vector<double> measureBatch(const std::vector<Dune::FieldMatrix<double,n,n>>& matrices,
+                                 const std::vector<Dune::FieldVector<double,n>>& x,
+                                 std::size_t repeat)
+{
+  const std::size_t size = matrices.size();
+  Dune::FieldMatrixBatch<double,n,n,lanes> batch(matrices);
+  std::vector<Dune::FieldVector<double,n>> y(size);
+  std::vector<double> det(size);
+  std::vector<double> times;
+
+  times.push_back(measure([&]{ batch.mv(x, y); use(y); }, size, repeat));
+  times.push_back(measure([&]{ batch.mtv(x, y); use(y); }, size, repeat));
+  auto product = batch;
+  times.push_back(measure([&]{ product.rightmultiply(batch); use(product); }, size, repeat));
+  times.push_back(measure([&]{ batch.solve(y, x); use(y); }, size, repeat));
+  auto inverse = batch;
+  times.push_back(measure([&]{ inverse.invert(); use(inverse); }, size, repeat));
+  times.push_back(measure([&]{ batch.determinant(det); use(det); }, size, repeat));
+  times.push_back(measure([&]{ batch.choleskySolve(y, x); use(y); }, size, repeat));
+  return times;
+}
+
+template<int n>
+void run(std::size_t size, std::size_t repeat)
+{
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  std::vector<Dune::FieldMatrix<double,n,n>> matrices(size);
+  std::vector<Dune::FieldVector<double,n>> x(size);
+  for (std::size_t k = 0; k < size; ++k)
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      x[k][i] = dist(rng);
+      for (int j = 0; j < i; ++j)
+        matrices[k][i][j] = matrices[k][j][i] = dist(rng) / n;
+      // keeps the repeated inversion and products bounded
+      matrices[k][i][i] = 1.0;
+    }
+  }
+
+  const std::vector<std::pair<std::string, std::vector<double>>> results = {
+    {"loop", measureLoop<n>(matrices, x, repeat)},
+    {"batch4", measureBatch<n,4>(matrices, x, repeat)},
+    {"batch8", measureBatch<n,8>(matrices, x, repeat)}
+  };
+  for (const auto& [name, times] : results)
+  {
+    std::cout << std::setw(6) << n
+              << std::setw(10) << name;
+    for (double time : times)
+      std::cout << std::setw(16) << time;
+    std::cout << std::endl;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  Dune::ParameterTree options;
+  Dune::ParameterTreeParser::readOptions(argc, argv, options);
+
+  const std::size_t size = options.get("size", 100000);
+  const std::size_t repeat = options.get("repeat", 10);
+
+  std::cout << std::left << std::scientific;
+  if (options.get("nohdr", 0) == 0)
+    std::cout << std::setw(6) << "n"
+              << std::setw(10) << "variant"
+              << std::setw(16) << "mv"
+              << std::setw(16) << "mtv"
+              << std::setw(16) << "rightmultiply"
+              << std::setw(16) << "solve"
+              << std::setw(16) << "invert"
+              << std::setw(16) << "determinant"
+              << std::setw(16) << "choleskySolve"
+              << std::endl;
+  run<3>(size, repeat);
+  run<4>(size, repeat);
+  run<8>(size, repeat);
+  return 0;
+}
@@ -0,0 +1,138 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark for the product of two square FieldMatrix objects.
+ *
+ * For each size n, `count` pairs of random nxn matrices are multiplied
+ * repeatedly until about `flops` floating point operations are done. The
+ * achieved GFLOP/s are printed for the plain i-j-k triple loop, which
+ * operator* used before, for operator* and for rightmultiply (including a
+ * copy of the matrix).
+ *
+ * Usage: ./fmatrixproduct_benchmark [options]
+ *
+ * options:
+ * -count: default: 64. Number of matrix pairs.
+ * -flops: default: 1e9. Number of floating point operations per measurement.
+ * -nohdr: default: 0. Suppress output of the header.
+ *
+ * options can be passed at the command-line (-key value).
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+#include <dune/common/timer.hh>
+
+// prevents the compiler from removing the computation of value
+template<class T>
+void use(const T& value)
+{
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+// The plain triple loop for comparison
+template<int n>
+Dune::FieldMatrix<double,n,n> plainProduct(const Dune::FieldMatrix<double,n,n>& A,
+                                           const Dune::FieldMatrix<double,n,n>& B)
+{
+  Dune::FieldMatrix<double,n,n> C;
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+    {
+      C[i][j] = 0;
+      for (int k = 0; k < n; ++k)
+        C[i][j] += A[i][k] * B[k][j];
+    }
+  return C;
+}
+
+// Returns the GFLOP/s of repeat calls of f on count matrices of size n
+template<int n, class F>
+double measure(F&& f, std::size_t count, std::size_t repeat)
+{
+  Dune::Timer watch;
+  for (std::size_t r = 0; r < repeat; ++r)
+    f();
+  return 2.0*n*n*n*count*repeat / watch.elapsed() * 1e-9;
+}
+
+template<int n>
+void run(std::size_t count, double flops)
+{
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  std::vector<Dune::FieldMatrix<double,n,n>> A(count), B(count), C(count);
+  for (std::size_t k = 0; k < count; ++k)
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < n; ++j)
+      {
+        A[k][i][j] = dist(rng);
+        B[k][i][j] = dist(rng) / n;
+      }
+  const std::size_t repeat = std::max(1.0, flops / (2.0*n*n*n*count));
+
+  const double plain = measure<n>([&]{
+    for (std::size_t k = 0; k < count; ++k)
+      C[k] = plainProduct(A[k], B[k]);
+    use(C);
+  }, count, repeat);
+  const double product = measure<n>([&]{
+    for (std::size_t k = 0; k < count; ++k)
+      C[k] = A[k] * B[k];
+    use(C);
+  }, count, repeat);
+  // C is reset, as repeated products would end up in denormal numbers
+  const double right = measure<n>([&]{
+    for (std::size_t k = 0; k < count; ++k)
+    {
+      C[k] = A[k];
+      C[k].rightmultiply(B[k]);
+    }
+    use(C);
+  }, count, repeat);
+
+  std::cout << std::setw(6) << n
+            << std::setw(16) << plain
+            << std::setw(16) << product
+            << std::setw(16) << right
+            << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  Dune::ParameterTree options;
+  Dune::ParameterTreeParser::readOptions(argc, argv, options);
+
+  const std::size_t count = options.get("count", 64);
+  const double flops = options.get("flops", 1e9);
+
+  std::cout << std::left << std::fixed << std::setprecision(3);
+  if (options.get("nohdr", 0) == 0)
+    std::cout << std::setw(6) << "n"
+              << std::setw(16) << "plain"
+              << std::setw(16) << "operator*"
+              << std::setw(16) << "rightmultiply"
+              << std::endl;
+  run<2>(count, flops);
+  run<3>(count, flops);
+  run<4>(count, flops);
+  run<6>(count, flops);
+  run<8>(count, flops);
+  run<12>(count, flops);
+  run<16>(count, flops);
+  run<20>(count, flops);
+  run<24>(count, flops);
+  run<32>(count, flops);
+  return 0;
+}
@@ -10,6 +10,9 @@
  */
 
 #include <algorithm>
+#include <cstddef>
+#include <tuple>
+#include <utility>
 
 namespace Dune
 {
@@ -44,6 +47,69 @@ namespace Dune
       return max(t1,t2);
     }
   };
+
+  /**
+   * @brief Selects the pair with the smaller value.
+   *
+   * Type has to be a pair of a value and a location, e.g. a rank. If both
+   * values are equal the pair with the smaller location is selected. For
+   * std::pair of an arithmetic type and int this is MPI_MINLOC.
+   */
+  template<typename Type>
+  struct MinLoc
+  {
+    Type operator()(const Type& t1, const Type& t2) const
+    {
+      if (t2.first < t1.first || (!(t1.first < t2.first) && t2.second < t1.second))
+        return t2;
+      return t1;
+    }
+  };
+
+  /**
+   * @brief Selects the pair with the larger value.
+   *
+   * Type has to be a pair of a value and a location, e.g. a rank. If both
+   * values are equal the pair with the smaller location is selected. For
+   * std::pair of an arithmetic type and int this is MPI_MAXLOC.
+   */
+  template<typename Type>
+  struct MaxLoc
+  {
+    Type operator()(const Type& t1, const Type& t2) const
+    {
+      if (t1.first < t2.first || (!(t2.first < t1.first) && t2.second < t1.second))
+        return t2;
+      return t1;
+    }
+  };
+
+  /**
+   * @brief Applies a binary function to each element of tuples.
+   *
+   * The i-th element of the result is the i-th binary function applied to
+   * the i-th elements of the arguments. This allows to reduce several values
+   * with different operations in one collective communication, e.g.
+   * \code
+   * auto [sum, max] = comm.allreduce<TupleReduction<std::plus<double>, Max<int> > >(std::tuple(a, b));
+   * \endcode
+   */
+  template<typename... BinaryFunctions>
+  struct TupleReduction
+  {
+    template<typename Tuple>
+    Tuple operator()(const Tuple& t1, const Tuple& t2) const
+    {
+      return apply(t1, t2, std::index_sequence_for<BinaryFunctions...>{});
+    }
+
+  private:
+    template<typename Tuple, std::size_t... i>
+    static Tuple apply(const Tuple& t1, const Tuple& t2, std::index_sequence<i...>)
+    {
+      return Tuple(BinaryFunctions()(std::get<i>(t1), std::get<i>(t2))...);
+    }
+  };
 }
 
 #endif
@@ -0,0 +1,224 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_DENSECHOLESKY_HH
+#define DUNE_COMMON_DENSECHOLESKY_HH
+
+#include <cmath>
+#include <cstddef>
+
+#include <dune/common/boundschecking.hh>
+#include <dune/common/densematrix.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/ftraits.hh>
+#include <dune/common/matrixconcepts.hh>
+#include <dune/common/simd/simd.hh>
+#include <dune/common/typetraits.hh>
+
+/** \file
+ * \brief Cholesky factorization of symmetric positive definite dense matrices
+ */
+
+namespace Dune
+{
+
+  /** @addtogroup DenseMatVec
+      @{
+   */
+
+  /**
+   * \brief Cholesky factorization A = L L^T of a symmetric positive definite
+   *        dense matrix
+   *
+   * The counterpart of DenseLU for symmetric positive definite matrices.  It
+   * needs no pivoting and about half the operations.  Only the lower
+   * triangle of the matrix is read.
+   *
+   * For Simd field types, each lane is factorized on its own and the lanes
+   * that are not positive definite are reported by positiveDefiniteLanes().
+   * solve() and determinant() throw an FMatrixError if any lane is not
+   * positive definite.
+   *
+   * \tparam MAT the matrix type with a real field type, e.g.
+   *             FieldMatrix<K,n,n> or DynamicMatrix<K>
+   */
+  template<class MAT>
+  class DenseCholesky
+  {
+  public:
+    //! the type storing the factor
+    using matrix_type = AutonomousValue<MAT>;
+
+    //! the field type of the matrix
+    using field_type = typename DenseMatrix<matrix_type>::field_type;
+
+    //! the real type of the field type
+    using real_type = typename FieldTraits<field_type>::real_type;
+
+    //! the type used for sizes
+    using size_type = typename DenseMatrix<matrix_type>::size_type;
+
+    //! the type of the mask of positive definite lanes
+    using mask_type = Simd::Mask<real_type>;
+
+    static_assert(std::is_same_v<field_type, real_type>,
+                  "DenseCholesky needs a real field type");
+
+    //! Constructs an empty factorization
+    DenseCholesky () = default;
+
+    //! Computes the factorization of A
+    explicit DenseCholesky (const MAT& A)
+    {
+      factorize(A);
+    }
+
+    /** \brief Computes the factorization of A, replacing the current one
+     *
+     * \exception FMatrixError if A is not square
+     */
+    void factorize (const MAT& A)
+    {
+      using std::sqrt;
+      if (A.rows() != A.cols())
+        DUNE_THROW(FMatrixError, "Can't factorize a " << A.rows() << "x" << A.cols() << " matrix!");
+
+      // row-wise in place, l_[i][j] is read before it is overwritten
+      l_ = A;
+      positive_ = mask_type(true);
+      for (size_type i = 0; i < N(); ++i)
+      {
+        auto& li = l_[i];
+        for (size_type j = 0; j < i; ++j)
+        {
+          auto& lj = l_[j];
+          li[j] = (li[j] - dot(li, lj, j)) / lj[j];
+          lj[i] = field_type(0);
+        }
+        const field_type d = li[i] - dot(li, li, i);
+        positive_ = positive_ && (d > real_type(0));
+        li[i] = sqrt(d);
+      }
+    }
+
+    /** \brief Solve A x = b
+     *
+     * \exception FMatrixError if the matrix is not positive definite in any lane
+     */
+    template<class V1, class V2>
+      requires (!Impl::IsDenseMatrix_v<V1>)
+    void solve (V1& x, const V2& b) const
+    {
+      checkPositiveDefinite();
+      DUNE_ASSERT_BOUNDS(b.size() == N());
+      x = b;
+
+      // L y = b
+      for (size_type i = 0; i < N(); ++i)
+      {
+        for (size_type j = 0; j < i; ++j)
+          x[i] -= l_[i][j]*x[j];
+        x[i] /= l_[i][i];
+      }
+
+      // L^T x = y
+      for (size_type i = N(); i > 0;)
+      {
+        --i;
+        for (size_type j = i+1; j < N(); ++j)
+          x[i] -= l_[j][i]*x[j];
+        x[i] /= l_[i][i];
+      }
+    }
+
+    /** \brief Solve A X = B for the columns of B
+     *
+     * \exception FMatrixError if the matrix is not positive definite in any lane
+     */
+    template<class M1, class M2>
+      requires Impl::IsDenseMatrix_v<M1>
+    void solve (M1& X, const M2& B) const
+    {
+      checkPositiveDefinite();
+      DUNE_ASSERT_BOUNDS(B.N() == N());
+      X = B;
+      const size_type m = B.M();
+
+      for (size_type i = 0; i < N(); ++i)
+      {
+        for (size_type j = 0; j < i; ++j)
+          for (size_type k = 0; k < m; ++k)
+            X[i][k] -= l_[i][j]*X[j][k];
+        for (size_type k = 0; k < m; ++k)
+          X[i][k] /= l_[i][i];
+      }
+
+      for (size_type i = N(); i > 0;)
+      {
+        --i;
+        for (size_type j = i+1; j < N(); ++j)
+          for (size_type k = 0; k < m; ++k)
+            X[i][k] -= l_[j][i]*X[j][k];
+        for (size_type k = 0; k < m; ++k)
+          X[i][k] /= l_[i][i];
+      }
+    }
+
+    /** \brief The determinant of the matrix
+     *
+     * \exception FMatrixError if the matrix is not positive definite in any lane
+     */
+    field_type determinant () const
+    {
+      checkPositiveDefinite();
+      field_type det(1);
+      for (size_type i = 0; i < N(); ++i)
+        det *= l_[i][i];
+      return det*det;
+    }
+
+    //! The lanes in which the matrix is positive definite
+    const mask_type& positiveDefiniteLanes () const
+    {
+      return positive_;
+    }
+
+    //! The lower triangular factor L, its strict upper triangle is zero
+    const matrix_type& factor () const
+    {
+      return l_;
+    }
+
+    //! number of rows and columns of the matrix
+    size_type N () const
+    {
+      return l_.N();
+    }
+
+  private:
+    // the sum of x[k]*y[k] over the first n entries of the rows x and y
+    template<class Row>
+    static field_type dot (const Row& x, const Row& y, size_type n)
+    {
+      field_type sum(0);
+      for (auto xk = x.begin(), yk = y.begin(); xk != x.begin() + n; ++xk, ++yk)
+        sum += (*xk) * (*yk);
+      return sum;
+    }
+
+    void checkPositiveDefinite () const
+    {
+      if (!Simd::allTrue(positive_))
+        DUNE_THROW(FMatrixError, "matrix is not positive definite");
+    }
+
+    matrix_type l_;
+    mask_type positive_ = mask_type(true);
+  };
+
+  /** @} end documentation */
+
+} // end namespace Dune
+
+#endif // DUNE_COMMON_DENSECHOLESKY_HH
@@ -0,0 +1,266 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_DENSELU_HH
+#define DUNE_COMMON_DENSELU_HH
+
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <dune/common/boundschecking.hh>
+#include <dune/common/densematrix.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/ftraits.hh>
+#include <dune/common/matrixconcepts.hh>
+#include <dune/common/simd/simd.hh>
+#include <dune/common/typetraits.hh>
+
+/** \file
+ * \brief LU factorization of dense matrices for repeated solves
+ */
+
+namespace Dune
+{
+
+  namespace Impl
+  {
+    // The pivots of a FieldMatrix are stored without dynamic allocation
+    template<class MAT, class I>
+    struct DenseLUPivots
+    {
+      using type = std::vector<I>;
+    };
+
+    template<class K, int n, class I>
+    struct DenseLUPivots<FieldMatrix<K,n,n>, I>
+    {
+      using type = std::array<I,n>;
+    };
+
+  } // end namespace Impl
+
+  /** @addtogroup DenseMatVec
+      @{
+   */
+
+  /**
+   * \brief LU factorization of a square dense matrix
+   *
+   * DenseMatrix::solve() and DenseMatrix::determinant() factorize the matrix
+   * on every call.  DenseLU computes the same LU factorization with partial
+   * pivoting once and stores the factors and the pivots, so that systems with
+   * the same matrix can be solved for many right-hand sides.  For a
+   * FieldMatrix, no dynamic memory is allocated.
+   *
+   * For Simd field types, each lane is factorized on its own.  Singular
+   * lanes do not make the factorization throw, they are reported by
+   * nonsingularLanes().  As for DenseMatrix, solve() throws an FMatrixError
+   * if any lane is singular, while determinant() returns zero in the
+   * singular lanes.
+   *
+   * \tparam MAT the matrix type, e.g. FieldMatrix<K,n,n> or DynamicMatrix<K>
+   */
+  template<class MAT>
+  class DenseLU
+  {
+  public:
+    //! the type storing the factors
+    using matrix_type = AutonomousValue<MAT>;
+
+    //! the field type of the matrix
+    using field_type = typename DenseMatrix<matrix_type>::field_type;
+
+    //! the real type of the field type
+    using real_type = typename FieldTraits<field_type>::real_type;
+
+    //! the type used for sizes
+    using size_type = typename DenseMatrix<matrix_type>::size_type;
+
+    //! the type of the pivot indices, a Simd type for Simd field types
+    using index_type = Simd::Rebind<std::size_t, field_type>;
+
+    //! the type of the mask of nonsingular lanes
+    using mask_type = Simd::Mask<real_type>;
+
+    //! Constructs an empty factorization
+    DenseLU () = default;
+
+    //! Computes the factorization of A
+    explicit DenseLU (const MAT& A, bool doPivoting = true)
+    {
+      factorize(A, doPivoting);
+    }
+
+    /** \brief Computes the factorization of A, replacing the current one
+     *
+     * \exception FMatrixError if A is not square
+     */
+    void factorize (const MAT& A, bool doPivoting = true)
+    {
+      if (A.rows() != A.cols())
+        DUNE_THROW(FMatrixError, "Can't factorize a " << A.rows() << "x" << A.cols() << " matrix!");
+
+      lu_ = A;
+      if constexpr (requires { pivots_.resize(A.rows()); })
+        pivots_.resize(A.rows());
+      for (size_type i = 0; i < A.rows(); ++i)
+        pivots_[i] = i;
+      sign_ = field_type(1);
+      nonsingular_ = mask_type(true);
+      matrix_type::luDecomposition(lu_, PivotRecorder{*this}, nonsingular_, false, doPivoting);
+    }
+
+    /** \brief Solve A x = b
+     *
+     * \exception FMatrixError if the matrix is singular in any lane
+     */
+    template<class V1, class V2>
+      requires (!Impl::IsDenseMatrix_v<V1>)
+    void solve (V1& x, const V2& b) const
+    {
+      using std::swap;
+      checkNonsingular();
+      DUNE_ASSERT_BOUNDS(b.size() == N());
+      x = b;
+
+      // P b, the pivots are the row swaps of the elimination in order
+      for (size_type i = 0; i < N(); ++i)
+        for (std::size_t l = 0; l < Simd::lanes(pivots_[i]); ++l)
+          swap(Simd::lane(l, x[i]), Simd::lane(l, x[Simd::lane(l, pivots_[i])]));
+
+      // L y = P b, with unit diagonal
+      for (size_type i = 0; i < N(); ++i)
+        for (size_type j = 0; j < i; ++j)
+          x[i] -= lu_[i][j]*x[j];
+
+      // U x = y
+      for (size_type i = N(); i > 0;)
+      {
+        --i;
+        for (size_type j = i+1; j < N(); ++j)
+          x[i] -= lu_[i][j]*x[j];
+        x[i] /= lu_[i][i];
+      }
+    }
+
+    /** \brief Solve A X = B for the columns of B
+     *
+     * The columns of X are the same as those computed by solving for each
+     * column of B separately.
+     *
+     * \exception FMatrixError if the matrix is singular in any lane
+     */
+    template<class M1, class M2>
+      requires Impl::IsDenseMatrix_v<M1>
+    void solve (M1& X, const M2& B) const
+    {
+      using std::swap;
+      checkNonsingular();
+      DUNE_ASSERT_BOUNDS(B.N() == N());
+      X = B;
+      const size_type m = B.M();
+
+      // P B, row by row so that X[p] stays in bounds, the pivots satisfy
+      // pivots_[i] >= i
+      for (size_type i = 0; i < N(); ++i)
+        for (size_type p = i+1; p < N(); ++p)
+          for (std::size_t l = 0; l < Simd::lanes(pivots_[i]); ++l)
+            if (std::size_t(Simd::lane(l, pivots_[i])) == p)
+              for (size_type k = 0; k < m; ++k)
+                swap(Simd::lane(l, X[i][k]), Simd::lane(l, X[p][k]));
+
+      for (size_type i = 0; i < N(); ++i)
+        for (size_type j = 0; j < i; ++j)
+          for (size_type k = 0; k < m; ++k)
+            X[i][k] -= lu_[i][j]*X[j][k];
+
+      for (size_type i = N(); i > 0;)
+      {
+        --i;
+        for (size_type j = i+1; j < N(); ++j)
+          for (size_type k = 0; k < m; ++k)
+            X[i][k] -= lu_[i][j]*X[j][k];
+        for (size_type k = 0; k < m; ++k)
+          X[i][k] /= lu_[i][i];
+      }
+    }
+
+    //! The determinant of the matrix, zero in singular lanes
+    field_type determinant () const
+    {
+      field_type det = sign_;
+      for (size_type i = 0; i < N(); ++i)
+        det *= lu_[i][i];
+      // the elimination continues in singular lanes and may leave NaNs on
+      // their diagonal
+      return Simd::cond(nonsingular_, det, field_type(0));
+    }
+
+    //! The lanes in which the matrix is nonsingular
+    const mask_type& nonsingularLanes () const
+    {
+      return nonsingular_;
+    }
+
+    /** \brief The factors L and U of P A = L U
+     *
+     * The strict lower triangle holds L, which has a unit diagonal, and the
+     * upper triangle holds U.
+     */
+    const matrix_type& factors () const
+    {
+      return lu_;
+    }
+
+    /** \brief The row swaps of the elimination
+     *
+     * In step i, row i was swapped with row pivots()[i] >= i.
+     */
+    const auto& pivots () const
+    {
+      return pivots_;
+    }
+
+    //! number of rows and columns of the matrix
+    size_type N () const
+    {
+      return lu_.N();
+    }
+
+  private:
+    // the functor of DenseMatrix::luDecomposition() storing the pivots and
+    // the sign of the permutation
+    struct PivotRecorder
+    {
+      void swap (std::size_t i, index_type j)
+      {
+        lu.pivots_[i] = j;
+        lu.sign_ *= Simd::cond(index_type(i) == j, field_type(1), field_type(-1));
+      }
+
+      void operator() (const field_type&, int, int)
+      {}
+
+      DenseLU& lu;
+    };
+
+    void checkNonsingular () const
+    {
+      if (!Simd::allTrue(nonsingular_))
+        DUNE_THROW(FMatrixError, "matrix is singular");
+    }
+
+    matrix_type lu_;
+    typename Impl::DenseLUPivots<matrix_type, index_type>::type pivots_;
+    field_type sign_ = field_type(1);
+    mask_type nonsingular_ = mask_type(true);
+  };
+
+  /** @} end documentation */
+
+} // end namespace Dune
+
+#endif // DUNE_COMMON_DENSELU_HH
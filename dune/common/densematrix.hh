@@ -29,6 +29,8 @@ namespace Dune
 
   template<typename M> class DenseMatrix;
 
+  template<typename M> class DenseLU;
+
   template<typename M>
   struct FieldTraits< DenseMatrix<M> >
   {
@@ -130,6 +132,78 @@ namespace Dune
   /** @brief Error thrown if operations of a FieldMatrix fail. */
   class FMatrixError : public MathError {};
 
+#ifndef DOXYGEN
+  namespace Impl
+  {
+    // The 2x2 minors s of the upper two rows and c of the lower two rows of a
+    // 4x4 matrix.  They give its determinant and adjugate in closed form,
+    // without the data dependent branches of the LU decomposition, so that
+    // the computation stays vectorized for Simd field types.
+    template<class K>
+    struct Minors4
+    {
+      template<class M>
+      constexpr explicit Minors4 (const M& a)
+        : s{a[0][0]*a[1][1] - a[1][0]*a[0][1],
+            a[0][0]*a[1][2] - a[1][0]*a[0][2],
+            a[0][0]*a[1][3] - a[1][0]*a[0][3],
+            a[0][1]*a[1][2] - a[1][1]*a[0][2],
+            a[0][1]*a[1][3] - a[1][1]*a[0][3],
+            a[0][2]*a[1][3] - a[1][2]*a[0][3]}
+        , c{a[2][0]*a[3][1] - a[3][0]*a[2][1],
+            a[2][0]*a[3][2] - a[3][0]*a[2][2],
+            a[2][0]*a[3][3] - a[3][0]*a[2][3],
+            a[2][1]*a[3][2] - a[3][1]*a[2][2],
+            a[2][1]*a[3][3] - a[3][1]*a[2][3],
+            a[2][2]*a[3][3] - a[3][2]*a[2][3]}
+      {}
+
+      constexpr K determinant () const
+      {
+        return s[0]*c[5] - s[1]*c[4] + s[2]*c[3] + s[3]*c[2] - s[4]*c[1] + s[5]*c[0];
+      }
+
+      // the adjugate of a scaled by factor, i.e. the inverse for factor = 1/det
+      template<class M, class Adj, class F>
+      constexpr void adjugate (const M& a, Adj& adj, const F& factor) const
+      {
+        adj[0][0] = ( a[1][1]*c[5] - a[1][2]*c[4] + a[1][3]*c[3]) * factor;
+        adj[0][1] = (-a[0][1]*c[5] + a[0][2]*c[4] - a[0][3]*c[3]) * factor;
+        adj[0][2] = ( a[3][1]*s[5] - a[3][2]*s[4] + a[3][3]*s[3]) * factor;
+        adj[0][3] = (-a[2][1]*s[5] + a[2][2]*s[4] - a[2][3]*s[3]) * factor;
+        adj[1][0] = (-a[1][0]*c[5] + a[1][2]*c[2] - a[1][3]*c[1]) * factor;
+        adj[1][1] = ( a[0][0]*c[5] - a[0][2]*c[2] + a[0][3]*c[1]) * factor;
+        adj[1][2] = (-a[3][0]*s[5] + a[3][2]*s[2] - a[3][3]*s[1]) * factor;
+        adj[1][3] = ( a[2][0]*s[5] - a[2][2]*s[2] + a[2][3]*s[1]) * factor;
+        adj[2][0] = ( a[1][0]*c[4] - a[1][1]*c[2] + a[1][3]*c[0]) * factor;
+        adj[2][1] = (-a[0][0]*c[4] + a[0][1]*c[2] - a[0][3]*c[0]) * factor;
+        adj[2][2] = ( a[3][0]*s[4] - a[3][1]*s[2] + a[3][3]*s[0]) * factor;
+        adj[2][3] = (-a[2][0]*s[4] + a[2][1]*s[2] - a[2][3]*s[0]) * factor;
+        adj[3][0] = (-a[1][0]*c[3] + a[1][1]*c[1] - a[1][2]*c[0]) * factor;
+        adj[3][1] = ( a[0][0]*c[3] - a[0][1]*c[1] + a[0][2]*c[0]) * factor;
+        adj[3][2] = (-a[3][0]*s[3] + a[3][1]*s[1] - a[3][2]*s[0]) * factor;
+        adj[3][3] = ( a[2][0]*s[3] - a[2][1]*s[1] + a[2][2]*s[0]) * factor;
+      }
+
+      K s[6];
+      K c[6];
+    };
+
+    // Whether a matrix of type M can have n rows, i.e. it either has n rows
+    // at compile time or its number of rows is only known at run time.  Used
+    // to instantiate the closed forms only for the sizes they are meant for.
+    template<class M>
+    constexpr bool mayHaveRows (std::size_t n)
+    {
+      if constexpr (requires { std::integral_constant<std::size_t, M::mat_rows()>{}; })
+        return M::mat_rows() == n;
+      else
+        return true;
+    }
+
+  } // namespace Impl
+#endif // DOXYGEN
+
   /**
       @brief A dense n x m matrix.
 
@@ -152,6 +226,10 @@ namespace Dune
     template <class>
     friend class DenseMatrix;
 
+    // uses luDecomposition()
+    template <class>
+    friend class DenseLU;
+
   public:
     //===== type definitions and constants
 
@@ -943,6 +1021,33 @@ namespace Dune
     if (rows()!=cols())
       DUNE_THROW(FMatrixError, "Can't solve for a " << rows() << "x" << cols() << " matrix!");
 
+    if constexpr (Impl::mayHaveRows<MAT>(4)) {
+      if (rows()==4) {
+
+        Impl::Minors4<field_type> minors(*this);
+        field_type d = minors.determinant();
+        // as the LU decomposition of larger matrices, throw for exactly
+        // singular matrices
+        if (Simd::anyTrue(fvmeta::absreal(d) == real_type(0)))
+          DUNE_THROW(FMatrixError,"matrix is singular");
+#ifdef DUNE_FMatrix_WITH_CHECKING
+        if (Simd::anyTrue(fvmeta::absreal(d)
+                          < FMatrixPrecision<>::absolute_limit()))
+          DUNE_THROW(FMatrixError,"matrix is singular");
+#endif
+
+        field_type adj[4][4];
+        minors.adjugate(*this, adj, field_type(1));
+        // b may have a wider field type and may alias x
+        field_type rhs[4];
+        for (size_type i=0; i<4; i++)
+          rhs[i] = static_cast<field_type>(b[i]);
+        for (size_type i=0; i<4; i++)
+          x[i] = (adj[i][0]*rhs[0] + adj[i][1]*rhs[1] + adj[i][2]*rhs[2] + adj[i][3]*rhs[3]) / d;
+        return;
+      }
+    }
+
     if (rows()==1) {
 
 #ifdef DUNE_FMatrix_WITH_CHECKING
@@ -1019,6 +1124,26 @@ namespace Dune
     if (rows()!=cols())
       DUNE_THROW(FMatrixError, "Can't invert a " << rows() << "x" << cols() << " matrix!");
 
+    if constexpr (Impl::mayHaveRows<MAT>(4)) {
+      if (rows()==4) {
+        Impl::Minors4<field_type> minors(*this);
+        field_type det = minors.determinant();
+        // as the LU decomposition of larger matrices, throw for exactly
+        // singular matrices
+        if (Simd::anyTrue(fvmeta::absreal(det) == real_type(0)))
+          DUNE_THROW(FMatrixError,"matrix is singular");
+#ifdef DUNE_FMatrix_WITH_CHECKING
+        if (Simd::anyTrue(fvmeta::absreal(det)
+                          < FMatrixPrecision<>::absolute_limit()))
+          DUNE_THROW(FMatrixError,"matrix is singular");
+#endif
+
+        AutonomousValue<MAT> A(asImp());
+        minors.adjugate(A, *this, field_type(real_type(1)/det));
+        return;
+      }
+    }
+
     if (rows()==1) {
 
 #ifdef DUNE_FMatrix_WITH_CHECKING
@@ -1152,17 +1277,22 @@ namespace Dune
 
     }
 
+    if constexpr (Impl::mayHaveRows<MAT>(4))
+      if (rows()==4)
+        return Impl::Minors4<field_type>(*this).determinant();
+
     AutonomousValue<MAT> A(asImp());
     field_type det;
     Simd::Mask<typename FieldTraits<value_type>::real_type>
       nonsingularLanes(true);
 
     AutonomousValue<MAT>::luDecomposition(A, ElimDet(det), nonsingularLanes, false, doPivoting);
-    det = Simd::cond(nonsingularLanes, det, field_type(0));
 
     for (size_type i = 0; i < rows(); ++i)
       det *= A[i][i];
-    return det;
+    // in the simd case, the elimination continued in singular lanes and may
+    // have left NaNs on their diagonal
+    return Simd::cond(nonsingularLanes, det, field_type(0));
   }
 
 #endif // DOXYGEN
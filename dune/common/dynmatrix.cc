@@ -0,0 +1,209 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <algorithm>
+#include <complex>
+#include <type_traits>
+#include <vector>
+
+#include <dune-common-config.hh>  // HAVE_BLAS, HAVE_LAPACK, LAPACK_NEEDS_UNDERLINE
+
+#include <dune/common/dynmatrix.hh>
+
+#if HAVE_BLAS || HAVE_LAPACK
+
+// BLAS and LAPACK use the same name mangling. Without LAPACK the check for
+// the mangling is not done and the common trailing underscore is assumed.
+#if defined(LAPACK_NEEDS_UNDERLINE) || !HAVE_LAPACK
+  #define LAPACK_MANGLE(name,NAME) name##_
+#else
+  #define LAPACK_MANGLE(name,NAME) name
+#endif
+
+#define FC_FUNC LAPACK_MANGLE
+
+extern "C" {
+
+#if HAVE_BLAS
+  // dot product x^T y of real vectors (in libblas)
+  extern float FC_FUNC(sdot, SDOT)(const int* n, const float* x, const int* incx,
+                                   const float* y, const int* incy);
+  extern double FC_FUNC(ddot, DDOT)(const int* n, const double* x, const int* incx,
+                                    const double* y, const int* incy);
+
+  // vector update y = alpha x + y (in libblas)
+#define DUNE_DECLARE_AXPY(name, NAME, T)                                       \
+  extern void FC_FUNC(name, NAME)(const int* n, const T* alpha, const T* x,    \
+                                  const int* incx, T* y, const int* incy);
+
+  DUNE_DECLARE_AXPY(saxpy, SAXPY, float)
+  DUNE_DECLARE_AXPY(daxpy, DAXPY, double)
+  DUNE_DECLARE_AXPY(caxpy, CAXPY, std::complex<float>)
+  DUNE_DECLARE_AXPY(zaxpy, ZAXPY, std::complex<double>)
+#undef DUNE_DECLARE_AXPY
+
+  // matrix-matrix product C = alpha op(A) op(B) + beta C (in libblas)
+#define DUNE_DECLARE_GEMM(name, NAME, T)                                       \
+  extern void FC_FUNC(name, NAME)(const char* transa, const char* transb,      \
+                                  const int* m, const int* n, const int* k,    \
+                                  const T* alpha, const T* a, const int* lda,  \
+                                  const T* b, const int* ldb, const T* beta,   \
+                                  T* c, const int* ldc);
+
+  DUNE_DECLARE_GEMM(sgemm, SGEMM, float)
+  DUNE_DECLARE_GEMM(dgemm, DGEMM, double)
+  DUNE_DECLARE_GEMM(cgemm, CGEMM, std::complex<float>)
+  DUNE_DECLARE_GEMM(zgemm, ZGEMM, std::complex<double>)
+#undef DUNE_DECLARE_GEMM
+#endif // HAVE_BLAS
+
+#if HAVE_LAPACK
+  // LU factorization with partial pivoting, solve and inverse (in liblapack)
+#define DUNE_DECLARE_GETRX(prefix, PREFIX, T)                                  \
+  extern void FC_FUNC(prefix##getrf, PREFIX##GETRF)(const int* m, const int* n, \
+                                                    T* a, const int* lda,      \
+                                                    int* ipiv, int* info);     \
+  extern void FC_FUNC(prefix##getrs, PREFIX##GETRS)(const char* trans, const int* n, \
+                                                    const int* nrhs, const T* a, \
+                                                    const int* lda, const int* ipiv, \
+                                                    T* b, const int* ldb, int* info); \
+  extern void FC_FUNC(prefix##getri, PREFIX##GETRI)(const int* n, T* a, const int* lda, \
+                                                    const int* ipiv, T* work,  \
+                                                    const int* lwork, int* info);
+
+  DUNE_DECLARE_GETRX(s, S, float)
+  DUNE_DECLARE_GETRX(d, D, double)
+  DUNE_DECLARE_GETRX(c, C, std::complex<float>)
+  DUNE_DECLARE_GETRX(z, Z, std::complex<double>)
+#undef DUNE_DECLARE_GETRX
+#endif // HAVE_LAPACK
+
+} // end extern C
+
+namespace Dune {
+
+  namespace DynamicMatrixHelp {
+
+#if HAVE_BLAS
+    float dot (int n, const float* x, const float* y)
+    {
+      const int inc = 1;
+      return FC_FUNC(sdot, SDOT)(&n, x, &inc, y, &inc);
+    }
+
+    double dot (int n, const double* x, const double* y)
+    {
+      const int inc = 1;
+      return FC_FUNC(ddot, DDOT)(&n, x, &inc, y, &inc);
+    }
+
+    template<class K>
+    void axpy (int n, K alpha, const K* x, K* y)
+    {
+      const int inc = 1;
+      if constexpr (std::is_same_v<K, float>)
+        FC_FUNC(saxpy, SAXPY)(&n, &alpha, x, &inc, y, &inc);
+      else if constexpr (std::is_same_v<K, double>)
+        FC_FUNC(daxpy, DAXPY)(&n, &alpha, x, &inc, y, &inc);
+      else if constexpr (std::is_same_v<K, std::complex<float>>)
+        FC_FUNC(caxpy, CAXPY)(&n, &alpha, x, &inc, y, &inc);
+      else
+        FC_FUNC(zaxpy, ZAXPY)(&n, &alpha, x, &inc, y, &inc);
+    }
+
+    template<class K>
+    void gemm (char transa, char transb, int m, int n, int k, K alpha,
+               const K* a, int lda, const K* b, int ldb, K beta, K* c, int ldc)
+    {
+      if constexpr (std::is_same_v<K, float>)
+        FC_FUNC(sgemm, SGEMM)(&transa, &transb, &m, &n, &k, &alpha, a, &lda, b, &ldb, &beta, c, &ldc);
+      else if constexpr (std::is_same_v<K, double>)
+        FC_FUNC(dgemm, DGEMM)(&transa, &transb, &m, &n, &k, &alpha, a, &lda, b, &ldb, &beta, c, &ldc);
+      else if constexpr (std::is_same_v<K, std::complex<float>>)
+        FC_FUNC(cgemm, CGEMM)(&transa, &transb, &m, &n, &k, &alpha, a, &lda, b, &ldb, &beta, c, &ldc);
+      else
+        FC_FUNC(zgemm, ZGEMM)(&transa, &transb, &m, &n, &k, &alpha, a, &lda, b, &ldb, &beta, c, &ldc);
+    }
+#endif // HAVE_BLAS
+
+#if HAVE_LAPACK
+    template<class K>
+    void getrf (int n, K* a, int* ipiv, int* info)
+    {
+      if constexpr (std::is_same_v<K, float>)
+        FC_FUNC(sgetrf, SGETRF)(&n, &n, a, &n, ipiv, info);
+      else if constexpr (std::is_same_v<K, double>)
+        FC_FUNC(dgetrf, DGETRF)(&n, &n, a, &n, ipiv, info);
+      else if constexpr (std::is_same_v<K, std::complex<float>>)
+        FC_FUNC(cgetrf, CGETRF)(&n, &n, a, &n, ipiv, info);
+      else
+        FC_FUNC(zgetrf, ZGETRF)(&n, &n, a, &n, ipiv, info);
+    }
+
+    template<class K>
+    void getrs (char trans, int n, int nrhs, const K* a, const int* ipiv, K* b, int* info)
+    {
+      if constexpr (std::is_same_v<K, float>)
+        FC_FUNC(sgetrs, SGETRS)(&trans, &n, &nrhs, a, &n, ipiv, b, &n, info);
+      else if constexpr (std::is_same_v<K, double>)
+        FC_FUNC(dgetrs, DGETRS)(&trans, &n, &nrhs, a, &n, ipiv, b, &n, info);
+      else if constexpr (std::is_same_v<K, std::complex<float>>)
+        FC_FUNC(cgetrs, CGETRS)(&trans, &n, &nrhs, a, &n, ipiv, b, &n, info);
+      else
+        FC_FUNC(zgetrs, ZGETRS)(&trans, &n, &nrhs, a, &n, ipiv, b, &n, info);
+    }
+
+    template<class K>
+    void getri (int n, K* a, const int* ipiv, int* info)
+    {
+      auto call = [&](K* work, int lwork) {
+        if constexpr (std::is_same_v<K, float>)
+          FC_FUNC(sgetri, SGETRI)(&n, a, &n, ipiv, work, &lwork, info);
+        else if constexpr (std::is_same_v<K, double>)
+          FC_FUNC(dgetri, DGETRI)(&n, a, &n, ipiv, work, &lwork, info);
+        else if constexpr (std::is_same_v<K, std::complex<float>>)
+          FC_FUNC(cgetri, CGETRI)(&n, a, &n, ipiv, work, &lwork, info);
+        else
+          FC_FUNC(zgetri, ZGETRI)(&n, a, &n, ipiv, work, &lwork, info);
+      };
+
+      // workspace query
+      K size;
+      call(&size, -1);
+      if (*info != 0)
+        return;
+      std::vector<K> work(std::max(n, int(std::real(size))));
+      call(work.data(), work.size());
+    }
+#endif // HAVE_LAPACK
+
+#define DUNE_INSTANTIATE_BLAS(K)                                               \
+    template void axpy<K> (int, K, const K*, K*);                              \
+    template void gemm<K> (char, char, int, int, int, K, const K*, int,         \
+                           const K*, int, K, K*, int);
+#define DUNE_INSTANTIATE_LAPACK(K)                                             \
+    template void getrf<K> (int, K*, int*, int*);                              \
+    template void getrs<K> (char, int, int, const K*, const int*, K*, int*);   \
+    template void getri<K> (int, K*, const int*, int*);
+
+#if HAVE_BLAS
+    DUNE_INSTANTIATE_BLAS(float)
+    DUNE_INSTANTIATE_BLAS(double)
+    DUNE_INSTANTIATE_BLAS(std::complex<float>)
+    DUNE_INSTANTIATE_BLAS(std::complex<double>)
+#endif
+#if HAVE_LAPACK
+    DUNE_INSTANTIATE_LAPACK(float)
+    DUNE_INSTANTIATE_LAPACK(double)
+    DUNE_INSTANTIATE_LAPACK(std::complex<float>)
+    DUNE_INSTANTIATE_LAPACK(std::complex<double>)
+#endif
+#undef DUNE_INSTANTIATE_BLAS
+#undef DUNE_INSTANTIATE_LAPACK
+
+  } // end namespace DynamicMatrixHelp
+
+} // end namespace Dune
+
+#endif // HAVE_BLAS || HAVE_LAPACK
@@ -5,10 +5,16 @@
 #ifndef DUNE_DYNMATRIX_HH
 #define DUNE_DYNMATRIX_HH
 
+#include <algorithm>
 #include <cmath>
+#include <complex>
 #include <cstddef>
 #include <iostream>
 #include <initializer_list>
+#include <type_traits>
+#include <vector>
+
+#include <dune-common-config.hh> // HAVE_BLAS, HAVE_LAPACK
 
 #include <dune/common/boundschecking.hh>
 #include <dune/common/exceptions.hh>
@@ -28,8 +34,54 @@ namespace Dune
    *  \brief This file implements a dense matrix with dynamic numbers of rows and columns.
    */
 
+  /** \brief Size from which on DynamicMatrix forwards operations to BLAS and LAPACK
+   *
+   * The matrix-vector products use BLAS for matrices with at least this many
+   * columns.  Matrix products, solve(), invert() and determinant() use BLAS
+   * and LAPACK if both dimensions are at least this large.
+   */
+#ifndef DUNE_DYNAMICMATRIX_BLAS_THRESHOLD
+#define DUNE_DYNAMICMATRIX_BLAS_THRESHOLD 64
+#endif
+
   template< class K > class DynamicMatrix;
 
+  namespace DynamicMatrixHelp {
+
+    //! whether DynamicMatrix<K> can forward operations to BLAS and LAPACK
+    template<class K>
+    constexpr bool isBlasType = std::is_same_v<K, float> || std::is_same_v<K, double>
+      || std::is_same_v<K, std::complex<float>> || std::is_same_v<K, std::complex<double>>;
+
+    // defined in dynmatrix.cc for the types of isBlasType, the matrices are
+    // stored column-major as expected by BLAS and LAPACK. The complex dot
+    // product is left out, as its return convention differs between BLAS
+    // implementations.
+#if HAVE_BLAS
+    float dot (int n, const float* x, const float* y);
+    double dot (int n, const double* x, const double* y);
+
+    template<class K>
+    void axpy (int n, K alpha, const K* x, K* y);
+
+    template<class K>
+    void gemm (char transa, char transb, int m, int n, int k, K alpha,
+               const K* a, int lda, const K* b, int ldb, K beta, K* c, int ldc);
+#endif
+
+#if HAVE_LAPACK
+    template<class K>
+    void getrf (int n, K* a, int* ipiv, int* info);
+
+    template<class K>
+    void getrs (char trans, int n, int nrhs, const K* a, const int* ipiv, K* b, int* info);
+
+    template<class K>
+    void getri (int n, K* a, const int* ipiv, int* info);
+#endif
+
+  } // end namespace DynamicMatrixHelp
+
   template< class K >
   struct DenseMatVecTraits< DynamicMatrix<K> >
   {
@@ -53,6 +105,14 @@ namespace Dune
   };
 
   /** \brief Construct a matrix with a dynamic size.
+   *
+   * For float, double and their complex counterparts, the matrix-vector
+   * products (for complex matrices only mtv() and umtv()), the matrix
+   * products, solve(), invert() and determinant() are forwarded to BLAS and
+   * LAPACK if available and if the matrix is at least of size
+   * DUNE_DYNAMICMATRIX_BLAS_THRESHOLD.  Smaller matrices, other field types
+   * and the variants without pivoting use the generic implementation of
+   * DenseMatrix.
    *
    * \tparam K is the field type (use float, double, complex, etc)
    */
@@ -138,6 +198,201 @@ namespace Dune
       return AT;
     }
 
+    //===== linear maps and solvers, forwarded to BLAS and LAPACK for large matrices
+
+    //! y = A x
+    template<class X, class Y>
+    void mv (const X& x, Y& y) const
+    {
+#if HAVE_BLAS
+      if constexpr (isBlasVector<X,Y> && std::is_floating_point_v<K>)
+        if (blasRows()) {
+          DUNE_ASSERT_BOUNDS((void*)(&x) != (void*)(&y));
+          DUNE_ASSERT_BOUNDS(x.N() == this->M());
+          DUNE_ASSERT_BOUNDS(y.N() == this->N());
+          blasMv(x.data(), y.data(), false);
+          return;
+        }
+#endif
+      Base::mv(x, y);
+    }
+
+    //! y = A^T x
+    template<class X, class Y>
+    void mtv (const X& x, Y& y) const
+    {
+#if HAVE_BLAS
+      if constexpr (isBlasVector<X,Y>)
+        if (blasRows()) {
+          DUNE_ASSERT_BOUNDS((void*)(&x) != (void*)(&y));
+          DUNE_ASSERT_BOUNDS(x.N() == this->N());
+          DUNE_ASSERT_BOUNDS(y.N() == this->M());
+          blasMtv(x.data(), y.data(), false);
+          return;
+        }
+#endif
+      Base::mtv(x, y);
+    }
+
+    //! y += A x
+    template<class X, class Y>
+    void umv (const X& x, Y& y) const
+    {
+#if HAVE_BLAS
+      if constexpr (isBlasVector<X,Y> && std::is_floating_point_v<K>)
+        if (blasRows()) {
+          DUNE_ASSERT_BOUNDS(x.N() == this->M());
+          DUNE_ASSERT_BOUNDS(y.N() == this->N());
+          blasMv(x.data(), y.data(), true);
+          return;
+        }
+#endif
+      Base::umv(x, y);
+    }
+
+    //! y += A^T x
+    template<class X, class Y>
+    void umtv (const X& x, Y& y) const
+    {
+#if HAVE_BLAS
+      if constexpr (isBlasVector<X,Y>)
+        if (blasRows()) {
+          DUNE_ASSERT_BOUNDS(x.N() == this->N());
+          DUNE_ASSERT_BOUNDS(y.N() == this->M());
+          blasMtv(x.data(), y.data(), true);
+          return;
+        }
+#endif
+      Base::umtv(x, y);
+    }
+
+    //! Multiplies M from the left to this matrix
+    template<typename M2>
+    DynamicMatrix& leftmultiply (const DenseMatrix<M2>& M)
+    {
+#if HAVE_BLAS
+      if constexpr (std::is_same_v<M2, DynamicMatrix> && DynamicMatrixHelp::isBlasType<K>)
+        if (blasMatrix()) {
+          DUNE_ASSERT_BOUNDS(M.rows() == M.cols());
+          DUNE_ASSERT_BOUNDS(M.rows() == this->rows());
+          const int n = this->N(), m = this->M();
+          // In the column-major view of BLAS, the row-major entries are the
+          // transposed matrices, and (M A)^T = A^T M^T.
+          const std::vector<K> a = packed(), b = static_cast<const DynamicMatrix&>(M).packed();
+          std::vector<K> c(a.size());
+          DynamicMatrixHelp::gemm('N', 'N', m, n, n, K(1), a.data(), m, b.data(), n,
+                                  K(0), c.data(), m);
+          unpack(c);
+          return *this;
+        }
+#endif
+      return Base::leftmultiply(M);
+    }
+
+    //! Multiplies M from the right to this matrix
+    template<typename M2>
+    DynamicMatrix& rightmultiply (const DenseMatrix<M2>& M)
+    {
+#if HAVE_BLAS
+      if constexpr (std::is_same_v<M2, DynamicMatrix> && DynamicMatrixHelp::isBlasType<K>)
+        if (blasMatrix()) {
+          DUNE_ASSERT_BOUNDS(M.rows() == M.cols());
+          DUNE_ASSERT_BOUNDS(M.cols() == this->cols());
+          const int n = this->N(), m = this->M();
+          // (A M)^T = M^T A^T, see leftmultiply()
+          const std::vector<K> a = packed(), b = static_cast<const DynamicMatrix&>(M).packed();
+          std::vector<K> c(a.size());
+          DynamicMatrixHelp::gemm('N', 'N', m, n, m, K(1), b.data(), m, a.data(), m,
+                                  K(0), c.data(), m);
+          unpack(c);
+          return *this;
+        }
+#endif
+      return Base::rightmultiply(M);
+    }
+
+    /** \brief Solve system A x = b
+     *
+     * \exception FMatrixError if the matrix is singular
+     */
+    template <class V1, class V2>
+    void solve (V1& x, const V2& b, bool doPivoting = true) const
+    {
+#if HAVE_LAPACK
+      if constexpr (isBlasVector<V1,V2>)
+        if (doPivoting && blasMatrix() && this->N() == this->M()) {
+          DUNE_ASSERT_BOUNDS(x.N() == this->N());
+          DUNE_ASSERT_BOUNDS(b.N() == this->N());
+          const int n = this->N();
+          std::vector<K> a = packed();
+          std::vector<int> pivots(n);
+          int info = 0;
+          // a is the LU factorization of A^T, solve with its transpose
+          DynamicMatrixHelp::getrf(n, a.data(), pivots.data(), &info);
+          if (info > 0)
+            DUNE_THROW(FMatrixError, "matrix is singular");
+          checkLapackInfo(info, "getrf");
+          x = b;
+          DynamicMatrixHelp::getrs('T', n, 1, a.data(), pivots.data(), x.data(), &info);
+          checkLapackInfo(info, "getrs");
+          return;
+        }
+#endif
+      Base::solve(x, b, doPivoting);
+    }
+
+    /** \brief Compute inverse
+     *
+     * \exception FMatrixError if the matrix is singular
+     */
+    void invert (bool doPivoting = true)
+    {
+#if HAVE_LAPACK
+      if constexpr (DynamicMatrixHelp::isBlasType<K>)
+        if (doPivoting && blasMatrix() && this->N() == this->M()) {
+          const int n = this->N();
+          std::vector<K> a = packed();
+          std::vector<int> pivots(n);
+          int info = 0;
+          // the inverse of A^T is the transposed inverse of A
+          DynamicMatrixHelp::getrf(n, a.data(), pivots.data(), &info);
+          if (info > 0)
+            DUNE_THROW(FMatrixError, "matrix is singular");
+          checkLapackInfo(info, "getrf");
+          DynamicMatrixHelp::getri(n, a.data(), pivots.data(), &info);
+          checkLapackInfo(info, "getri");
+          unpack(a);
+          return;
+        }
+#endif
+      Base::invert(doPivoting);
+    }
+
+    //! calculates the determinant of this matrix
+    typename Base::field_type determinant (bool doPivoting = true) const
+    {
+#if HAVE_LAPACK
+      if constexpr (DynamicMatrixHelp::isBlasType<K>)
+        if (doPivoting && blasMatrix() && this->N() == this->M()) {
+          const int n = this->N();
+          std::vector<K> a = packed();
+          std::vector<int> pivots(n);
+          int info = 0;
+          DynamicMatrixHelp::getrf(n, a.data(), pivots.data(), &info);
+          if (info > 0)
+            return K(0);
+          checkLapackInfo(info, "getrf");
+          // det(A) = det(A^T) is the product of the diagonal of U, with the
+          // sign of the row interchanges (pivots are 1-based)
+          K det(1);
+          for (int i = 0; i < n; ++i)
+            det *= (pivots[i] != i+1 ? -a[i*(n+1)] : a[i*(n+1)]);
+          return det;
+        }
+#endif
+      return Base::determinant(doPivoting);
+    }
+
     // make this thing a matrix
     size_type mat_rows() const { return _data.size(); }
     size_type mat_cols() const {
@@ -152,6 +407,74 @@ namespace Dune
       DUNE_ASSERT_BOUNDS(i < _data.size());
       return _data[i];
     }
+
+  private:
+    // whether the vector types X and Y can be passed to BLAS
+    template<class X, class Y>
+    static constexpr bool isBlasVector = DynamicMatrixHelp::isBlasType<K>
+      && std::is_same_v<X, DynamicVector<K>> && std::is_same_v<Y, DynamicVector<K>>;
+
+    // whether the rows are long enough to use BLAS in matrix-vector products
+    bool blasRows () const
+    {
+      return this->N() > 0 && this->M() >= DUNE_DYNAMICMATRIX_BLAS_THRESHOLD;
+    }
+
+    // whether the matrix is large enough to use BLAS and LAPACK
+    bool blasMatrix () const
+    {
+      return this->N() >= DUNE_DYNAMICMATRIX_BLAS_THRESHOLD
+        && this->M() >= DUNE_DYNAMICMATRIX_BLAS_THRESHOLD;
+    }
+
+#if HAVE_BLAS
+    // y = A x, or y += A x if add is set. The rows are not contiguous and
+    // are passed to BLAS one by one.
+    void blasMv (const K* x, K* y, bool add) const
+    {
+      const int m = this->M();
+      for (size_type i = 0; i < _data.size(); ++i)
+        y[i] = (add ? y[i] : K(0)) + DynamicMatrixHelp::dot(m, _data[i].data(), x);
+    }
+
+    // y = A^T x, or y += A^T x if add is set, accumulating the rows scaled by x
+    void blasMtv (const K* x, K* y, bool add) const
+    {
+      const int m = this->M();
+      if (!add)
+        std::fill(y, y + m, K(0));
+      for (size_type i = 0; i < _data.size(); ++i)
+        DynamicMatrixHelp::axpy(m, x[i], _data[i].data(), y);
+    }
+#endif
+
+    // throws if a LAPACK routine failed for another reason than singularity
+    static void checkLapackInfo (int info, const char* routine)
+    {
+      if (info != 0)
+        DUNE_THROW(FMatrixError, "LAPACK " << routine << " failed with info = " << info);
+    }
+
+    // the entries in row-major order, which BLAS and LAPACK read as the
+    // transposed matrix
+    std::vector<K> packed () const
+    {
+      std::vector<K> a;
+      a.reserve(this->N() * this->M());
+      for (const auto& row : _data)
+        a.insert(a.end(), row.data(), row.data() + row.size());
+      return a;
+    }
+
+    // copies the row-major entries a to the matrix
+    void unpack (const std::vector<K>& a)
+    {
+      const K* entry = a.data();
+      for (auto& row : _data) {
+        std::copy(entry, entry + row.size(), row.data());
+        entry += row.size();
+      }
+    }
   };
 
   /** @} end documentation */
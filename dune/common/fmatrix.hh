@@ -16,6 +16,7 @@
 #include <dune/common/exceptions.hh>
 #include <dune/common/fvector.hh>
 #include <dune/common/densematrix.hh>
+#include <dune/common/hybridutilities.hh>
 #include <dune/common/precision.hh>
 #include <dune/common/promotiontraits.hh>
 #include <dune/common/typetraits.hh>
@@ -81,6 +82,81 @@ namespace Dune
 
   template< class K, int ROWS, int COLS = ROWS > class FieldMatrix;
 
+  namespace Impl
+  {
+
+    // C[i0+r][j0+l] = (A B)[i0+r][j0+l] for r < R and l < W.  The products
+    // for all k are unrolled, so that the RxW accumulators stay in registers
+    // and are vectorized along the columns.
+    template<int R, int W, class KC, int n, int m, int p, class KA, class KB>
+    void multiplyTile (const FieldMatrix<KA,n,m>& A, const FieldMatrix<KB,m,p>& B,
+                       FieldMatrix<KC,n,p>& C, int i0, int j0)
+    {
+      KC acc[R][W] = {};
+      Hybrid::forEach(Dune::range(std::integral_constant<int,m>()), [&](auto k) {
+        Hybrid::forEach(Dune::range(std::integral_constant<int,R>()), [&](auto r) {
+          const KA a = A[i0+r][k];
+          for (int l = 0; l < W; ++l)
+            acc[r][l] += a * B[k][j0+l];
+        });
+      });
+      for (int r = 0; r < R; ++r)
+        for (int l = 0; l < W; ++l)
+          C[i0+r][j0+l] = acc[r][l];
+    }
+
+    // rows i0,...,i0+R-1 of C = A B, in tiles of W columns
+    template<int R, int W, class KC, int n, int m, int p, class KA, class KB>
+    void multiplyRowBlock (const FieldMatrix<KA,n,m>& A, const FieldMatrix<KB,m,p>& B,
+                           FieldMatrix<KC,n,p>& C, int i0)
+    {
+      int j = 0;
+      for (; j + W <= p; j += W)
+        multiplyTile<R,W>(A, B, C, i0, j);
+      if constexpr (p % W != 0)
+        multiplyTile<R,p%W>(A, B, C, i0, j);
+    }
+
+    /**
+     * \brief C = A B for FieldMatrix, where C is neither A nor B
+     *
+     * Compilers vectorize the plain triple loop well as long as a row of B
+     * fits into a few vector registers.  For arithmetic field types and more
+     * than 16 columns, C is therefore computed in register tiles of 4 rows
+     * and 64 bytes of columns, as long as the unrolled inner dimension is at
+     * most 32.  Each entry is summed in the same order in both cases.
+     */
+    template<class KC, int n, int m, int p, class KA, class KB>
+    constexpr void multiplyFieldMatrices (const FieldMatrix<KA,n,m>& A,
+                                          const FieldMatrix<KB,m,p>& B,
+                                          FieldMatrix<KC,n,p>& C)
+    {
+      if constexpr (std::is_arithmetic_v<KA> && std::is_arithmetic_v<KB>
+                    && std::is_arithmetic_v<KC> && p > 16 && m <= 32)
+      {
+        if (!std::is_constant_evaluated())
+        {
+          constexpr int R = 4;
+          constexpr int W = std::max<int>(1, 64 / sizeof(KC));
+          int i = 0;
+          for (; i + R <= n; i += R)
+            multiplyRowBlock<R,W>(A, B, C, i);
+          for (; i < n; ++i)
+            multiplyRowBlock<1,W>(A, B, C, i);
+          return;
+        }
+      }
+      for (int i = 0; i < n; ++i)
+        for (int j = 0; j < p; ++j)
+        {
+          C[i][j] = 0;
+          for (int k = 0; k < m; ++k)
+            C[i][j] += A[i][k] * B[k][j];
+        }
+    }
+
+  } // end namespace Impl
+
 
   template< class K, int ROWS, int COLS >
   struct DenseMatVecTraits< FieldMatrix<K,ROWS,COLS> >
@@ -412,15 +488,7 @@ namespace Dune
                                      const FieldMatrix<OtherK, COLS, otherCols>& matrixB)
     {
       FieldMatrix<typename PromotionTraits<K,OtherK>::PromotedType,ROWS,otherCols> result;
-
-      for (size_type i = 0; i < matrixA.mat_rows(); ++i)
-        for (size_type j = 0; j < matrixB.mat_cols(); ++j)
-        {
-          result[i][j] = 0;
-          for (size_type k = 0; k < matrixA.mat_cols(); ++k)
-            result[i][j] += matrixA[i][k] * matrixB[k][j];
-        }
-
+      Impl::multiplyFieldMatrices(matrixA, matrixB, result);
       return result;
     }
 
@@ -471,6 +539,21 @@ namespace Dune
       return M * (*this);
     }
 
+    using Base::leftmultiply;
+
+    //! Multiplies M from the left to this matrix
+    template <int r, int c>
+      requires (r == c && r == ROWS)
+    constexpr FieldMatrix& leftmultiply (const FieldMatrix<K,r,c>& M)
+    {
+      if constexpr (ROWS == COLS)
+        if (static_cast<const void*>(&M) == this)
+          return *this = M * M;
+      const FieldMatrix<K,rows,cols> C(*this);
+      Impl::multiplyFieldMatrices(M, C, *this);
+      return *this;
+    }
+
     using Base::rightmultiply;
 
     //! Multiplies M from the right to this matrix
@@ -479,14 +562,11 @@ namespace Dune
     {
       static_assert(r == c, "Cannot rightmultiply with non-square matrix");
       static_assert(r == cols, "Size mismatch");
-      FieldMatrix<K,rows,cols> C(*this);
-
-      for (size_type i=0; i<rows; i++)
-        for (size_type j=0; j<cols; j++) {
-          (*this)[i][j] = 0;
-          for (size_type k=0; k<cols; k++)
-            (*this)[i][j] += C[i][k]*M[k][j];
-        }
+      if constexpr (ROWS == COLS)
+        if (static_cast<const void*>(&M) == this)
+          return *this = M * M;
+      const FieldMatrix<K,rows,cols> C(*this);
+      Impl::multiplyFieldMatrices(C, M, *this);
       return *this;
     }
 
@@ -726,6 +806,33 @@ namespace Dune
       return det;
     }
 
+    //! invert 4x4 Matrix without changing the original matrix
+    template <typename K>
+    static constexpr K invertMatrix (const FieldMatrix<K,4,4> &matrix, FieldMatrix<K,4,4> &inverse)
+    {
+      using real_type = typename FieldTraits<K>::real_type;
+      Impl::Minors4<K> minors(matrix);
+      K det = minors.determinant();
+      minors.adjugate(matrix, inverse, K(real_type(1.0)/det));
+      return det;
+    }
+
+    //! invert 4x4 Matrix without changing the original matrix
+    //! return transposed matrix
+    template <typename K>
+    static constexpr K invertMatrix_retTransposed (const FieldMatrix<K,4,4> &matrix, FieldMatrix<K,4,4> &inverse)
+    {
+      K det = invertMatrix(matrix, inverse);
+      for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < i; ++j)
+        {
+          K t = inverse[i][j];
+          inverse[i][j] = inverse[j][i];
+          inverse[j][i] = t;
+        }
+      return det;
+    }
+
     //! calculates ret = A * B
     template< class K, int m, int n, int p >
     static constexpr void multMatrix ( const FieldMatrix< K, m, n > &A,
@@ -0,0 +1,281 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_FMATRIXBATCH_HH
+#define DUNE_COMMON_FMATRIXBATCH_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include <dune/common/boundschecking.hh>
+#include <dune/common/densecholesky.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/simd/loop.hh>
+#include <dune/common/simd/simd.hh>
+
+/** \file
+ * \brief Operations on batches of small dense matrices
+ */
+
+namespace Dune
+{
+
+  /** @addtogroup DenseMatVec
+      @{
+   */
+
+  /**
+   * \brief A batch of matrices of the same static size.
+   *
+   * Element assembly typically applies the same operation to many
+   * independent small matrices.  A FieldMatrixBatch stores the matrices
+   * of the batch as struct-of-arrays: blocks of \p lanes matrices are kept
+   * in a FieldMatrix<LoopSIMD<K,lanes>,ROWS,COLS>, so that entry (i,j) of
+   * all matrices of a block is contiguous.  The operations run the usual
+   * DenseMatrix algorithms on these blocks and thus work on all lanes of a
+   * block at once.  They compute the same results as the corresponding
+   * operations of each FieldMatrix.
+   *
+   * The vectors passed to the operations are given as spans of FieldVector
+   * with one entry per matrix of the batch.
+   *
+   * \tparam K     the field type of the matrices
+   * \tparam ROWS  number of rows
+   * \tparam COLS  number of columns
+   * \tparam lanes number of matrices processed together
+   */
+  template<class K, int ROWS, int COLS, std::size_t lanes = 8>
+  class FieldMatrixBatch
+  {
+  public:
+    //! the type of the matrices of the batch
+    using matrix_type = FieldMatrix<K,ROWS,COLS>;
+
+    //! the Simd type storing one entry of all matrices of a block
+    using simd_type = LoopSIMD<K,lanes>;
+
+    //! the type of a block of matrices
+    using block_type = FieldMatrix<simd_type,ROWS,COLS>;
+
+    //! the type used for sizes
+    using size_type = std::size_t;
+
+    //! Constructs an empty batch
+    FieldMatrixBatch() = default;
+
+    //! Constructs a batch from the given matrices
+    explicit FieldMatrixBatch(std::span<const matrix_type> matrices)
+    {
+      assign(matrices);
+    }
+
+    //! Replaces the matrices of the batch with the given ones
+    void assign(std::span<const matrix_type> matrices)
+    {
+      size_ = matrices.size();
+      // Unused lanes of the last block hold identity matrices, which can be
+      // inverted and factorized without a special case.
+      blocks_.assign((size_ + lanes - 1) / lanes, identityBlock());
+      for (size_type m = 0; m < size_; ++m)
+        for (int i = 0; i < ROWS; ++i)
+          for (int j = 0; j < COLS; ++j)
+            Simd::lane(m % lanes, blocks_[m / lanes][i][j]) = matrices[m][i][j];
+    }
+
+    //! Copies the matrices of the batch to the given span
+    void copyTo(std::span<matrix_type> matrices) const
+    {
+      DUNE_ASSERT_BOUNDS(matrices.size() == size_);
+      for (size_type m = 0; m < size_; ++m)
+        for (int i = 0; i < ROWS; ++i)
+          for (int j = 0; j < COLS; ++j)
+            matrices[m][i][j] = Simd::lane(m % lanes, blocks_[m / lanes][i][j]);
+    }
+
+    //! Returns a copy of the m-th matrix of the batch
+    matrix_type operator[] (size_type m) const
+    {
+      DUNE_ASSERT_BOUNDS(m < size_);
+      matrix_type matrix;
+      for (int i = 0; i < ROWS; ++i)
+        for (int j = 0; j < COLS; ++j)
+          matrix[i][j] = Simd::lane(m % lanes, blocks_[m / lanes][i][j]);
+      return matrix;
+    }
+
+    //! number of matrices in the batch
+    size_type size () const
+    {
+      return size_;
+    }
+
+    //! The blocks storing the matrices, the last block may be partially used
+    const std::vector<block_type>& blocks () const
+    {
+      return blocks_;
+    }
+
+    //! The blocks storing the matrices, the last block may be partially used
+    std::vector<block_type>& blocks ()
+    {
+      return blocks_;
+    }
+
+    //! y[m] = A[m] x[m] for all matrices of the batch
+    void mv (std::span<const FieldVector<K,COLS>> x, std::span<FieldVector<K,ROWS>> y) const
+    {
+      DUNE_ASSERT_BOUNDS(x.size() == size_);
+      DUNE_ASSERT_BOUNDS(y.size() == size_);
+      FieldVector<simd_type,COLS> xb;
+      FieldVector<simd_type,ROWS> yb;
+      for (size_type b = 0; b < blocks_.size(); ++b)
+      {
+        load(x, b, xb);
+        blocks_[b].mv(xb, yb);
+        store(yb, b, y);
+      }
+    }
+
+    //! y[m] = A[m]^T x[m] for all matrices of the batch
+    void mtv (std::span<const FieldVector<K,ROWS>> x, std::span<FieldVector<K,COLS>> y) const
+    {
+      DUNE_ASSERT_BOUNDS(x.size() == size_);
+      DUNE_ASSERT_BOUNDS(y.size() == size_);
+      FieldVector<simd_type,ROWS> xb;
+      FieldVector<simd_type,COLS> yb;
+      for (size_type b = 0; b < blocks_.size(); ++b)
+      {
+        load(x, b, xb);
+        blocks_[b].mtv(xb, yb);
+        store(yb, b, y);
+      }
+    }
+
+    //! A[m] = A[m] M[m] for all matrices of the batch
+    FieldMatrixBatch& rightmultiply (const FieldMatrixBatch<K,COLS,COLS,lanes>& M)
+    {
+      DUNE_ASSERT_BOUNDS(M.size() == size_);
+      for (size_type b = 0; b < blocks_.size(); ++b)
+        blocks_[b].rightmultiply(M.blocks()[b]);
+      return *this;
+    }
+
+    /** \brief Solve A[m] x[m] = b[m] for all matrices of the batch
+     *
+     * \throws FMatrixError if one of the matrices is singular, as
+     * FieldMatrix::solve does.
+     */
+    void solve (std::span<FieldVector<K,ROWS>> x, std::span<const FieldVector<K,ROWS>> rhs,
+                bool doPivoting = true) const
+    {
+      static_assert(ROWS == COLS, "Can only solve with square matrices");
+      DUNE_ASSERT_BOUNDS(x.size() == size_);
+      DUNE_ASSERT_BOUNDS(rhs.size() == size_);
+      FieldVector<simd_type,ROWS> xb, rhsb;
+      for (size_type b = 0; b < blocks_.size(); ++b)
+      {
+        load(rhs, b, rhsb);
+        blocks_[b].solve(xb, rhsb, doPivoting);
+        store(xb, b, x);
+      }
+    }
+
+    /** \brief Solve A[m] x[m] = b[m] for symmetric positive definite matrices
+     *
+     * Uses DenseCholesky instead of the LU decomposition of solve().  Without
+     * pivoting, no entries are swapped between lanes and the computation
+     * stays vectorized also for matrices larger than 4x4, for which solve()
+     * has no closed form.
+     *
+     * \throws FMatrixError if one of the matrices is not positive definite.
+     */
+    void choleskySolve (std::span<FieldVector<K,ROWS>> x,
+                        std::span<const FieldVector<K,ROWS>> rhs) const
+    {
+      static_assert(ROWS == COLS, "Can only solve with square matrices");
+      DUNE_ASSERT_BOUNDS(x.size() == size_);
+      DUNE_ASSERT_BOUNDS(rhs.size() == size_);
+      FieldVector<simd_type,ROWS> xb, rhsb;
+      for (size_type b = 0; b < blocks_.size(); ++b)
+      {
+        load(rhs, b, rhsb);
+        DenseCholesky<block_type>(blocks_[b]).solve(xb, rhsb);
+        store(xb, b, x);
+      }
+    }
+
+    /** \brief Replaces all matrices of the batch by their inverse
+     *
+     * \throws FMatrixError if one of the matrices is singular, as
+     * FieldMatrix::invert does.
+     */
+    void invert (bool doPivoting = true)
+    {
+      static_assert(ROWS == COLS, "Can only invert square matrices");
+      for (auto& block : blocks_)
+        block.invert(doPivoting);
+    }
+
+    //! Computes the determinants of all matrices of the batch
+    void determinant (std::span<K> det, bool doPivoting = true) const
+    {
+      static_assert(ROWS == COLS, "There is no determinant for non-square matrices");
+      DUNE_ASSERT_BOUNDS(det.size() == size_);
+      for (size_type b = 0; b < blocks_.size(); ++b)
+      {
+        simd_type d = blocks_[b].determinant(doPivoting);
+        for (size_type l = 0; l < used(b); ++l)
+          det[b*lanes + l] = Simd::lane(l, d);
+      }
+    }
+
+  private:
+    static block_type identityBlock ()
+    {
+      block_type block(simd_type(K(0)));
+      for (int i = 0; i < ROWS && i < COLS; ++i)
+        block[i][i] = simd_type(K(1));
+      return block;
+    }
+
+    // number of used lanes in block b
+    size_type used (size_type b) const
+    {
+      return std::min(lanes, size_ - b*lanes);
+    }
+
+    template<int n>
+    void load (std::span<const FieldVector<K,n>> x, size_type b, FieldVector<simd_type,n>& xb) const
+    {
+      const size_type u = used(b);
+      for (int i = 0; i < n; ++i)
+      {
+        for (size_type l = 0; l < u; ++l)
+          Simd::lane(l, xb[i]) = x[b*lanes + l][i];
+        for (size_type l = u; l < lanes; ++l)
+          Simd::lane(l, xb[i]) = K(0);
+      }
+    }
+
+    template<int n>
+    void store (const FieldVector<simd_type,n>& xb, size_type b, std::span<FieldVector<K,n>> x) const
+    {
+      const size_type u = used(b);
+      for (size_type l = 0; l < u; ++l)
+        for (int i = 0; i < n; ++i)
+          x[b*lanes + l][i] = Simd::lane(l, xb[i]);
+    }
+
+    std::vector<block_type> blocks_;
+    size_type size_ = 0;
+  };
+
+  /** @} end documentation */
+
+} // end namespace Dune
+
+#endif // DUNE_COMMON_FMATRIXBATCH_HH
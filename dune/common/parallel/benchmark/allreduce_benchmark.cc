@@ -0,0 +1,160 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark for reductions of FieldVectors, (value,rank) pairs and tuples.
+ *
+ * The following times of a call of allreduce with arrays of `length`
+ * elements are measured:
+ * FV_sum:     Communication::sum of FieldVector<double,3>, reduced as
+ *             scalars with MPI_SUM.
+ * FV_userop:  The same reduction with a user defined MPI operation.
+ * Minloc:     Communication::allreduce with Dune::MinLoc of
+ *             std::pair<double,int>, i.e. MPI_MINLOC.
+ * Minloc_userop: The same reduction with a user defined MPI operation.
+ *
+ * Furthermore the time of reducing a double, an int and a long with
+ * the sum, the maximum and the minimum, respectively, is measured:
+ * Separate:   Communication::sum, max and min one after another.
+ * Tuple:      One Communication::allreduce of a std::tuple with
+ *             Dune::TupleReduction.
+ * Tuple_NB:   Communication::iallreduce of the tuple followed by wait.
+ *
+ * Usage: mpirun ./allreduce_benchmark [options]
+ *
+ * options:
+ * -iterations: default: 1000. Number of reductions per measurement.
+ * -length: default: 1000. Number of elements in the reduced arrays.
+ * -hierarchical: default: -1. If not negative the communication is switched
+ *                to hierarchical mode with this group size (0 for one group
+ *                per node), see Communication::enableHierarchicalMode.
+ * -nohdr: default: 0. Suppress output of the header.
+ *
+ * options can be passed at the command-line (-key value).
+ */
+
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <mpi.h>
+
+#include <dune/common/binaryfunctions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/timer.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+#include <dune/common/parallel/mpicommunication.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+Dune::ParameterTree options;
+
+// Average time of a call of reduce over all iterations and ranks
+template<class CC, class Reduce>
+double measure(const CC& cc, Reduce&& reduce)
+{
+  const int iterations = options.get("iterations", 1000);
+  Dune::Timer watch(false);
+  for(int i = 0; i < iterations; i++){
+    cc.barrier();
+    watch.start();
+    reduce();
+    watch.stop();
+  }
+  return cc.sum(watch.elapsed())/iterations/cc.size();
+}
+
+int main(int argc, char** argv)
+{
+  Dune::MPIHelper& mpihelper = Dune::MPIHelper::instance(argc, argv);
+
+  // disable output on almost all ranks
+  if(mpihelper.rank() != 0)
+    std::cout.setstate(std::ios_base::failbit);
+  Dune::ParameterTreeParser::readOptions(argc, argv, options);
+
+  auto cc = mpihelper.getCommunication();
+  const int groupSize = options.get("hierarchical", -1);
+  if(groupSize >= 0)
+    cc.enableHierarchicalMode(groupSize);
+  MPI_Comm comm = mpihelper.getCommunicator();
+  const int length = options.get("length", 1000);
+
+  using Vector = Dune::FieldVector<double,3>;
+  const std::vector<Vector> vectors(length, Vector{1.0, double(cc.rank()), 2.0});
+  std::vector<Vector> vectorSums(length);
+
+  double fvSum = measure(cc, [&]{
+      cc.allreduce<std::plus<Vector> >(vectors.data(), vectorSums.data(), length);
+    });
+  double fvUserOp = measure(cc, [&]{
+      MPI_Allreduce(vectors.data(), vectorSums.data(), length,
+                    Dune::MPITraits<Vector>::getType(),
+                    Dune::Generic_MPI_Op<Vector, std::plus<Vector> >::get(), comm);
+    });
+
+  using Pair = std::pair<double,int>;
+  std::vector<Pair> pairs(length), minlocs(length);
+  for(int i = 0; i < length; i++)
+    pairs[i] = Pair((cc.rank()*7+i)%5, cc.rank());
+
+  double minloc = measure(cc, [&]{
+      cc.allreduce<Dune::MinLoc<Pair> >(pairs.data(), minlocs.data(), length);
+    });
+  double minlocUserOp = measure(cc, [&]{
+      MPI_Allreduce(pairs.data(), minlocs.data(), length,
+                    Dune::MPITraits<Pair>::getType(),
+                    Dune::Generic_MPI_Op<Pair, Dune::MinLoc<Pair> >::get(), comm);
+    });
+
+  const double value = cc.rank();
+  double sum = 0.0;
+  double separate = measure(cc, [&]{
+      sum = cc.sum(value);
+      sum += cc.max(cc.rank());
+      sum += cc.min(long(-cc.rank()));
+    });
+  using Reduction = Dune::TupleReduction<std::plus<double>, Dune::Max<int>, Dune::Min<long> >;
+  double tuple = measure(cc, [&]{
+      auto result = cc.allreduce<Reduction>(std::tuple<double,int,long>(value, cc.rank(), -cc.rank()));
+      sum = std::get<0>(result) + std::get<1>(result) + std::get<2>(result);
+    });
+  double tupleNB = measure(cc, [&]{
+      auto future = cc.iallreduce<Reduction>(std::tuple<double,int,long>(value, cc.rank(), -cc.rank()));
+      auto result = future.get();
+      sum = std::get<0>(result) + std::get<1>(result) + std::get<2>(result);
+    });
+
+  std::cout << std::left << std::scientific;
+  if(options.get("nohdr", 0) == 0)
+    std::cout << std::setw(10) << "commsize"
+              << std::setw(8) << "hier"
+              << std::setw(12) << "iterations"
+              << std::setw(10) << "length"
+              << std::setw(16) << "FV_sum"
+              << std::setw(16) << "FV_userop"
+              << std::setw(16) << "Minloc"
+              << std::setw(16) << "Minloc_userop"
+              << std::setw(16) << "Separate"
+              << std::setw(16) << "Tuple"
+              << std::setw(16) << "Tuple_NB"
+              << std::endl;
+  std::cout << std::setw(10) << cc.size()
+            << std::setw(8) << groupSize
+            << std::setw(12) << options.get("iterations", 1000)
+            << std::setw(10) << length
+            << std::setw(16) << fvSum
+            << std::setw(16) << fvUserOp
+            << std::setw(16) << minloc
+            << std::setw(16) << minlocUserOp
+            << std::setw(16) << separate
+            << std::setw(16) << tuple
+            << std::setw(16) << tupleNB
+            << std::endl;
+  return 0;
+}
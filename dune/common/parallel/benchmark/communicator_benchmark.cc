@@ -0,0 +1,253 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark for the halo exchange of the BufferedCommunicator and
+ * the possible overlap with computations.
+ *
+ * A vector is distributed in one dimension among the processes. Each
+ * process owns `size` entries and stores `overlap` additional entries
+ * of each of its neighbours. The owner values are sent to the overlap
+ * entries with BufferedCommunicator::forward.
+ *
+ * The following communication times are measured:
+ * Buffered:   BufferedCommunicator setting up new requests for each
+ *             communication.
+ * Persistent: BufferedCommunicator in persistent mode, where the requests
+ *             are set up once in build.
+ * Neighborhood: BufferedCommunicator exchanging the buffers with
+ *             MPI_Neighbor_alltoallv on a graph topology created in build.
+ *
+ * The possible overlap of computation and the halo exchange is measured
+ * like in mpi_collective_benchmark, using the split phase communication
+ * of the persistent BufferedCommunicator:
+ * NB_wait:    forwardBegin directly followed by forwardEnd.
+ * NB_sleep:   forwardBegin followed by a busy wait until the work time has
+ *             passed. Then forwardEnd.
+ * NB_active:  forwardBegin followed by a busy wait where in every
+ *             iteration the exchange is tested with ready(), scattering
+ *             the messages received so far. Then forwardEnd.
+ * The available part of the communication time (avail(%)) is computed as
+ * 1-(overhead/base_t), where base_t is the time with work time = 0 and the
+ * overhead is the iteration time minus the work time once the work time
+ * dominates the iteration time.
+ *
+ * Usage: mpirun ./communicator_benchmark [options]
+ *
+ * options:
+ * -iterations: default: 10000. Number of iterations for
+ *              measuring the time for one communication
+ * -size: default: 1000. Number of entries owned by each process.
+ * -overlap: default: 1. Number of entries stored for each neighbour.
+ * -verbose: default: 0. If 1 prints intermediate information while determining
+ *           the overhead.
+ * -threshold: default: 2. The threshold when the work time is the dominant
+ *             factor in the iteration time.
+ * -nohdr: default: 0. Suppress output of the header.
+ *
+ * options can be set either in the communicator_options.ini file or can be pass at
+ * the command-line (-key value).
+ */
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <tuple>
+#include <vector>
+
+#include <dune/common/enumset.hh>
+#include <dune/common/timer.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+#include <dune/common/parallel/communicator.hh>
+#include <dune/common/parallel/indexset.hh>
+#include <dune/common/parallel/interface.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/parallel/plocalindex.hh>
+#include <dune/common/parallel/remoteindices.hh>
+
+Dune::ParameterTree options;
+
+enum GridFlags {
+  owner, overlap
+};
+
+using ParallelIndexSet = Dune::ParallelIndexSet<int,Dune::ParallelLocalIndex<GridFlags> >;
+using RemoteIndices = Dune::RemoteIndices<ParallelIndexSet>;
+using Vector = std::vector<double>;
+
+// Set up the indices of a one dimensional decomposition with overlap.
+void setupIndexSet(ParallelIndexSet& indexSet, int rank, int procs)
+{
+  const int size = options.get("size", 1000);
+  const int ovlp = options.get("overlap", 1);
+  const int start = rank*size;
+  const int end = start+size;
+  const int ostart = rank>0 ? start-ovlp : start;
+  const int oend = rank<procs-1 ? end+ovlp : end;
+
+  indexSet.beginResize();
+  for(int i=ostart, local=0; i<oend; ++i, ++local) {
+    const bool isOwner = (i>=start && i<end);
+    indexSet.add(i, Dune::ParallelLocalIndex<GridFlags>(local, isOwner ? owner : overlap, true));
+  }
+  indexSet.endResize();
+}
+
+template<class CC>
+double runExchange(CC& cc, Dune::BufferedCommunicator& communicator,
+                   const Dune::Interface& interface, std::size_t n)
+{
+  Vector data(n, cc.rank());
+  int iterations = options.get("iterations", 10000);
+
+  communicator.build<Vector>(interface);
+
+  Dune::Timer watch(false);
+  for(int i = 0; i < iterations; i++){
+    cc.barrier();
+    watch.start();
+    communicator.template forward<Dune::CopyGatherScatter<Vector> >(data);
+    watch.stop();
+  }
+  return cc.sum(watch.elapsed())/iterations/cc.size();
+}
+
+// Start the exchange and work for wait_time before completing it. Returns
+// the time for the whole exchange and the time spent working.
+template<class CC>
+std::tuple<double, double> runSplitPhase(CC& cc, Dune::BufferedCommunicator& communicator,
+                                         Vector& data, bool active,
+                                         std::chrono::duration<double> wait_time)
+{
+  int iterations = options.get("iterations", 10000);
+  Dune::Timer watch(false), watch_work(false);
+  for(int i = 0; i < iterations; i++){
+    cc.barrier();
+    watch.start();
+    auto exchange = communicator.forwardBegin<Dune::CopyGatherScatter<Vector> >(data);
+    watch_work.start();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    while(std::chrono::high_resolution_clock::now()-start_time < wait_time)
+      if(active)
+        exchange.ready();
+    watch_work.stop();
+    communicator.forwardEnd(exchange);
+    watch.stop();
+  }
+  return std::tuple<double, double>(cc.sum(watch.elapsed())/iterations/cc.size(),
+                                    cc.sum(watch_work.elapsed())/iterations/cc.size());
+}
+
+/* Increases the work until it is the dominant factor in the iteration
+   time. Returns the base time and how much of it is available for
+   computations(%). It is computed with the formula 1-(overhead/base_t).
+ */
+std::tuple<double, double> determineOverlap(std::function<std::tuple<double, double>(std::chrono::duration<double>)> fun)
+{
+  double base_t = 0;
+  std::tie(base_t, std::ignore) = fun(std::chrono::duration<double>(0));
+  if(options.get("verbose", 0))
+    std::cout << std::endl << std::endl << std::setw(12) << "base_t:" << base_t << std::endl;
+  double iter_t = 0;
+  double work_t = 0;
+  int i = 1;
+  double iter_t_threshold = options.get("threshold", 2.0);
+  for(double work = 0.25*base_t; iter_t < iter_t_threshold*base_t; work *= 2, i++){
+    std::tie(iter_t, work_t) = fun(std::chrono::duration<double>(work));
+    if(options.get("verbose", 0))
+      std::cout << i << std::setw(12) << " iter_t:" << std::setw(12) << iter_t
+                << std::setw(12) << " work_t:" << std::setw(12) << work_t << std::endl;
+  }
+  double overhead = iter_t-work_t;
+  double avail = 1.0-overhead/base_t;
+  if(options.get("verbose", 0))
+    std::cout << std::setw(12) << " ovhd:" << std::setw(12) << overhead
+              << std::setw(12) << " available:"  << std::setw(12) << avail << std::endl;
+  return std::tuple<double, double>(base_t, avail);
+}
+
+template<class CC>
+void runOverlap(CC& cc, const Dune::Interface& interface, std::size_t n)
+{
+  Vector data(n, cc.rank());
+  Dune::BufferedCommunicator communicator(true);
+  communicator.build<Vector>(interface);
+
+  double nb_wait_t;
+  std::tie(nb_wait_t, std::ignore) = runSplitPhase(cc, communicator, data, false,
+                                                   std::chrono::duration<double>(0));
+  std::cout << std::setw(16) << nb_wait_t << std::flush;
+
+  for(bool active : {false, true}){
+    auto fun = [&](std::chrono::duration<double> wait_time){
+      return runSplitPhase(cc, communicator, data, active, wait_time);
+    };
+    double nb_t, nb_avail;
+    std::tie(nb_t, nb_avail) = determineOverlap(fun);
+    std::cout << std::setw(16) << nb_t
+              << std::setw(12) << std::fixed << std::setprecision(2) << 100*nb_avail
+              << std::scientific << std::setprecision(6) << std::flush;
+  }
+  std::cout << std::endl;
+}
+
+void printHeader()
+{
+  if(options.get("nohdr", 0) == 0){
+    std::cout << std::setw(10) << "commsize"
+              << std::setw(12) << "iterations"
+              << std::setw(10) << "size"
+              << std::setw(10) << "overlap"
+              << std::setw(16) << "Buffered"
+              << std::setw(16) << "Persistent"
+              << std::setw(16) << "Neighborhood"
+              << std::setw(16) << "NB_wait"
+              << std::setw(16) << "NB_sleep"
+              << std::setw(12) << "avail(%)"
+              << std::setw(16) << "NB_active"
+              << std::setw(12) << "avail(%)"
+              << std::endl;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  Dune::MPIHelper& mpihelper = Dune::MPIHelper::instance(argc, argv);
+
+  // disable output on almost all ranks
+  if(mpihelper.rank() != 0)
+    std::cout.setstate(std::ios_base::failbit);
+  // parse options
+  Dune::ParameterTreeParser::readINITree("communicator_options.ini", options);
+  Dune::ParameterTreeParser::readOptions(argc, argv, options);
+
+  auto cc = mpihelper.getCommunication();
+
+  ParallelIndexSet indexSet;
+  setupIndexSet(indexSet, cc.rank(), cc.size());
+
+  RemoteIndices remoteIndices(indexSet, indexSet, mpihelper.getCommunicator());
+  remoteIndices.rebuild<false>();
+
+  Dune::Interface interface;
+  interface.build(remoteIndices, Dune::EnumItem<GridFlags,owner>(),
+                  Dune::EnumItem<GridFlags,overlap>());
+
+  std::cout << std::left << std::scientific;
+  printHeader();
+  std::cout << std::setw(10) << cc.size()
+            << std::setw(12) << options.get("iterations", 10000)
+            << std::setw(10) << options.get("size", 1000)
+            << std::setw(10) << options.get("overlap", 1) << std::flush;
+  Dune::BufferedCommunicator buffered, persistent(true),
+    neighborhood(Dune::CommunicationBackend::neighborhoodCollective);
+  std::cout << std::setw(16) << runExchange(cc, buffered, interface, indexSet.size()) << std::flush;
+  std::cout << std::setw(16) << runExchange(cc, persistent, interface, indexSet.size()) << std::flush;
+  std::cout << std::setw(16) << runExchange(cc, neighborhood, interface, indexSet.size()) << std::flush;
+  runOverlap(cc, interface, indexSet.size());
+  return 0;
+}
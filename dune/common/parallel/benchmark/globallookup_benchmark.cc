@@ -0,0 +1,120 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark for looking up global indices in an index set.
+ *
+ * An index set with `size` indices is set up. The global index of the i-th
+ * index is i*`stride`. Then `lookups` randomly chosen global indices of the
+ * index set are looked up.
+ *
+ * The following lookup times are measured (per looked up index):
+ * Binary:  GlobalLookupIndexSet::operator[], i.e. binary search in the index set.
+ * Hashed:  HashedGlobalLookupIndexSet::find for each index.
+ * Batched: HashedGlobalLookupIndexSet::lookup for all indices at once.
+ * For stride 1 the hashed lookup uses the direct mapping of compact
+ * global indices. The time for building the tables is reported as well.
+ *
+ * Usage: ./globallookup_benchmark [options]
+ *
+ * options:
+ * -size: default: 1000000. Number of indices in the index set.
+ * -stride: default: 1. Distance between consecutive global indices.
+ * -lookups: default: 10000000. Number of looked up global indices.
+ * -nohdr: default: 0. Suppress output of the header.
+ *
+ * options can be passed at the command-line (-key value).
+ */
+
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <dune/common/timer.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+#include <dune/common/parallel/hashedlookupindexset.hh>
+#include <dune/common/parallel/indexset.hh>
+#include <dune/common/parallel/localindex.hh>
+
+using IndexSet = Dune::ParallelIndexSet<long long,Dune::LocalIndex>;
+using IndexPair = IndexSet::IndexPair;
+
+int main(int argc, char** argv)
+{
+  Dune::ParameterTree options;
+  Dune::ParameterTreeParser::readOptions(argc, argv, options);
+
+  const std::size_t size = options.get("size", 1000000);
+  const long long stride = options.get("stride", 1);
+  const std::size_t lookups = options.get("lookups", 10000000);
+
+  IndexSet indexSet;
+  indexSet.beginResize();
+  for(std::size_t i=0; i<size; ++i)
+    indexSet.add(i*stride, Dune::LocalIndex(i));
+  indexSet.endResize();
+
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<std::size_t> distribution(0, size-1);
+  std::vector<long long> globals(lookups);
+  for(auto& global : globals)
+    global = distribution(generator)*stride;
+
+  // Sum up the local indices to prevent the compiler from optimizing the lookups away.
+  std::size_t checksum[3] = {0, 0, 0};
+  Dune::Timer watch;
+
+  Dune::GlobalLookupIndexSet<IndexSet> binary(indexSet, size);
+  watch.reset();
+  for(const auto& global : globals)
+    checksum[0] += binary[global].local();
+  const double binaryTime = watch.elapsed();
+
+  watch.reset();
+  Dune::HashedGlobalLookupIndexSet<IndexSet> hashed(indexSet, size);
+  const double buildTime = watch.elapsed();
+
+  watch.reset();
+  for(const auto& global : globals)
+    checksum[1] += hashed.find(global)->local();
+  const double hashedTime = watch.elapsed();
+
+  std::vector<const IndexPair*> pairs(lookups);
+  watch.reset();
+  hashed.lookup(globals, pairs.begin());
+  for(const auto& pair : pairs)
+    checksum[2] += pair->local();
+  const double batchedTime = watch.elapsed();
+
+  if(checksum[0] != checksum[1] || checksum[0] != checksum[2]) {
+    std::cerr << "Lookups do not match!" << std::endl;
+    return 1;
+  }
+
+  std::cout << std::left << std::scientific;
+  if(options.get("nohdr", 0) == 0)
+    std::cout << std::setw(10) << "size"
+              << std::setw(10) << "stride"
+              << std::setw(12) << "lookups"
+              << std::setw(8) << "dense"
+              << std::setw(16) << "build"
+              << std::setw(16) << "Binary"
+              << std::setw(16) << "Hashed"
+              << std::setw(16) << "Batched"
+              << std::endl;
+  std::cout << std::setw(10) << size
+            << std::setw(10) << stride
+            << std::setw(12) << lookups
+            << std::setw(8) << hashed.isDense()
+            << std::setw(16) << buildTime
+            << std::setw(16) << binaryTime/lookups
+            << std::setw(16) << hashedTime/lookups
+            << std::setw(16) << batchedTime/lookups
+            << std::endl;
+  return 0;
+}
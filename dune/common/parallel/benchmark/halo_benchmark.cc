@@ -0,0 +1,377 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark for the halo exchange of the communicators on
+ * structured decompositions in one, two and three dimensions.
+ *
+ * The processes are arranged in a `dim` dimensional grid by
+ * MPI_Dims_create. Each process owns `size`^`dim` entries of a structured
+ * grid and stores the entries of its neighbours (including the diagonal
+ * ones) up to a distance of `overlap`. Each entry is a block of `block`
+ * doubles. The owner values are sent to the overlap entries.
+ *
+ * For each communicator a row with the following values is written:
+ * rebuild:   The time of RemoteIndices::rebuild, the same in all rows.
+ * interface: The time of Interface::build, the same in all rows.
+ * setup:     The time to set up the communicator for the interface, i.e.
+ *            its build method or constructor.
+ * time:      The time of one halo exchange, i.e. its latency.
+ * MB/s:      The bytes sent per process and exchange divided by the time.
+ *            Varying `size` and `block` separates the constant latency
+ *            from the bandwidth.
+ * NB_sleep:  The base time of an exchange split into forwardBegin and
+ *            forwardEnd, and the part of it available for computations
+ *            in between (avail(%)), see communicator_benchmark.
+ * NB_active: The same with testing the exchange with ready() while
+ *            computing.
+ *
+ * The communicators are:
+ * Buffered:     BufferedCommunicator.
+ * Persistent:   BufferedCommunicator with persistent requests.
+ * Neighborhood: BufferedCommunicator using MPI_Neighbor_alltoallv.
+ * Datatype:     DatatypeCommunicator.
+ * VariableSize: VariableSizeCommunicator with a fixed size data handle.
+ *
+ * Usage: mpirun ./halo_benchmark [options]
+ *
+ * options:
+ * -iterations: default: 1000. Number of iterations for measuring the time
+ *              of one exchange.
+ * -setupIterations: default: 10. Number of iterations for measuring the
+ *              setup times.
+ * -dim: default: 3. The dimension of the decomposition (1, 2 or 3).
+ * -size: default: 16. Number of entries owned by each process in each direction.
+ * -overlap: default: 1. The width of the halo.
+ * -block: default: 1. Number of doubles per entry (1, 2, 3, 4 or 8).
+ * -threshold: default: 2. The threshold when the work time is the dominant
+ *             factor in the iteration time.
+ * -nohdr: default: 0. Suppress output of the header.
+ *
+ * options can be set either in the halo_options.ini file or can be passed
+ * at the command-line (-key value).
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <mpi.h>
+
+#include <dune/common/enumset.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/hybridutilities.hh>
+#include <dune/common/timer.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+#include <dune/common/parallel/communicator.hh>
+#include <dune/common/parallel/indexset.hh>
+#include <dune/common/parallel/interface.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/parallel/plocalindex.hh>
+#include <dune/common/parallel/remoteindices.hh>
+#include <dune/common/parallel/variablesizecommunicator.hh>
+
+Dune::ParameterTree options;
+
+enum GridFlags {
+  owner, overlap
+};
+
+using ParallelIndexSet = Dune::ParallelIndexSet<long long,Dune::ParallelLocalIndex<GridFlags> >;
+using RemoteIndices = Dune::RemoteIndices<ParallelIndexSet>;
+using Communication = Dune::Communication<MPI_Comm>;
+
+// Set up the indices of a structured decomposition with overlap.
+void setupIndexSet(ParallelIndexSet& indexSet, MPI_Comm comm, int dim)
+{
+  const long long size = options.get("size", 16);
+  const long long ovlp = options.get("overlap", 1);
+
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+  std::array<int,3> dims = {0, 0, 0};
+  MPI_Dims_create(procs, dim, dims.data());
+  std::replace(dims.begin(), dims.end(), 0, 1);
+
+  // the owned and the stored entries of this process in each direction
+  std::array<long long,3> global, start, end, ostart, oend;
+  for(int d=0, r=rank; d<3; r/=dims[d], ++d) {
+    const long long n = d < dim ? size : 1;
+    const long long o = d < dim ? ovlp : 0;
+    global[d] = dims[d]*n;
+    start[d] = (r%dims[d])*n;
+    end[d] = start[d]+n;
+    ostart[d] = std::max(start[d]-o, 0ll);
+    oend[d] = std::min(end[d]+o, global[d]);
+  }
+
+  indexSet.beginResize();
+  int local = 0;
+  for(long long k=ostart[2]; k<oend[2]; ++k)
+    for(long long j=ostart[1]; j<oend[1]; ++j)
+      for(long long i=ostart[0]; i<oend[0]; ++i, ++local) {
+        const bool isOwner = i>=start[0] && i<end[0] && j>=start[1] && j<end[1]
+          && k>=start[2] && k<end[2];
+        indexSet.add((k*global[1]+j)*global[0]+i,
+                     Dune::ParallelLocalIndex<GridFlags>(local, isOwner ? owner : overlap, true));
+      }
+  indexSet.endResize();
+}
+
+// The data handle of the VariableSizeCommunicator.
+template<class Vector>
+struct BlockHandle
+{
+  typedef typename Vector::value_type::value_type DataType;
+
+  Vector& data;
+
+  bool fixedSize() const
+  {
+    return true;
+  }
+
+  std::size_t size(std::size_t) const
+  {
+    return Vector::value_type::dimension;
+  }
+
+  template<class B>
+  void gather(B& buffer, std::size_t i)
+  {
+    for(const auto& value : data[i])
+      buffer.write(value);
+  }
+
+  template<class B>
+  void scatter(B& buffer, std::size_t i, std::size_t)
+  {
+    for(auto& value : data[i])
+      buffer.read(value);
+  }
+};
+
+// The average time of fun over all processes.
+double measure(const Communication& cc, int iterations, const std::function<void()>& fun)
+{
+  Dune::Timer watch(false);
+  for(int i = 0; i < iterations; i++){
+    cc.barrier();
+    watch.start();
+    fun();
+    watch.stop();
+  }
+  return cc.sum(watch.elapsed())/iterations/cc.size();
+}
+
+/* Runs an exchange split into begin and end with a busy wait for
+   wait_time in between, testing the exchange if active. Returns the
+   times of the whole exchange and of the work.
+ */
+template<class Begin, class End>
+std::tuple<double, double> runSplitPhase(const Communication& cc, Begin&& begin, End&& end,
+                                         bool active, std::chrono::duration<double> wait_time)
+{
+  int iterations = options.get("iterations", 1000);
+  Dune::Timer watch(false), watch_work(false);
+  for(int i = 0; i < iterations; i++){
+    cc.barrier();
+    watch.start();
+    auto exchange = begin();
+    watch_work.start();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    while(std::chrono::high_resolution_clock::now()-start_time < wait_time)
+      if(active)
+        exchange.ready();
+    watch_work.stop();
+    end(exchange);
+    watch.stop();
+  }
+  return std::tuple<double, double>(cc.sum(watch.elapsed())/iterations/cc.size(),
+                                    cc.sum(watch_work.elapsed())/iterations/cc.size());
+}
+
+/* Increases the work until it is the dominant factor in the iteration
+   time. Returns the base time and how much of it is available for
+   computations(%). It is computed with the formula 1-(overhead/base_t).
+ */
+template<class Fun>
+std::tuple<double, double> determineOverlap(Fun&& fun)
+{
+  double base_t = 0;
+  std::tie(base_t, std::ignore) = fun(std::chrono::duration<double>(0));
+  double iter_t = 0;
+  double work_t = 0;
+  double iter_t_threshold = options.get("threshold", 2.0);
+  for(double work = 0.25*base_t; iter_t < iter_t_threshold*base_t; work *= 2)
+    std::tie(iter_t, work_t) = fun(std::chrono::duration<double>(work));
+  return std::tuple<double, double>(base_t, 1.0-(iter_t-work_t)/base_t);
+}
+
+// The columns describing the run, repeated in every row.
+struct Setup
+{
+  int dim;
+  double rebuild;
+  double interface;
+  std::size_t bytes;
+};
+
+template<class Forward, class Begin, class End>
+void run(const Communication& cc, const Setup& setup, const std::string& name,
+         double setupTime, Forward&& forward, Begin&& begin, End&& end)
+{
+  const double time = measure(cc, options.get("iterations", 1000), forward);
+  std::cout << std::setw(10) << cc.size()
+            << std::setw(5) << setup.dim
+            << std::setw(8) << options.get("size", 16)
+            << std::setw(9) << options.get("overlap", 1)
+            << std::setw(7) << options.get("block", 1)
+            << std::setw(14) << name
+            << std::setw(14) << setup.rebuild
+            << std::setw(14) << setup.interface
+            << std::setw(14) << setupTime
+            << std::setw(14) << time
+            << std::setw(14) << setup.bytes/time/1e6 << std::flush;
+  for(bool active : {false, true}){
+    double nb_t, nb_avail;
+    std::tie(nb_t, nb_avail) = determineOverlap([&](std::chrono::duration<double> wait_time){
+        return runSplitPhase(cc, begin, end, active, wait_time);
+      });
+    std::cout << std::setw(14) << nb_t
+              << std::setw(10) << std::fixed << std::setprecision(2) << 100*nb_avail
+              << std::scientific << std::setprecision(6) << std::flush;
+  }
+  std::cout << std::endl;
+}
+
+template<int block>
+void runAll(const Communication& cc, Setup setup, const RemoteIndices& remoteIndices,
+            const Dune::Interface& interface)
+{
+  using Vector = std::vector<Dune::FieldVector<double,block> >;
+  using GatherScatter = Dune::CopyGatherScatter<Vector>;
+  const int setupIterations = options.get("setupIterations", 10);
+  const std::size_t n = remoteIndices.sourceIndexSet().size();
+  Vector data(n, typename Vector::value_type(cc.rank()));
+
+  std::size_t entries = 0;
+  for(const auto& neighbour : interface.interfaces())
+    entries += neighbour.second.first.size();
+  setup.bytes = cc.sum(entries*sizeof(typename Vector::value_type))/cc.size();
+
+  auto runBuffered = [&](const std::string& name, auto... arguments){
+    Dune::BufferedCommunicator communicator(arguments...);
+    double setupTime = measure(cc, setupIterations, [&]{
+        communicator.free();
+        communicator.build<Vector>(interface);
+      });
+    run(cc, setup, name, setupTime,
+        [&]{ communicator.template forward<GatherScatter>(data); },
+        [&]{ return communicator.template forwardBegin<GatherScatter>(data); },
+        [&](auto& exchange){ communicator.forwardEnd(exchange); });
+  };
+  runBuffered("Buffered");
+  runBuffered("Persistent", true);
+  runBuffered("Neighborhood", Dune::CommunicationBackend::neighborhoodCollective);
+
+  {
+    Dune::DatatypeCommunicator<ParallelIndexSet> communicator;
+    double setupTime = measure(cc, setupIterations, [&]{
+        communicator.build(remoteIndices, Dune::EnumItem<GridFlags,owner>(), data,
+                           Dune::EnumItem<GridFlags,overlap>(), data);
+      });
+    run(cc, setup, "Datatype", setupTime,
+        [&]{ communicator.forward(); },
+        [&]{ return communicator.forwardBegin(); },
+        [&](auto& exchange){ communicator.forwardEnd(exchange); });
+  }
+
+  {
+    BlockHandle<Vector> handle{data};
+    std::unique_ptr<Dune::VariableSizeCommunicator<> > communicator;
+    double setupTime = measure(cc, setupIterations, [&]{
+        communicator = std::make_unique<Dune::VariableSizeCommunicator<> >(interface);
+      });
+    run(cc, setup, "VariableSize", setupTime,
+        [&]{ communicator->forward(handle); },
+        [&]{ return communicator->forwardBegin(handle); },
+        [&](auto& exchange){ communicator->forwardEnd(exchange); });
+  }
+}
+
+void printHeader()
+{
+  if(options.get("nohdr", 0) == 0){
+    std::cout << std::setw(10) << "commsize"
+              << std::setw(5) << "dim"
+              << std::setw(8) << "size"
+              << std::setw(9) << "overlap"
+              << std::setw(7) << "block"
+              << std::setw(14) << "communicator"
+              << std::setw(14) << "rebuild"
+              << std::setw(14) << "interface"
+              << std::setw(14) << "setup"
+              << std::setw(14) << "time"
+              << std::setw(14) << "MB/s"
+              << std::setw(14) << "NB_sleep"
+              << std::setw(10) << "avail(%)"
+              << std::setw(14) << "NB_active"
+              << std::setw(10) << "avail(%)"
+              << std::endl;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  Dune::MPIHelper& mpihelper = Dune::MPIHelper::instance(argc, argv);
+
+  // disable output on almost all ranks
+  if(mpihelper.rank() != 0)
+    std::cout.setstate(std::ios_base::failbit);
+  // parse options
+  Dune::ParameterTreeParser::readINITree("halo_options.ini", options);
+  Dune::ParameterTreeParser::readOptions(argc, argv, options);
+
+  auto cc = mpihelper.getCommunication();
+  const int setupIterations = options.get("setupIterations", 10);
+  Setup setup;
+  setup.dim = options.get("dim", 3);
+  if(setup.dim < 1 || setup.dim > 3)
+    DUNE_THROW(Dune::RangeError, "dim has to be 1, 2 or 3");
+
+  ParallelIndexSet indexSet;
+  setupIndexSet(indexSet, mpihelper.getCommunicator(), setup.dim);
+
+  RemoteIndices remoteIndices(indexSet, indexSet, mpihelper.getCommunicator());
+  setup.rebuild = measure(cc, setupIterations, [&]{ remoteIndices.rebuild<false>(); });
+
+  Dune::Interface interface;
+  setup.interface = measure(cc, setupIterations, [&]{
+      interface.free();
+      interface.build(remoteIndices, Dune::EnumItem<GridFlags,owner>(),
+                      Dune::EnumItem<GridFlags,overlap>());
+    });
+
+  std::cout << std::left << std::scientific;
+  printHeader();
+  const int block = options.get("block", 1);
+  Dune::Hybrid::switchCases(std::integer_sequence<int,1,2,3,4,8>(), block,
+    [&](auto b){ runAll<decltype(b)::value>(cc, setup, remoteIndices, interface); },
+    [&]{ DUNE_THROW(Dune::RangeError, "block has to be 1, 2, 3, 4 or 8"); });
+  return 0;
+}
@@ -0,0 +1,116 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark for ParallelIndexSet::endResize.
+ *
+ * `size` indices with randomly shuffled global indices are added to an
+ * empty index set. Then `size`/10 further indices are added and every
+ * tenth index is deleted, as after an adaptation of a mesh.
+ *
+ * The following times are measured:
+ * Sort:     std::sort of the first indices in an ArrayList, for comparison.
+ * Build:    endResize with the first indices.
+ * Update:   endResize with the further indices.
+ * Both are measured with one thread and with `threads` threads.
+ *
+ * Usage: ./indexset_benchmark [options]
+ *
+ * options:
+ * -size: default: 10000000. Number of indices in the index set.
+ * -threads: default: 4. Number of threads used by endResize.
+ * -nohdr: default: 0. Suppress output of the header.
+ *
+ * options can be passed at the command-line (-key value).
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <dune/common/arraylist.hh>
+#include <dune/common/timer.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+#include <dune/common/parallel/indexset.hh>
+#include <dune/common/parallel/localindex.hh>
+
+using IndexSet = Dune::ParallelIndexSet<long long,Dune::LocalIndex>;
+using IndexPair = IndexSet::IndexPair;
+
+// Measures building and updating an index set.
+void measure(const std::vector<long long>& globals, std::size_t threads,
+             double& build, double& update)
+{
+  const std::size_t size = globals.size();
+  IndexSet indexSet;
+  Dune::Timer watch;
+
+  indexSet.beginResize();
+  for(std::size_t i=0; i<size; ++i)
+    indexSet.add(globals[i], Dune::LocalIndex(i));
+  watch.reset();
+  indexSet.endResize(threads);
+  build = watch.elapsed();
+
+  indexSet.beginResize();
+  std::size_t i=0;
+  for(auto index = indexSet.begin(); index != indexSet.end(); ++index, ++i)
+    if(i%10 == 0)
+      indexSet.markAsDeleted(index);
+  for(std::size_t j=0; j<size/10; ++j)
+    indexSet.add(size+j, Dune::LocalIndex(size+j));
+  watch.reset();
+  indexSet.endResize(threads);
+  update = watch.elapsed();
+}
+
+int main(int argc, char** argv)
+{
+  Dune::ParameterTree options;
+  Dune::ParameterTreeParser::readOptions(argc, argv, options);
+
+  const std::size_t size = options.get("size", 10000000);
+  const std::size_t threads = options.get("threads", 4);
+
+  std::vector<long long> globals(size);
+  std::iota(globals.begin(), globals.end(), 0ll);
+  std::shuffle(globals.begin(), globals.end(), std::mt19937(42));
+
+  Dune::ArrayList<IndexPair,100> list;
+  for(std::size_t i=0; i<size; ++i)
+    list.push_back(IndexPair(globals[i], Dune::LocalIndex(i)));
+  Dune::Timer watch;
+  std::sort(list.begin(), list.end(), Dune::IndexSetSortFunctor<long long,Dune::LocalIndex>());
+  const double sortTime = watch.elapsed();
+
+  double build[2], update[2];
+  measure(globals, 1, build[0], update[0]);
+  measure(globals, threads, build[1], update[1]);
+
+  std::cout << std::left << std::scientific;
+  if(options.get("nohdr", 0) == 0)
+    std::cout << std::setw(12) << "size"
+              << std::setw(10) << "threads"
+              << std::setw(16) << "Sort"
+              << std::setw(16) << "Build"
+              << std::setw(16) << "Update"
+              << std::setw(16) << "Build_MT"
+              << std::setw(16) << "Update_MT"
+              << std::endl;
+  std::cout << std::setw(12) << size
+            << std::setw(10) << threads
+            << std::setw(16) << sortTime
+            << std::setw(16) << build[0]
+            << std::setw(16) << update[0]
+            << std::setw(16) << build[1]
+            << std::setw(16) << update[1]
+            << std::endl;
+  return 0;
+}
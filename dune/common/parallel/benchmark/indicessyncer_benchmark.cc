@@ -0,0 +1,168 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark for IndicesSyncer::sync.
+ *
+ * A two dimensional structured grid of vertices is distributed among a
+ * two dimensional grid of processes. Each process owns `size`x`size`
+ * vertices and stores `overlap` additional layers of vertices of the
+ * processes to its left, right, bottom, and top. After building the remote
+ * indices the overlap indices are removed from the index set and the
+ * remote index lists. IndicesSyncer::sync restores them from the
+ * information of the owning processes.
+ *
+ * Setting up the index set and the remote indices is not measured. The
+ * time reported is the average time of a call of sync.
+ *
+ * Usage: mpirun ./indicessyncer_benchmark [options]
+ *
+ * options:
+ * -iterations: default: 10. Number of calls of sync.
+ * -size: default: 200. Number of vertices owned by each process in each direction.
+ * -overlap: default: 2. Number of layers stored of each neighbour.
+ * -nohdr: default: 0. Suppress output of the header.
+ *
+ * options can be passed at the command-line (-key value).
+ */
+
+#include <array>
+#include <iostream>
+#include <iomanip>
+#include <map>
+
+#include <mpi.h>
+
+#include <dune/common/timer.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+#include <dune/common/parallel/indexset.hh>
+#include <dune/common/parallel/indicessyncer.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/parallel/plocalindex.hh>
+#include <dune/common/parallel/remoteindices.hh>
+
+Dune::ParameterTree options;
+
+enum GridFlags {
+  owner, overlap
+};
+
+using ParallelIndexSet = Dune::ParallelIndexSet<int,Dune::ParallelLocalIndex<GridFlags> >;
+using RemoteIndices = Dune::RemoteIndices<ParallelIndexSet>;
+
+// Set up the indices of the owned vertices and the overlap stripes of the
+// direct neighbours.
+void setupIndexSet(ParallelIndexSet& indexSet, const std::array<int,2>& dims,
+                   const std::array<int,2>& coords)
+{
+  const int size = options.get("size", 200);
+  const int ovlp = options.get("overlap", 2);
+  const int columns = dims[0]*size;
+  std::array<int,2> start, end, ostart, oend;
+  for(int d=0; d<2; ++d) {
+    start[d] = coords[d]*size;
+    end[d] = start[d]+size;
+    ostart[d] = coords[d]>0 ? start[d]-ovlp : start[d];
+    oend[d] = coords[d]<dims[d]-1 ? end[d]+ovlp : end[d];
+  }
+
+  indexSet.beginResize();
+  int local=0;
+  for(int j=ostart[1]; j<oend[1]; ++j)
+    for(int i=ostart[0]; i<oend[0]; ++i) {
+      const bool ownerColumn = (i>=start[0] && i<end[0]);
+      const bool ownerRow = (j>=start[1] && j<end[1]);
+      if(!ownerColumn && !ownerRow)
+        continue;
+      indexSet.add(j*columns+i,
+                   Dune::ParallelLocalIndex<GridFlags>(local++, ownerColumn && ownerRow ? owner : overlap, true));
+    }
+  indexSet.endResize();
+}
+
+// Remove the overlap indices from the index set and the remote index lists.
+void removeOverlap(ParallelIndexSet& indexSet, RemoteIndices& remoteIndices)
+{
+  using GlobalList = Dune::SLList<std::pair<int,GridFlags>, RemoteIndices::RemoteIndexList::Allocator>;
+  std::map<int,GlobalList> globalLists;
+
+  for(const auto& remote : remoteIndices) {
+    GlobalList& globals = globalLists[remote.first];
+    auto rIndex = remote.second.first->beginModify();
+    const auto rEnd = remote.second.first->end();
+    while(rIndex != rEnd) {
+      const auto& pair = rIndex->localIndexPair();
+      if(pair.local().attribute() == overlap)
+        rIndex.remove();
+      else {
+        globals.push_back(std::make_pair(pair.global(), pair.local().attribute()));
+        ++rIndex;
+      }
+    }
+  }
+
+  indexSet.beginResize();
+  for(auto index = indexSet.begin(); index != indexSet.end(); ++index)
+    if(index->local().attribute() == overlap)
+      indexSet.markAsDeleted(index);
+  indexSet.endResize();
+
+  Dune::repairLocalIndexPointers(globalLists, remoteIndices, indexSet);
+}
+
+int main(int argc, char** argv)
+{
+  Dune::MPIHelper& mpihelper = Dune::MPIHelper::instance(argc, argv);
+
+  // disable output on almost all ranks
+  if(mpihelper.rank() != 0)
+    std::cout.setstate(std::ios_base::failbit);
+  Dune::ParameterTreeParser::readOptions(argc, argv, options);
+
+  auto cc = mpihelper.getCommunication();
+
+  int dims[2] = {0, 0};
+  MPI_Dims_create(cc.size(), 2, dims);
+  const std::array<int,2> procs = {dims[0], dims[1]};
+  const std::array<int,2> coords = {cc.rank()%dims[0], cc.rank()/dims[0]};
+
+  const int iterations = options.get("iterations", 10);
+  Dune::Timer watch(false);
+  std::size_t restored = 0;
+  for(int i = 0; i < iterations; i++){
+    ParallelIndexSet indexSet;
+    setupIndexSet(indexSet, procs, coords);
+    RemoteIndices remoteIndices(indexSet, indexSet, mpihelper.getCommunicator());
+    remoteIndices.rebuild<false>();
+    removeOverlap(indexSet, remoteIndices);
+    Dune::IndicesSyncer<ParallelIndexSet> syncer(indexSet, remoteIndices);
+
+    const std::size_t size = indexSet.size();
+    cc.barrier();
+    watch.start();
+    syncer.sync();
+    watch.stop();
+    restored = indexSet.size() - size;
+  }
+
+  std::cout << std::left << std::scientific;
+  if(options.get("nohdr", 0) == 0)
+    std::cout << std::setw(10) << "commsize"
+              << std::setw(12) << "iterations"
+              << std::setw(10) << "size"
+              << std::setw(10) << "overlap"
+              << std::setw(12) << "restored"
+              << std::setw(16) << "sync"
+              << std::endl;
+  std::cout << std::setw(10) << cc.size()
+            << std::setw(12) << iterations
+            << std::setw(10) << options.get("size", 200)
+            << std::setw(10) << options.get("overlap", 2)
+            << std::setw(12) << cc.sum(restored)
+            << std::setw(16) << cc.sum(watch.elapsed())/iterations/cc.size()
+            << std::endl;
+  return 0;
+}
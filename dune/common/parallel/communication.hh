@@ -15,6 +15,7 @@
 #include <complex>
 #include <algorithm>
 #include <vector>
+#include <utility>
 
 #include <dune/common/binaryfunctions.hh>
 #include <dune/common/exceptions.hh>
@@ -488,6 +489,24 @@ namespace Dune
       return 0;
     }
 
+    /**
+     * @brief Compute something over all processes and return the result
+     * in every process.
+     *
+     * The template parameter BinaryFunction is the type of the binary
+     * function to use for the computation. Together with TupleReduction
+     * and a std::tuple or TupleVector several values are reduced with
+     * different functions at once.
+     *
+     * @param in The data to compute on, it is reduced in place if it is an lvalue.
+     * @returns The result of the computation
+     */
+    template<typename BinaryFunction, typename Type>
+    Type allreduce(Type&& in) const
+    {
+      return std::forward<Type>(in);
+    }
+
     /**
      * @brief Compute something over all processes nonblocking
      @return Future<TOUT, TIN> containing the computed something
@@ -0,0 +1,514 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_PARALLEL_COMMUNICATIONSTATISTICS_HH
+#define DUNE_COMMON_PARALLEL_COMMUNICATIONSTATISTICS_HH
+
+/**
+ * @file
+ * @brief Opt-in statistics of the communication of the parallel module.
+ * @ingroup ParallelCommunication
+ *
+ * If the preprocessor macro `DUNE_COMMUNICATION_STATISTICS` is defined to
+ * a nonzero value, BufferedCommunicator, VariableSizeCommunicator,
+ * IndicesSyncer and the collectives of Communication<MPI_Comm> record for
+ * each call site the number of calls, messages, bytes and neighbours as
+ * well as the time spent in total, in packing and unpacking, and in
+ * waiting for messages. Otherwise the recording macros expand to nothing.
+ *
+ * At finalization the MPIHelper prints a summary aggregated over all
+ * processes. If the environment variable `DUNE_COMMUNICATION_TRACE` names a
+ * file, every recorded call is additionally written to it in the Chrome
+ * trace event format, which can be viewed e.g. with Perfetto.
+ *
+ * Other code can be instrumented with the same macros:
+ * \code
+ * void exchange(...)
+ * {
+ *   DUNE_COMMUNICATION_SCOPE("MyCode::exchange");
+ *   DUNE_COMMUNICATION_NEIGHBOURS(neighbours.size());
+ *   {
+ *     DUNE_COMMUNICATION_PACK_PHASE;
+ *     ... // pack the messages
+ *   }
+ *   for(...) {
+ *     MPI_Isend(...);
+ *     DUNE_COMMUNICATION_MESSAGE(bytes);
+ *   }
+ *   DUNE_COMMUNICATION_WAIT_PHASE;
+ *   MPI_Waitall(...);
+ * }
+ * \endcode
+ * Times of nested phases are only attributed to the innermost phase,
+ * whereas the total time of a scope includes the time of nested scopes.
+ *
+ * Without the macro, this header only defines the empty recording macros.
+ * As the macro changes inline functions of the instrumented classes, it
+ * has to have the same value in all translation units of a program.
+ * Otherwise the one definition rule is violated.
+ */
+
+#if DUNE_COMMUNICATION_STATISTICS && HAVE_MPI
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <mpi.h>
+
+namespace Dune
+{
+  /** @brief The communication recorded at a call site. */
+  struct CommunicationCounters
+  {
+    //! The number of calls.
+    std::size_t calls = 0;
+    //! The number of messages sent.
+    std::size_t messages = 0;
+    //! The number of bytes sent.
+    std::size_t bytes = 0;
+    //! The sum of the number of neighbours over all calls.
+    std::size_t neighbours = 0;
+    //! The time in seconds spent in the call site.
+    double time = 0;
+    //! The time in seconds spent packing and unpacking messages.
+    double packTime = 0;
+    //! The time in seconds spent waiting for the communication.
+    double waitTime = 0;
+
+    CommunicationCounters& operator+= (const CommunicationCounters& other)
+    {
+      calls += other.calls;
+      messages += other.messages;
+      bytes += other.bytes;
+      neighbours += other.neighbours;
+      time += other.time;
+      packTime += other.packTime;
+      waitTime += other.waitTime;
+      return *this;
+    }
+  };
+
+  namespace Impl
+  {
+    class CommunicationScope;
+  }
+
+  /**
+   * @brief The statistics of all call sites of this process.
+   *
+   * The data is only recorded if `DUNE_COMMUNICATION_STATISTICS` is
+   * defined, see communicationstatistics.hh.
+   */
+  class CommunicationStatistics
+  {
+    typedef std::chrono::steady_clock Clock;
+
+  public:
+    typedef std::map<std::string,CommunicationCounters>::value_type Site;
+
+    //! Whether the communication is recorded, always true as the class only
+    //! exists if DUNE_COMMUNICATION_STATISTICS is set.
+    constexpr static bool enabled = true;
+
+    //! The statistics of this process.
+    static CommunicationStatistics& instance ()
+    {
+      static CommunicationStatistics statistics;
+      return statistics;
+    }
+
+    //! The call site with the given name, created if necessary.
+    Site& site (const std::string& name)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return *sites_.try_emplace(name).first;
+    }
+
+    //! The counters of a call site on this process.
+    CommunicationCounters counters (const std::string& name) const
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto site = sites_.find(name);
+      return site == sites_.end() ? CommunicationCounters() : site->second;
+    }
+
+    //! Resets all counters and discards the recorded trace.
+    void clear ()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto& site : sites_)
+        site.second = CommunicationCounters();
+      events_.clear();
+    }
+
+    /**
+     * @brief Whether every recorded call is kept for writeTrace().
+     *
+     * Initially true if the environment variable `DUNE_COMMUNICATION_TRACE`
+     * is set.
+     */
+    void setTracing (bool tracing)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tracing_ = tracing;
+    }
+
+    /**
+     * @brief Writes a table of the counters summed up (and the maximal
+     * times) over the processes of a communicator.
+     *
+     * This method is collective, the table is written on rank 0.
+     */
+    void report (std::ostream& os, MPI_Comm comm) const
+    {
+      const std::vector<std::string> names = allSites(comm);
+      constexpr int fields = 7;
+      std::vector<double> local(fields*names.size());
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (std::size_t i = 0; i < names.size(); ++i) {
+          auto site = sites_.find(names[i]);
+          if (site == sites_.end())
+            continue;
+          const CommunicationCounters& c = site->second;
+          double values[fields] = {double(c.calls), double(c.messages), double(c.bytes),
+                                   double(c.neighbours), c.time, c.packTime, c.waitTime};
+          std::copy(values, values+fields, local.begin()+fields*i);
+        }
+      }
+      std::vector<double> sum(local.size()), max(local.size());
+      MPI_Reduce(local.data(), sum.data(), local.size(), MPI_DOUBLE, MPI_SUM, 0, comm);
+      MPI_Reduce(local.data(), max.data(), local.size(), MPI_DOUBLE, MPI_MAX, 0, comm);
+
+      int rank, size;
+      MPI_Comm_rank(comm, &rank);
+      MPI_Comm_size(comm, &size);
+      if (rank != 0)
+        return;
+
+      std::size_t width = 4;
+      for (const auto& name : names)
+        width = std::max(width, name.size()+2);
+      const auto flags = os.flags();
+      os << "Communication statistics of " << size << " processes "
+         << "(counts summed up, times averaged / maximal over the processes in seconds):\n"
+         << std::left << std::setw(width) << "site" << std::right
+         << std::setw(10) << "calls" << std::setw(12) << "messages" << std::setw(14) << "bytes"
+         << std::setw(12) << "neighbours" << std::setw(22) << "time" << std::setw(22) << "pack"
+         << std::setw(22) << "wait" << '\n';
+      for (std::size_t i = 0; i < names.size(); ++i) {
+        const double* s = sum.data()+fields*i;
+        const double* m = max.data()+fields*i;
+        if (s[0] == 0)
+          continue;
+        os << std::left << std::setw(width) << names[i] << std::right << std::fixed
+           << std::setprecision(0) << std::setw(10) << s[0] << std::setw(12) << s[1]
+           << std::setw(14) << s[2] << std::setprecision(1) << std::setw(12)
+           << (s[0] > 0 ? s[3]/s[0] : 0.0) << std::scientific << std::setprecision(3);
+        for (int f = 4; f < fields; ++f)
+          os << std::setw(11) << s[f]/size << std::setw(11) << m[f];
+        os << '\n';
+      }
+      os.flags(flags);
+      os.flush();
+    }
+
+    /**
+     * @brief Writes the recorded calls of all processes of a
+     * communicator in the Chrome trace event format.
+     *
+     * This method is collective, the file is written by rank 0.
+     */
+    void writeTrace (const std::string& file, MPI_Comm comm) const
+    {
+      int rank, size;
+      MPI_Comm_rank(comm, &rank);
+      MPI_Comm_size(comm, &size);
+
+      std::ostringstream events;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const Event& event : events_)
+          events << ",\n{\"name\":\"" << event.site->first << "\",\"ph\":\"X\",\"pid\":" << rank
+                 << ",\"tid\":0,\"ts\":" << std::fixed << std::setprecision(3) << event.start
+                 << ",\"dur\":" << event.duration << ",\"args\":{\"messages\":" << event.messages
+                 << ",\"bytes\":" << event.bytes << "}}";
+      }
+      const std::string mine = events.str();
+      std::vector<char> all;
+      gather(mine, comm, all);
+      if (rank != 0)
+        return;
+
+      std::ofstream out(file);
+      out << "{\"traceEvents\":[\n";
+      for (int r = 0; r < size; ++r)
+        out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << r
+            << ",\"args\":{\"name\":\"rank " << r << "\"}}" << (r+1 < size ? ",\n" : "");
+      out.write(all.data(), all.size());
+      out << "\n]}\n";
+    }
+
+    /**
+     * @brief Reports the statistics on std::cout and writes the trace
+     * if requested.
+     *
+     * Called by the MPIHelper before MPI is finalized. Does nothing if
+     * nothing was recorded on any process.
+     */
+    void finalize (MPI_Comm comm) const
+    {
+      int recorded;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        recorded = std::any_of(sites_.begin(), sites_.end(),
+                               [](const Site& site){ return site.second.calls > 0; });
+      }
+      MPI_Allreduce(MPI_IN_PLACE, &recorded, 1, MPI_INT, MPI_LOR, comm);
+      if (!recorded)
+        return;
+      report(std::cout, comm);
+      if (!traceFile_.empty())
+        writeTrace(traceFile_, comm);
+    }
+
+  private:
+    friend class Impl::CommunicationScope;
+
+    struct Event
+    {
+      const Site* site;
+      double start;
+      double duration;
+      std::size_t messages;
+      std::size_t bytes;
+    };
+
+    CommunicationStatistics ()
+      : origin_(Clock::now())
+    {
+      if (const char* file = std::getenv("DUNE_COMMUNICATION_TRACE"))
+        traceFile_ = file;
+      tracing_ = !traceFile_.empty();
+    }
+
+    // Adds the counters of a finished call.
+    void record (Site& site, const CommunicationCounters& counters, Clock::time_point start)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      site.second += counters;
+      if (tracing_)
+        events_.push_back(Event{&site, seconds(start - origin_)*1e6, counters.time*1e6,
+                                counters.messages, counters.bytes});
+    }
+
+    static double seconds (Clock::duration duration)
+    {
+      return std::chrono::duration<double>(duration).count();
+    }
+
+    // Gathers the strings of all processes on rank 0.
+    static void gather (const std::string& mine, MPI_Comm comm, std::vector<char>& all)
+    {
+      int rank, size;
+      MPI_Comm_rank(comm, &rank);
+      MPI_Comm_size(comm, &size);
+      int length = mine.size();
+      std::vector<int> lengths(size), displs(size+1, 0);
+      MPI_Gather(&length, 1, MPI_INT, lengths.data(), 1, MPI_INT, 0, comm);
+      for (int r = 0; r < size; ++r)
+        displs[r+1] = displs[r] + lengths[r];
+      all.resize(displs[size]);
+      MPI_Gatherv(mine.data(), length, MPI_CHAR, all.data(), lengths.data(), displs.data(),
+                  MPI_CHAR, 0, comm);
+    }
+
+    // The sorted names of the call sites of all processes.
+    std::vector<std::string> allSites (MPI_Comm comm) const
+    {
+      std::string mine;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& site : sites_)
+          mine += site.first + '\n';
+      }
+      int length = mine.size(), size;
+      MPI_Comm_size(comm, &size);
+      std::vector<int> lengths(size), displs(size+1, 0);
+      MPI_Allgather(&length, 1, MPI_INT, lengths.data(), 1, MPI_INT, comm);
+      for (int r = 0; r < size; ++r)
+        displs[r+1] = displs[r] + lengths[r];
+      std::string all(displs[size], '\0');
+      MPI_Allgatherv(mine.data(), length, MPI_CHAR, all.data(), lengths.data(), displs.data(),
+                     MPI_CHAR, comm);
+      std::set<std::string> names;
+      std::istringstream stream(all);
+      for (std::string name; std::getline(stream, name);)
+        names.insert(name);
+      return std::vector<std::string>(names.begin(), names.end());
+    }
+
+    mutable std::mutex mutex_;
+    std::map<std::string,CommunicationCounters> sites_;
+    std::vector<Event> events_;
+    std::string traceFile_;
+    bool tracing_;
+    Clock::time_point origin_;
+  };
+
+  namespace Impl
+  {
+    //! The number of bytes of count elements of an MPI datatype.
+    inline std::size_t communicatedBytes (int count, MPI_Datatype datatype)
+    {
+      int size;
+      MPI_Type_size(datatype, &size);
+      return std::size_t(count)*size;
+    }
+
+    /**
+     * @brief Records a call of a call site from its construction to its
+     * destruction.
+     *
+     * The innermost scope of a thread receives the messages and phases
+     * recorded by the macros of communicationstatistics.hh.
+     */
+    class CommunicationScope
+    {
+      typedef std::chrono::steady_clock Clock;
+
+    public:
+      /** @brief Times a phase of the innermost scope until its destruction. */
+      class Phase
+      {
+      public:
+        Phase (double CommunicationCounters::* time)
+          : scope_(current_), time_(time)
+        {
+          if (!scope_)
+            return;
+          start_ = Clock::now();
+          outer_ = scope_->phase_;
+          if (outer_)
+            outer_->pause(start_);
+          scope_->phase_ = this;
+        }
+
+        Phase (const Phase&) = delete;
+        Phase& operator= (const Phase&) = delete;
+
+        ~Phase ()
+        {
+          if (!scope_)
+            return;
+          const Clock::time_point end = Clock::now();
+          pause(end);
+          if (outer_)
+            outer_->start_ = end;
+          scope_->phase_ = outer_;
+        }
+
+      private:
+        void pause (Clock::time_point now)
+        {
+          scope_->counters_.*time_ += std::chrono::duration<double>(now - start_).count();
+        }
+
+        CommunicationScope* scope_;
+        double CommunicationCounters::* time_;
+        Phase* outer_ = nullptr;
+        Clock::time_point start_;
+      };
+
+      explicit CommunicationScope (CommunicationStatistics::Site& site)
+        : site_(site), outer_(current_), start_(Clock::now())
+      {
+        counters_.calls = 1;
+        current_ = this;
+      }
+
+      CommunicationScope (const CommunicationScope&) = delete;
+      CommunicationScope& operator= (const CommunicationScope&) = delete;
+
+      ~CommunicationScope ()
+      {
+        counters_.time = std::chrono::duration<double>(Clock::now() - start_).count();
+        current_ = outer_;
+        CommunicationStatistics::instance().record(site_, counters_, start_);
+      }
+
+      //! Records a message sent by the innermost scope, if any.
+      static void message (std::size_t bytes)
+      {
+        if (current_) {
+          ++current_->counters_.messages;
+          current_->counters_.bytes += bytes;
+        }
+      }
+
+      //! Records the number of neighbours of the innermost scope, if any.
+      static void neighbours (std::size_t neighbours)
+      {
+        if (current_)
+          current_->counters_.neighbours += neighbours;
+      }
+
+    private:
+      CommunicationStatistics::Site& site_;
+      CommunicationScope* outer_;
+      Phase* phase_ = nullptr;
+      Clock::time_point start_;
+      CommunicationCounters counters_;
+      inline static thread_local CommunicationScope* current_ = nullptr;
+    };
+  } // end namespace Impl
+} // end namespace Dune
+
+#endif // DUNE_COMMUNICATION_STATISTICS && HAVE_MPI
+
+#define DUNE_COMMUNICATION_CONCAT_(a, b) a ## b
+#define DUNE_COMMUNICATION_CONCAT(a, b) DUNE_COMMUNICATION_CONCAT_(a, b)
+
+#if DUNE_COMMUNICATION_STATISTICS && HAVE_MPI
+/** @brief Records the enclosing block as a call of the call site with the given name. */
+#define DUNE_COMMUNICATION_SCOPE(name)                                  \
+  static auto& DUNE_COMMUNICATION_CONCAT(duneCommunicationSite, __LINE__) = \
+    Dune::CommunicationStatistics::instance().site(name);               \
+  Dune::Impl::CommunicationScope DUNE_COMMUNICATION_CONCAT(duneCommunicationScope, __LINE__) \
+    (DUNE_COMMUNICATION_CONCAT(duneCommunicationSite, __LINE__))
+/** @brief Records a message of the given number of bytes. */
+#define DUNE_COMMUNICATION_MESSAGE(bytes)                       \
+  Dune::Impl::CommunicationScope::message(bytes)
+/** @brief Records the number of neighbours communicated with. */
+#define DUNE_COMMUNICATION_NEIGHBOURS(count)                    \
+  Dune::Impl::CommunicationScope::neighbours(count)
+/** @brief Records the rest of the enclosing block as packing or unpacking. */
+#define DUNE_COMMUNICATION_PACK_PHASE                                   \
+  Dune::Impl::CommunicationScope::Phase DUNE_COMMUNICATION_CONCAT(duneCommunicationPhase, __LINE__) \
+    (&Dune::CommunicationCounters::packTime)
+/** @brief Records the rest of the enclosing block as waiting for communication. */
+#define DUNE_COMMUNICATION_WAIT_PHASE                                   \
+  Dune::Impl::CommunicationScope::Phase DUNE_COMMUNICATION_CONCAT(duneCommunicationPhase, __LINE__) \
+    (&Dune::CommunicationCounters::waitTime)
+#else
+#define DUNE_COMMUNICATION_SCOPE(name) do {} while(false)
+#define DUNE_COMMUNICATION_MESSAGE(bytes) do {} while(false)
+#define DUNE_COMMUNICATION_NEIGHBOURS(count) do {} while(false)
+#define DUNE_COMMUNICATION_PACK_PHASE do {} while(false)
+#define DUNE_COMMUNICATION_WAIT_PHASE do {} while(false)
+#endif
+
+#endif // DUNE_COMMON_PARALLEL_COMMUNICATIONSTATISTICS_HH
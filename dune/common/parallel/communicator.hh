@@ -7,16 +7,20 @@
 
 #if HAVE_MPI
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <iostream>
 #include <map>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <mpi.h>
 
 #include <dune/common/exceptions.hh>
+#include <dune/common/parallel/communicationstatistics.hh>
+#include <dune/common/parallel/future.hh>
 #include <dune/common/parallel/interface.hh>
 #include <dune/common/parallel/remoteindices.hh>
 #include <dune/common/stdstreams.hh>
@@ -254,6 +258,17 @@ namespace Dune
      */
     DatatypeCommunicator();
 
+    /**
+     * @brief Creates a new DatatypeCommunicator.
+     *
+     * @param backend The MPI calls used for the communication. For
+     * CommunicationBackend::neighborhoodCollective build() creates a
+     * distributed graph topology of the neighbouring processes and each
+     * communication is a single call to MPI_Neighbor_alltoallw with the
+     * created datatypes.
+     */
+    explicit DatatypeCommunicator(CommunicationBackend backend);
+
     /**
      * @brief Destructor.
      */
@@ -298,6 +313,125 @@ namespace Dune
      */
     void backward();
 
+    /**
+     * @brief Handle of a communication started by forwardBegin() or backwardBegin().
+     *
+     * Models the interface of Dune::Future<void>, i.e. it can be wrapped
+     * into a Dune::Future. As the values are received directly into the
+     * data, no scattering is needed on completion. Waiting for the
+     * completion includes a collective error check, therefore
+     * wait() or get() has to be called on all processes.
+     */
+    class Exchange
+    {
+      friend class DatatypeCommunicator;
+
+      Exchange(DatatypeCommunicator& communicator, int index)
+        : communicator_(&communicator), index_(index), valid_(true)
+      {}
+
+    public:
+      /** @brief Constructs an invalid handle. */
+      Exchange()
+        : communicator_(nullptr), index_(0), valid_(false)
+      {}
+
+      Exchange(Exchange&& other)
+        : communicator_(std::exchange(other.communicator_, nullptr)),
+          index_(other.index_),
+          valid_(std::exchange(other.valid_, false))
+      {}
+
+      Exchange& operator=(Exchange&& other)
+      {
+        complete();
+        communicator_ = std::exchange(other.communicator_, nullptr);
+        index_ = other.index_;
+        valid_ = std::exchange(other.valid_, false);
+        return *this;
+      }
+
+      /** @brief Completes a pending communication. */
+      ~Exchange()
+      {
+        complete();
+      }
+
+      /** @brief Wait for the completion of the communication. */
+      void wait()
+      {
+        if(!valid_)
+          DUNE_THROW(InvalidFutureException, "The exchange is not valid");
+        complete();
+      }
+
+      /**
+       * @brief Test whether all messages have been sent and received.
+       *
+       * The communication still has to be completed by wait() or get().
+       */
+      bool ready() const
+      {
+        if(!valid_)
+          DUNE_THROW(InvalidFutureException, "The exchange is not valid");
+        return !communicator_ || communicator_->testRequests(index_);
+      }
+
+      /** @brief Whether the handle belongs to a communication. */
+      bool valid() const
+      {
+        return valid_;
+      }
+
+      /** @brief Wait for the completion and invalidate the handle. */
+      void get()
+      {
+        wait();
+        valid_ = false;
+      }
+
+    private:
+      void complete()
+      {
+        if(communicator_)
+          std::exchange(communicator_, nullptr)->finishRequests(index_);
+      }
+
+      DatatypeCommunicator* communicator_;
+      int index_;
+      bool valid_;
+    };
+
+    /**
+     * @brief Starts sending the primitive values from the source to the destination.
+     *
+     * The communication is completed by forwardEnd(). In between the
+     * sent values must not be changed and the received values must not
+     * be accessed. Only one communication can be in progress at a time.
+     *
+     * @return The handle to complete the communication with.
+     */
+    Exchange forwardBegin();
+
+    /**
+     * @brief Completes a communication started by forwardBegin().
+     */
+    void forwardEnd(Exchange& exchange);
+
+    /**
+     * @brief Starts sending the primitive values from the destination to the source.
+     *
+     * The communication is completed by backwardEnd().
+     * @see forwardBegin()
+     * @return The handle to complete the communication with.
+     */
+    Exchange backwardBegin();
+
+    /**
+     * @brief Completes a communication started by backwardBegin().
+     */
+    void backwardEnd(Exchange& exchange);
+
     /**
      * @brief Deallocates the MPI requests and data types.
      */
@@ -326,6 +460,11 @@ namespace Dune
      */
     void* data_;
 
+    /**
+     * @brief The requests for the backward (index 0) and forward (index 1) communication.
+     *
+     * For the neighbourhood collectives there is one request per direction.
+     */
     MPI_Request* requests_[2];
 
     /**
@@ -333,6 +472,39 @@ namespace Dune
      */
     bool created_;
 
+    /**
+     * @brief The MPI calls used for the communication.
+     */
+    CommunicationBackend backend_;
+
+    /**
+     * @brief The distributed graph communicator for the neighbourhood collectives.
+     */
+    MPI_Comm neighborhoodCommunicator_;
+
+    /**
+     * @brief The address of the send (index 0) and receive data (index 1) of a forward communication.
+     */
+    void* addresses_[2];
+
+    /**
+     * @brief The datatypes of the messages of the send (index 0) and receive data
+     * (index 1) of a forward communication for each neighbour of the graph communicator.
+     */
+    std::vector<MPI_Datatype> neighborTypes_[2];
+
+    /**
+     * @brief The number of datatypes (one) and their displacement (zero) for each neighbour.
+     */
+    std::vector<int> neighborCounts_;
+    std::vector<MPI_Aint> neighborDispls_;
+
+    /**
+     * @brief Creates the graph communicator for the neighbourhood collectives.
+     */
+    template<class V>
+    void createNeighborhood(V& sendData, V& receiveData);
+
     /**
      * @brief Creates the MPI_Requests for the forward communication.
      */
@@ -347,8 +519,27 @@ namespace Dune
 
     /**
      * @brief Initiates the sending and receive.
+     * @param index 1 for forward and 0 for backward communication.
+     */
+    void sendRecv(int index);
+
+    /**
+     * @brief Starts the requests for receiving and sending.
+     * @param index 1 for forward and 0 for backward communication.
+     */
+    void startRequests(int index);
+
+    /**
+     * @brief Tests whether the started requests completed.
+     * @param index 1 for forward and 0 for backward communication.
+     */
+    bool testRequests(int index);
+
+    /**
+     * @brief Waits for the completion of the started requests and checks for errors.
+     * @param index 1 for forward and 0 for backward communication.
      */
-    void sendRecv(MPI_Request* req);
+    void finishRequests(int index);
 
     /**
      * @brief Information used for setting up the MPI Datatypes.
@@ -453,6 +644,24 @@ namespace Dune
    * then that buffer is sent.
    * The data is received in another buffer and then copied to the actual
    * position.
+   *
+   * If the same interface is used for many communications, the communicator
+   * can be constructed in persistent mode. Then the persistent MPI requests for
+   * sending and receiving the buffers are set up once during build and only
+   * started and completed by each forward and backward call.
+   *
+   * To overlap the communication with computations, it can be split into
+   * two phases by forwardBegin() and forwardEnd() (or backwardBegin() and
+   * backwardEnd() respectively).
+   *
+   * Alternatively the buffers can be exchanged by neighbourhood collectives
+   * (MPI_Neighbor_alltoallv) on a distributed graph topology that is created
+   * once during build, see CommunicationBackend.
+   *
+   * During build the runs of consecutive local indices in the interface are
+   * determined. If the values are copied by CopyGatherScatter from a container
+   * with contiguous storage (i.e. with a method data()) of trivially copyable
+   * values, whole runs are copied to and from the buffers at once.
    */
   class BufferedCommunicator
   {
@@ -463,6 +672,26 @@ namespace Dune
      */
     BufferedCommunicator();
 
+    /**
+     * @brief Constructor.
+     *
+     * @param persistent If true, persistent requests (MPI_Send_init and MPI_Recv_init)
+     * are created by build() and reused by all calls to forward and backward.
+     */
+    explicit BufferedCommunicator(bool persistent);
+
+    /**
+     * @brief Constructor.
+     *
+     * @param backend The MPI calls used for exchanging the buffers. For
+     * CommunicationBackend::neighborhoodCollective build() creates a distributed
+     * graph topology from the interface and therefore has to be called
+     * collectively. Each forward or backward call is then a single call to
+     * MPI_Neighbor_alltoallv (or MPI_Ineighbor_alltoallv for the split phase
+     * communication).
+     */
+    explicit BufferedCommunicator(CommunicationBackend backend);
+
     /**
      * @brief Build the buffers and information for the communication process.
      *
@@ -601,6 +830,166 @@ namespace Dune
     template<class GatherScatter, class Data>
     void backward(Data& data);
 
+    /**
+     * @brief Handle of a communication started by forwardBegin() or backwardBegin().
+     *
+     * Models the interface of Dune::Future<void>, i.e. it can be wrapped
+     * into a Dune::Future. The received messages are scattered into the
+     * target while testing with ready() and when waiting for the
+     * completion. If the handle is destroyed before, the communication
+     * is completed by the destructor.
+     *
+     * @tparam GatherScatter The functor for gathering and scattering the values.
+     * @tparam FORWARD True for a forward communication.
+     * @tparam Data The type of the data communicated.
+     */
+    template<class GatherScatter, bool FORWARD, class Data>
+    class Exchange
+    {
+      friend class BufferedCommunicator;
+
+      Exchange(BufferedCommunicator& communicator, Data& target)
+        : communicator_(&communicator), target_(&target), valid_(true)
+      {}
+
+    public:
+      /** @brief Constructs an invalid handle. */
+      Exchange()
+        : communicator_(nullptr), target_(nullptr), valid_(false)
+      {}
+
+      Exchange(Exchange&& other)
+        : communicator_(std::exchange(other.communicator_, nullptr)),
+          target_(std::exchange(other.target_, nullptr)),
+          valid_(std::exchange(other.valid_, false))
+      {}
+
+      Exchange& operator=(Exchange&& other)
+      {
+        complete();
+        communicator_ = std::exchange(other.communicator_, nullptr);
+        target_ = std::exchange(other.target_, nullptr);
+        valid_ = std::exchange(other.valid_, false);
+        return *this;
+      }
+
+      /** @brief Completes a pending communication. */
+      ~Exchange()
+      {
+        complete();
+      }
+
+      /** @brief Wait for all messages and scatter them into the target. */
+      void wait()
+      {
+        if(!valid_)
+          DUNE_THROW(InvalidFutureException, "The exchange is not valid");
+        complete();
+      }
+
+      /**
+       * @brief Scatter the messages received so far.
+       * @return True if the communication is complete.
+       */
+      bool ready() const
+      {
+        if(!valid_)
+          DUNE_THROW(InvalidFutureException, "The exchange is not valid");
+        if(communicator_
+           && communicator_->template progressSendRecv<GatherScatter,FORWARD>(*target_, false))
+          complete();
+        return !communicator_;
+      }
+
+      /** @brief Whether the handle belongs to a communication. */
+      bool valid() const
+      {
+        return valid_;
+      }
+
+      /** @brief Wait for the completion and invalidate the handle. */
+      void get()
+      {
+        wait();
+        valid_ = false;
+      }
+
+    private:
+      void complete() const
+      {
+        if(communicator_)
+          std::exchange(communicator_, nullptr)->template finishSendRecv<GatherScatter,FORWARD>(*target_);
+      }
+
+      mutable BufferedCommunicator* communicator_;
+      Data* target_;
+      bool valid_;
+    };
+
+    /**
+     * @brief Start sending from source to target.
+     *
+     * The values are gathered from the source immediately. The received
+     * values are scattered into the target when the communication is
+     * tested or completed with the returned handle, e.g. by forwardEnd().
+     * Until then the entries of the target that are received must not be
+     * accessed. Meanwhile computations not depending on them can overlap
+     * the communication. Only one communication of a communicator can be
+     * in progress at a time.
+     *
+     * @see forward(const Data&, Data&)
+     * @param source The values will be copied from here to the send buffers.
+     * @param dest The received values will be copied to here.
+     * @return The handle to complete the communication with.
+     */
+    template<class GatherScatter, class Data>
+    Exchange<GatherScatter,true,Data> forwardBegin(const Data& source, Data& dest);
+
+    /**
+     * @brief Start a forward send where target and source are the same.
+     *
+     * @see forwardBegin(const Data&, Data&)
+     * @param data Source and target of the communication.
+     * @return The handle to complete the communication with.
+     */
+    template<class GatherScatter, class Data>
+    Exchange<GatherScatter,true,Data> forwardBegin(Data& data);
+
+    /**
+     * @brief Complete a communication started by forwardBegin().
+     * @param exchange The handle returned by forwardBegin().
+     */
+    template<class GatherScatter, class Data>
+    void forwardEnd(Exchange<GatherScatter,true,Data>& exchange);
+
+    /**
+     * @brief Start communicating in the reverse direction, i.e. send from target to source.
+     *
+     * @see forwardBegin(const Data&, Data&)
+     * @param source The received values will be copied to here.
+     * @param dest The values will be copied from here to the send buffers.
+     * @return The handle to complete the communication with.
+     */
+    template<class GatherScatter, class Data>
+    Exchange<GatherScatter,false,Data> backwardBegin(Data& source, const Data& dest);
+
+    /**
+     * @brief Start a backward send where target and source are the same.
+     *
+     * @see forwardBegin(const Data&, Data&)
+     * @param data Source and target of the communication.
+     * @return The handle to complete the communication with.
+     */
+    template<class GatherScatter, class Data>
+    Exchange<GatherScatter,false,Data> backwardBegin(Data& data);
+
+    /**
+     * @brief Complete a communication started by backwardBegin().
+     * @param exchange The handle returned by backwardBegin().
+     */
+    template<class GatherScatter, class Data>
+    void backwardEnd(Exchange<GatherScatter,false,Data>& exchange);
+
     /**
      * @brief Free the allocated memory (i.e. buffers and message information.
      */
@@ -878,12 +1267,180 @@ namespace Dune
 
     MPI_Comm communicator_;
 
+    /**
+     * @brief Whether persistent requests are used for the communication.
+     */
+    bool persistent_;
+
+    /**
+     * @brief The MPI calls used for the communication.
+     */
+    CommunicationBackend backend_;
+
+    /**
+     * @brief The distributed graph communicator for the neighbourhood collectives.
+     */
+    MPI_Comm neighborhoodCommunicator_;
+
+    /**
+     * @brief The number of bytes to exchange with each neighbour of
+     * the graph communicator from buffer 0 and buffer 1.
+     */
+    std::vector<int> neighborCounts_[2];
+
+    /**
+     * @brief The displacements in bytes of the messages of each neighbour
+     * of the graph communicator in buffer 0 and buffer 1.
+     */
+    std::vector<int> neighborDispls_[2];
+
+    /**
+     * @brief Create the graph communicator and the message layout for the
+     * neighbourhood collectives.
+     * @param valueSize The size of one value in the buffers in bytes.
+     */
+    inline void createNeighborhood(std::size_t valueSize);
+
+    /**
+     * @brief Free the graph communicator.
+     */
+    inline void freeNeighborhood();
+
+    /**
+     * @brief Requests for the messages in one direction.
+     */
+    struct Requests
+    {
+      /** @brief The requests, first for receiving then for sending. */
+      std::vector<MPI_Request> requests;
+      /** @brief The rank of the process each receive request is for. */
+      std::vector<int> processes;
+      /** @brief The number of receive requests. */
+      std::size_t receives = 0;
+    };
+
+    /**
+     * @brief The persistent requests for the forward (index 0) and backward
+     * (index 1) communication.
+     */
+    Requests persistentRequests_[2];
+
+    /**
+     * @brief Create the persistent requests for both directions.
+     * @param valueSize The size of one value in the buffers in bytes.
+     */
+    inline void createPersistentRequests(std::size_t valueSize);
+
+    /**
+     * @brief Free the persistent requests.
+     */
+    inline void freePersistentRequests();
+
+    /**
+     * @brief The requests for non-persistent communication.
+     */
+    Requests requests_;
+
+    /**
+     * @brief The requests of the communication in progress.
+     *
+     * Null if no communication is in progress.
+     */
+    Requests* active_;
+
+    /**
+     * @brief The number of messages of the communication in progress that
+     * still need to be received and scattered.
+     */
+    std::size_t pendingReceives_;
+
+    /**
+     * @brief Indices of the completed receive requests.
+     */
+    std::vector<int> completed_;
+
+    /**
+     * @brief A run of consecutive local indices in an interface.
+     */
+    struct Run
+    {
+      /** @brief The first local index. */
+      std::size_t local;
+      /** @brief The number of indices. */
+      std::size_t length;
+    };
+
+    /**
+     * @brief The runs of the send (first) and receive (second) indices of the
+     * interface to each process.
+     */
+    std::map<int,std::pair<std::vector<Run>,std::vector<Run> > > runs_;
+
+    /**
+     * @brief Determine the runs of consecutive indices of the interface.
+     */
+    inline void createRuns();
+
+    /**
+     * @brief Whether the values can be copied run-wise between the data and the buffers.
+     *
+     * True if GatherScatter is the CopyGatherScatter of the data, the data
+     * provides its contiguous storage by data() and the values are trivially
+     * copyable.
+     */
+    template<class Data, class GatherScatter, class = void>
+    struct IsRunCopyable
+      : std::false_type
+    {};
+
+    template<class Data>
+    struct IsRunCopyable<Data,CopyGatherScatter<Data>,
+                         std::enable_if_t<std::is_same<SizeOne,typename CommPolicy<Data>::IndexedTypeFlag>::value
+                                          && std::is_trivially_copyable<typename CommPolicy<Data>::IndexedType>::value
+                                          && std::is_same<decltype(std::declval<const Data&>().data()),
+                                                          const typename CommPolicy<Data>::IndexedType*>::value> >
+      : std::true_type
+    {};
+
+    /**
+     * @brief Gather the values of all messages into the send buffer.
+     */
+    template<class GatherScatter, bool FORWARD, class Data>
+    void gather(const Data& source, typename CommPolicy<Data>::IndexedType* buffer);
+
+    /**
+     * @brief Scatter the values of the message of a process from the receive buffer.
+     */
+    template<class GatherScatter, bool FORWARD, class Data>
+    void scatter(Data& target, typename CommPolicy<Data>::IndexedType* buffer, int proc);
+
     /**
      * @brief Send and receive Data.
      */
     template<class GatherScatter, bool FORWARD, class Data>
     void sendRecv(const Data& source, Data& target);
 
+    /**
+     * @brief Gather the data into the send buffer and start the requests.
+     */
+    template<class GatherScatter, bool FORWARD, class Data>
+    void startSendRecv(const Data& source);
+
+    /**
+     * @brief Scatter the messages received so far.
+     * @param target The data to scatter to.
+     * @param wait If true wait for all messages, otherwise only test for them.
+     * @return True if all messages have been received and sent.
+     */
+    template<class GatherScatter, bool FORWARD, class Data>
+    bool progressSendRecv(Data& target, bool wait);
+
+    /**
+     * @brief Wait for the remaining messages of the communication in progress.
+     */
+    template<class GatherScatter, bool FORWARD, class Data>
+    void finishSendRecv(Data& target);
+
   };
 
 #ifndef DOXYGEN
@@ -926,7 +1483,13 @@ namespace Dune
 
   template<typename T>
   DatatypeCommunicator<T>::DatatypeCommunicator()
-    : remoteIndices_(0), created_(false)
+    : DatatypeCommunicator(CommunicationBackend::pointToPoint)
+  {}
+
+  template<typename T>
+  DatatypeCommunicator<T>::DatatypeCommunicator(CommunicationBackend backend)
+    : remoteIndices_(0), created_(false), backend_(backend),
+      neighborhoodCommunicator_(MPI_COMM_NULL)
   {
     requests_[0]=0;
     requests_[1]=0;
@@ -950,8 +1513,12 @@ namespace Dune
     free();
     createDataTypes<T1,T2,V,false>(source,destination, receiveData);
     createDataTypes<T1,T2,V,true>(source,destination, sendData);
-    createRequests<V,true>(sendData, receiveData);
-    createRequests<V,false>(receiveData, sendData);
+    if(backend_ == CommunicationBackend::neighborhoodCollective)
+      createNeighborhood(sendData, receiveData);
+    else{
+      createRequests<V,true>(sendData, receiveData);
+      createRequests<V,false>(receiveData, sendData);
+    }
     created_=true;
   }
 
@@ -977,6 +1544,15 @@ namespace Dune
           MPI_Type_free(type);
       }
       messageTypes.clear();
+      if(neighborhoodCommunicator_ != MPI_COMM_NULL) {
+        int finalized=0;
+        MPI_Finalized(&finalized);
+        if(!finalized)
+          MPI_Comm_free(&neighborhoodCommunicator_);
+        neighborhoodCommunicator_ = MPI_COMM_NULL;
+      }
+      neighborTypes_[0].clear();
+      neighborTypes_[1].clear();
       created_=false;
     }
 
@@ -1046,26 +1622,116 @@ namespace Dune
     }
   }
 
+  template<typename T>
+  template<class V>
+  void DatatypeCommunicator<T>::createNeighborhood(V& sendData, V& receiveData)
+  {
+    neighborhoodCommunicator_ = Impl::createNeighborhoodCommunicator(this->remoteIndices_->communicator(),
+                                                                     messageTypes);
+    // The neighbours of the graph are the keys of messageTypes in ascending order
+    for(const auto& process : messageTypes) {
+      neighborTypes_[0].push_back(process.second.first);
+      neighborTypes_[1].push_back(process.second.second);
+    }
+    neighborCounts_.assign(messageTypes.size(), 1);
+    neighborDispls_.assign(messageTypes.size(), 0);
+    addresses_[0] = const_cast<void*>(CommPolicy<V>::getAddress(sendData, 0));
+    addresses_[1] = const_cast<void*>(CommPolicy<V>::getAddress(receiveData, 0));
+    requests_[0] = new MPI_Request[1];
+    requests_[1] = new MPI_Request[1];
+  }
+
   template<typename T>
   void DatatypeCommunicator<T>::forward()
   {
-    sendRecv(requests_[1]);
+    sendRecv(1);
   }
 
   template<typename T>
   void DatatypeCommunicator<T>::backward()
   {
-    sendRecv(requests_[0]);
+    sendRecv(0);
+  }
+
+  template<typename T>
+  typename DatatypeCommunicator<T>::Exchange DatatypeCommunicator<T>::forwardBegin()
+  {
+    startRequests(1);
+    return Exchange(*this, 1);
   }
 
   template<typename T>
-  void DatatypeCommunicator<T>::sendRecv(MPI_Request* requests)
+  void DatatypeCommunicator<T>::forwardEnd(Exchange& exchange)
   {
+    exchange.get();
+  }
+
+  template<typename T>
+  typename DatatypeCommunicator<T>::Exchange DatatypeCommunicator<T>::backwardBegin()
+  {
+    startRequests(0);
+    return Exchange(*this, 0);
+  }
+
+  template<typename T>
+  void DatatypeCommunicator<T>::backwardEnd(Exchange& exchange)
+  {
+    exchange.get();
+  }
+
+  template<typename T>
+  void DatatypeCommunicator<T>::sendRecv(int index)
+  {
+    startRequests(index);
+    finishRequests(index);
+  }
+
+  template<typename T>
+  void DatatypeCommunicator<T>::startRequests(int index)
+  {
+    if(backend_ == CommunicationBackend::neighborhoodCollective) {
+      // In a forward communication we send from the send data using its datatypes
+      const int send = index==1 ? 0 : 1;
+      const int recv = 1-send;
+      MPI_Ineighbor_alltoallw(addresses_[send], neighborCounts_.data(), neighborDispls_.data(),
+                              neighborTypes_[send].data(),
+                              addresses_[recv], neighborCounts_.data(), neighborDispls_.data(),
+                              neighborTypes_[recv].data(),
+                              neighborhoodCommunicator_, requests_[index]);
+      return;
+    }
+
+    MPI_Request* requests = requests_[index];
     int noMessages = messageTypes.size();
     // Start the receive calls first
     MPI_Startall(noMessages, requests);
     // Now the send calls
     MPI_Startall(noMessages, requests+noMessages);
+  }
+
+  template<typename T>
+  bool DatatypeCommunicator<T>::testRequests(int index)
+  {
+    int count = backend_ == CommunicationBackend::neighborhoodCollective ? 1 : 2*messageTypes.size();
+    int flag;
+    MPI_Testall(count, requests_[index], &flag, MPI_STATUSES_IGNORE);
+    return flag;
+  }
+
+  template<typename T>
+  void DatatypeCommunicator<T>::finishRequests(int index)
+  {
+    if(backend_ == CommunicationBackend::neighborhoodCollective) {
+      int success = MPI_Wait(requests_[index], MPI_STATUS_IGNORE)==MPI_SUCCESS;
+      int globalSuccess=0;
+      MPI_Allreduce(&success, &globalSuccess, 1, MPI_INT, MPI_MIN, this->remoteIndices_->communicator());
+      if(!globalSuccess)
+        DUNE_THROW(CommunicationError, "A communication error occurred!");
+      return;
+    }
+
+    MPI_Request* requests = requests_[index];
+    int noMessages = messageTypes.size();
 
     // Wait for completion of the communication send first then receive
     MPI_Status* status=new MPI_Status[2*noMessages];
@@ -1123,6 +1789,22 @@ namespace Dune
   }
 
   inline BufferedCommunicator::BufferedCommunicator()
+    : BufferedCommunicator(false)
+  {}
+
+  inline BufferedCommunicator::BufferedCommunicator(bool persistent)
+    : persistent_(persistent), backend_(CommunicationBackend::pointToPoint),
+      neighborhoodCommunicator_(MPI_COMM_NULL), active_(nullptr), pendingReceives_(0)
+  {
+    buffers_[0]=0;
+    buffers_[1]=0;
+    bufferSize_[0]=0;
+    bufferSize_[1]=0;
+  }
+
+  inline BufferedCommunicator::BufferedCommunicator(CommunicationBackend backend)
+    : persistent_(false), backend_(backend),
+      neighborhoodCommunicator_(MPI_COMM_NULL), active_(nullptr), pendingReceives_(0)
   {
     buffers_[0]=0;
     buffers_[1]=0;
@@ -1134,8 +1816,10 @@ namespace Dune
   typename std::enable_if<std::is_same<SizeOne, typename CommPolicy<Data>::IndexedTypeFlag>::value, void>::type
   BufferedCommunicator::build(const Interface& interface)
   {
+    free();
     interfaces_=interface.interfaces();
     communicator_=interface.communicator();
+    createRuns();
     typedef typename std::map<int,std::pair<InterfaceInformation,InterfaceInformation> >
     ::const_iterator const_iterator;
     typedef typename CommPolicy<Data>::IndexedTypeFlag Flag;
@@ -1166,14 +1850,20 @@ namespace Dune
 
     buffers_[0] = new char[bufferSize_[0]];
     buffers_[1] = new char[bufferSize_[1]];
+
+    if(persistent_)
+      createPersistentRequests(sizeof(typename CommPolicy<Data>::IndexedType));
+    if(backend_ == CommunicationBackend::neighborhoodCollective)
+      createNeighborhood(sizeof(typename CommPolicy<Data>::IndexedType));
   }
 
   template<class Data, class Interface>
   void BufferedCommunicator::build(const Data& source, const Data& dest, const Interface& interface)
   {
-
+    free();
     interfaces_=interface.interfaces();
     communicator_=interface.communicator();
+    createRuns();
     typedef typename std::map<int,std::pair<InterfaceInformation,InterfaceInformation> >
     ::const_iterator const_iterator;
     typedef typename CommPolicy<Data>::IndexedTypeFlag Flag;
@@ -1201,10 +1891,121 @@ namespace Dune
     // allocate the buffers
     buffers_[0] = new char[bufferSize_[0]];
     buffers_[1] = new char[bufferSize_[1]];
+
+    if(persistent_)
+      createPersistentRequests(sizeof(typename CommPolicy<Data>::IndexedType));
+    if(backend_ == CommunicationBackend::neighborhoodCollective)
+      createNeighborhood(sizeof(typename CommPolicy<Data>::IndexedType));
+  }
+
+  inline void BufferedCommunicator::createPersistentRequests(std::size_t valueSize)
+  {
+    for(int direction=0; direction<2; ++direction) {
+      // In a forward communication we send from buffer 0 and receive into buffer 1
+      const bool forward = (direction==0);
+      char* sendBuffer = buffers_[forward ? 0 : 1];
+      char* recvBuffer = buffers_[forward ? 1 : 0];
+      Requests& persistent = persistentRequests_[direction];
+      persistent.requests.reserve(2*messageInformation_.size());
+
+      // Setup receive first
+      for(const auto& info : messageInformation_) {
+        const MessageInformation& recvInfo = forward ? info.second.second : info.second.first;
+        if(recvInfo.size_) {
+          persistent.requests.emplace_back();
+          MPI_Recv_init(recvBuffer+recvInfo.start_*valueSize, recvInfo.size_,
+                        MPI_BYTE, info.first, commTag_, communicator_,
+                        &persistent.requests.back());
+          persistent.processes.push_back(info.first);
+        }
+      }
+      persistent.receives = persistent.requests.size();
+
+      // now the send requests
+      for(const auto& info : messageInformation_) {
+        const MessageInformation& sendInfo = forward ? info.second.first : info.second.second;
+        if(sendInfo.size_) {
+          persistent.requests.emplace_back();
+          MPI_Send_init(sendBuffer+sendInfo.start_*valueSize, sendInfo.size_,
+                        MPI_BYTE, info.first, commTag_, communicator_,
+                        &persistent.requests.back());
+        }
+      }
+    }
+  }
+
+  inline void BufferedCommunicator::freePersistentRequests()
+  {
+    int finalized=0;
+    MPI_Finalized(&finalized);
+    for(Requests& persistent : persistentRequests_) {
+      if(!finalized)
+        for(MPI_Request& request : persistent.requests)
+          MPI_Request_free(&request);
+      persistent.requests.clear();
+      persistent.processes.clear();
+      persistent.receives = 0;
+    }
+  }
+
+  inline void BufferedCommunicator::createNeighborhood(std::size_t valueSize)
+  {
+    neighborhoodCommunicator_ = Impl::createNeighborhoodCommunicator(communicator_, interfaces_);
+
+    // The neighbours of the graph are the processes of the interface in ascending order
+    for(int buffer=0; buffer<2; ++buffer) {
+      neighborCounts_[buffer].assign(interfaces_.size(), 0);
+      neighborDispls_[buffer].assign(interfaces_.size(), 0);
+    }
+    std::size_t neighbour=0;
+    for(const auto& interfacePair : interfaces_) {
+      typename InformationMap::const_iterator info = messageInformation_.find(interfacePair.first);
+      if(info != messageInformation_.end()) {
+        neighborCounts_[0][neighbour] = info->second.first.size_;
+        neighborDispls_[0][neighbour] = info->second.first.start_*valueSize;
+        neighborCounts_[1][neighbour] = info->second.second.size_;
+        neighborDispls_[1][neighbour] = info->second.second.start_*valueSize;
+      }
+      ++neighbour;
+    }
+  }
+
+  inline void BufferedCommunicator::createRuns()
+  {
+    runs_.clear();
+    auto findRuns = [](const InterfaceInformation& info, std::vector<Run>& runs) {
+      for(std::size_t i=0; i<info.size(); ++i)
+        if(!runs.empty() && runs.back().local+runs.back().length==info[i])
+          ++runs.back().length;
+        else
+          runs.push_back(Run{info[i], 1});
+    };
+    for(const auto& interfacePair : interfaces_) {
+      auto& runs = runs_[interfacePair.first];
+      findRuns(interfacePair.second.first, runs.first);
+      findRuns(interfacePair.second.second, runs.second);
+    }
+  }
+
+  inline void BufferedCommunicator::freeNeighborhood()
+  {
+    if(neighborhoodCommunicator_ != MPI_COMM_NULL) {
+      int finalized=0;
+      MPI_Finalized(&finalized);
+      if(!finalized)
+        MPI_Comm_free(&neighborhoodCommunicator_);
+      neighborhoodCommunicator_ = MPI_COMM_NULL;
+    }
+    for(int buffer=0; buffer<2; ++buffer) {
+      neighborCounts_[buffer].clear();
+      neighborDispls_[buffer].clear();
+    }
   }
 
   inline void BufferedCommunicator::free()
   {
+    freePersistentRequests();
+    freeNeighborhood();
     messageInformation_.clear();
     if(buffers_[0])
       delete[] buffers_[0];
@@ -1375,153 +2176,263 @@ namespace Dune
   }
 
 
+  template<class GatherScatter, class Data>
+  BufferedCommunicator::Exchange<GatherScatter,true,Data>
+  BufferedCommunicator::forwardBegin(const Data& source, Data& dest)
+  {
+    this->template startSendRecv<GatherScatter,true>(source);
+    return Exchange<GatherScatter,true,Data>(*this, dest);
+  }
+
+  template<class GatherScatter, class Data>
+  BufferedCommunicator::Exchange<GatherScatter,true,Data>
+  BufferedCommunicator::forwardBegin(Data& data)
+  {
+    return this->template forwardBegin<GatherScatter>(data, data);
+  }
+
+  template<class GatherScatter, class Data>
+  void BufferedCommunicator::forwardEnd(Exchange<GatherScatter,true,Data>& exchange)
+  {
+    exchange.get();
+  }
+
+  template<class GatherScatter, class Data>
+  BufferedCommunicator::Exchange<GatherScatter,false,Data>
+  BufferedCommunicator::backwardBegin(Data& source, const Data& dest)
+  {
+    this->template startSendRecv<GatherScatter,false>(dest);
+    return Exchange<GatherScatter,false,Data>(*this, source);
+  }
+
+  template<class GatherScatter, class Data>
+  BufferedCommunicator::Exchange<GatherScatter,false,Data>
+  BufferedCommunicator::backwardBegin(Data& data)
+  {
+    return this->template backwardBegin<GatherScatter>(data, data);
+  }
+
+  template<class GatherScatter, class Data>
+  void BufferedCommunicator::backwardEnd(Exchange<GatherScatter,false,Data>& exchange)
+  {
+    exchange.get();
+  }
+
   template<class GatherScatter, bool FORWARD, class Data>
-  void BufferedCommunicator::sendRecv(const Data& source, Data& dest)
+  void BufferedCommunicator::gather(const Data& source, typename CommPolicy<Data>::IndexedType* buffer)
   {
-    int rank, lrank;
+    if constexpr (IsRunCopyable<Data,GatherScatter>::value) {
+      const auto* values = source.data();
+      for(const auto& runs : runs_)
+        for(const Run& run : FORWARD ? runs.second.first : runs.second.second)
+          buffer = std::copy_n(values+run.local, run.length, buffer);
+    }else{
+      typedef typename CommPolicy<Data>::IndexedTypeFlag Flag;
+      MessageGatherer<Data,GatherScatter,FORWARD,Flag>() (interfaces_, source, buffer,
+                                                          bufferSize_[FORWARD ? 0 : 1]);
+    }
+  }
+
+  template<class GatherScatter, bool FORWARD, class Data>
+  void BufferedCommunicator::scatter(Data& target, typename CommPolicy<Data>::IndexedType* buffer, int proc)
+  {
+    if constexpr (IsRunCopyable<Data,GatherScatter>::value) {
+      auto runs = runs_.find(proc);
+      assert(runs != runs_.end());
+      auto* values = target.data();
+      for(const Run& run : FORWARD ? runs->second.second : runs->second.first) {
+        std::copy_n(buffer, run.length, values+run.local);
+        buffer += run.length;
+      }
+    }else{
+      typedef typename CommPolicy<Data>::IndexedTypeFlag Flag;
+      MessageScatterer<Data,GatherScatter,FORWARD,Flag>() (interfaces_, target, buffer, proc);
+    }
+  }
 
-    MPI_Comm_rank(MPI_COMM_WORLD,&rank);
-    MPI_Comm_rank(MPI_COMM_WORLD,&lrank);
+  template<class GatherScatter, bool FORWARD, class Data>
+  void BufferedCommunicator::startSendRecv(const Data& source)
+  {
+    if(active_)
+      DUNE_THROW(InvalidStateException, "Another communication of the BufferedCommunicator is still in progress");
 
     typedef typename CommPolicy<Data>::IndexedType Type;
-    Type *sendBuffer, *recvBuffer;
-    size_t sendBufferSize;
-#ifndef NDEBUG
-    size_t recvBufferSize;
-#endif
 
-    if(FORWARD) {
-      sendBuffer = reinterpret_cast<Type*>(buffers_[0]);
-      sendBufferSize = bufferSize_[0];
-      recvBuffer = reinterpret_cast<Type*>(buffers_[1]);
-#ifndef NDEBUG
-      recvBufferSize = bufferSize_[1];
+    DUNE_COMMUNICATION_SCOPE("BufferedCommunicator::start");
+    DUNE_COMMUNICATION_NEIGHBOURS(messageInformation_.size());
+
+    char* sendBuffer = buffers_[FORWARD ? 0 : 1];
+    char* recvBuffer = buffers_[FORWARD ? 1 : 0];
+
+    {
+      DUNE_COMMUNICATION_PACK_PHASE;
+      gather<GatherScatter,FORWARD>(source, reinterpret_cast<Type*>(sendBuffer));
+    }
+#if DUNE_COMMUNICATION_STATISTICS
+    for(const auto& info : messageInformation_) {
+      const MessageInformation& sendInfo = FORWARD ? info.second.first : info.second.second;
+      if(sendInfo.size_)
+        DUNE_COMMUNICATION_MESSAGE(sendInfo.size_);
+    }
 #endif
+
+    if(backend_ == CommunicationBackend::neighborhoodCollective) {
+      // All messages are exchanged by one request
+      active_ = &requests_;
+      requests_.requests.assign(1, MPI_REQUEST_NULL);
+      requests_.processes.clear();
+      requests_.receives = 1;
+      const int send = FORWARD ? 0 : 1;
+      const int recv = FORWARD ? 1 : 0;
+      MPI_Ineighbor_alltoallv(sendBuffer, neighborCounts_[send].data(), neighborDispls_[send].data(), MPI_BYTE,
+                              recvBuffer, neighborCounts_[recv].data(), neighborDispls_[recv].data(), MPI_BYTE,
+                              neighborhoodCommunicator_, &requests_.requests[0]);
+    }else if(persistent_) {
+      active_ = &persistentRequests_[FORWARD ? 0 : 1];
+      if(!active_->requests.empty())
+        MPI_Startall(active_->requests.size(), active_->requests.data());
     }else{
-      sendBuffer = reinterpret_cast<Type*>(buffers_[1]);
-      sendBufferSize = bufferSize_[1];
-      recvBuffer = reinterpret_cast<Type*>(buffers_[0]);
-#ifndef NDEBUG
-      recvBufferSize = bufferSize_[0];
-#endif
+      active_ = &requests_;
+      requests_.requests.clear();
+      requests_.processes.clear();
+
+      // Setup receive first
+      for(const auto& info : messageInformation_) {
+        const MessageInformation& recvInfo = FORWARD ? info.second.second : info.second.first;
+        assert(recvInfo.start_*sizeof(Type)+recvInfo.size_ <= bufferSize_[FORWARD ? 1 : 0]);
+        if(recvInfo.size_) {
+          requests_.requests.emplace_back();
+          MPI_Irecv(recvBuffer+recvInfo.start_*sizeof(Type), recvInfo.size_,
+                    MPI_BYTE, info.first, commTag_, communicator_,
+                    &requests_.requests.back());
+          requests_.processes.push_back(info.first);
+        }
+      }
+      requests_.receives = requests_.requests.size();
+
+      // now the send requests
+      for(const auto& info : messageInformation_) {
+        const MessageInformation& sendInfo = FORWARD ? info.second.first : info.second.second;
+        assert(sendInfo.start_*sizeof(Type)+sendInfo.size_ <= bufferSize_[FORWARD ? 0 : 1]);
+        if(sendInfo.size_) {
+          requests_.requests.emplace_back();
+          MPI_Issend(sendBuffer+sendInfo.start_*sizeof(Type), sendInfo.size_,
+                     MPI_BYTE, info.first, commTag_, communicator_,
+                     &requests_.requests.back());
+        }
+      }
     }
-    typedef typename CommPolicy<Data>::IndexedTypeFlag Flag;
+    pendingReceives_ = active_->receives;
+    completed_.resize(active_->receives);
+  }
 
-    MessageGatherer<Data,GatherScatter,FORWARD,Flag>() (interfaces_, source, sendBuffer, sendBufferSize);
-
-    MPI_Request* sendRequests = new MPI_Request[messageInformation_.size()];
-    MPI_Request* recvRequests = new MPI_Request[messageInformation_.size()];
-    /* Number of recvRequests that are not MPI_REQUEST_NULL */
-    size_t numberOfRealRecvRequests = 0;
-
-    // Setup receive first
-    typedef typename InformationMap::const_iterator const_iterator;
-
-    const const_iterator end = messageInformation_.end();
-    size_t i=0;
-    int* processMap = new int[messageInformation_.size()];
-
-    for(const_iterator info = messageInformation_.begin(); info != end; ++info, ++i) {
-      processMap[i]=info->first;
-      if(FORWARD) {
-        assert(info->second.second.start_*sizeof(typename CommPolicy<Data>::IndexedType)+info->second.second.size_ <= recvBufferSize );
-        Dune::dvverb<<rank<<": receiving "<<info->second.second.size_<<" from "<<info->first<<std::endl;
-        if(info->second.second.size_) {
-          MPI_Irecv(recvBuffer+info->second.second.start_, info->second.second.size_,
-                    MPI_BYTE, info->first, commTag_, communicator_,
-                    recvRequests+i);
-          numberOfRealRecvRequests += 1;
-        } else {
-          // Nothing to receive -> set request to inactive
-          recvRequests[i]=MPI_REQUEST_NULL;
+  template<class GatherScatter, bool FORWARD, class Data>
+  bool BufferedCommunicator::progressSendRecv(Data& dest, bool wait)
+  {
+    typedef typename CommPolicy<Data>::IndexedType Type;
+
+    assert(active_);
+    Type* recvBuffer = reinterpret_cast<Type*>(buffers_[FORWARD ? 1 : 0]);
+    std::vector<MPI_Request>& requests = active_->requests;
+
+    if(backend_ == CommunicationBackend::neighborhoodCollective) {
+      if(pendingReceives_) {
+        int flag = 1;
+        int error;
+        {
+          DUNE_COMMUNICATION_WAIT_PHASE;
+          error = wait
+            ? MPI_Wait(requests.data(), MPI_STATUS_IGNORE)
+            : MPI_Test(requests.data(), &flag, MPI_STATUS_IGNORE);
         }
-      }else{
-        assert(info->second.first.start_*sizeof(typename CommPolicy<Data>::IndexedType)+info->second.first.size_ <= recvBufferSize );
-        Dune::dvverb<<rank<<": receiving "<<info->second.first.size_<<" to "<<info->first<<std::endl;
-        if(info->second.first.size_) {
-          MPI_Irecv(recvBuffer+info->second.first.start_, info->second.first.size_,
-                    MPI_BYTE, info->first, commTag_, communicator_,
-                    recvRequests+i);
-          numberOfRealRecvRequests += 1;
-        } else {
-          // Nothing to receive -> set request to inactive
-          recvRequests[i]=MPI_REQUEST_NULL;
+        if(error!=MPI_SUCCESS) {
+          int rank;
+          MPI_Comm_rank(communicator_, &rank);
+          std::cerr<<rank<<": MPI_Error occurred in the neighbourhood exchange"<<std::endl;
         }
+        if(!flag)
+          return false;
+
+        // All messages arrived at once
+        DUNE_COMMUNICATION_PACK_PHASE;
+        for(const auto& info : messageInformation_) {
+          const MessageInformation& recvInfo = FORWARD ? info.second.second : info.second.first;
+          if(recvInfo.size_)
+            scatter<GatherScatter,FORWARD>(dest, recvBuffer+recvInfo.start_, info.first);
+        }
+        pendingReceives_ = 0;
       }
+      return true;
     }
 
-    // now the send requests
-    i=0;
-    for(const_iterator info = messageInformation_.begin(); info != end; ++info, ++i)
-      if(FORWARD) {
-        assert(info->second.second.start_*sizeof(typename CommPolicy<Data>::IndexedType)+info->second.second.size_ <= recvBufferSize );
-        Dune::dvverb<<rank<<": sending "<<info->second.first.size_<<" to "<<info->first<<std::endl;
-        assert(info->second.first.start_*sizeof(typename CommPolicy<Data>::IndexedType)+info->second.first.size_ <= sendBufferSize );
-        if(info->second.first.size_)
-          MPI_Issend(sendBuffer+info->second.first.start_, info->second.first.size_,
-                     MPI_BYTE, info->first, commTag_, communicator_,
-                     sendRequests+i);
-        else
-          // Nothing to send -> set request to inactive
-          sendRequests[i]=MPI_REQUEST_NULL;
-      }else{
-        assert(info->second.second.start_*sizeof(typename CommPolicy<Data>::IndexedType)+info->second.second.size_ <= sendBufferSize );
-        Dune::dvverb<<rank<<": sending "<<info->second.second.size_<<" to "<<info->first<<std::endl;
-        if(info->second.second.size_)
-          MPI_Issend(sendBuffer+info->second.second.start_, info->second.second.size_,
-                     MPI_BYTE, info->first, commTag_, communicator_,
-                     sendRequests+i);
-        else
-          // Nothing to send -> set request to inactive
-          sendRequests[i]=MPI_REQUEST_NULL;
+    // Scatter the received messages as soon as they arrive
+    while(pendingReceives_) {
+      int finished = 0;
+      int error;
+      {
+        DUNE_COMMUNICATION_WAIT_PHASE;
+        error = wait
+          ? MPI_Waitsome(active_->receives, requests.data(), &finished, completed_.data(), MPI_STATUSES_IGNORE)
+          : MPI_Testsome(active_->receives, requests.data(), &finished, completed_.data(), MPI_STATUSES_IGNORE);
       }
-
-    // Wait for completion of receive and immediately start scatter
-    i=0;
-    //int success = 1;
-    int finished = MPI_UNDEFINED;
-    MPI_Status status; //[messageInformation_.size()];
-    //MPI_Waitall(messageInformation_.size(), recvRequests, status);
-
-    for(i=0; i< numberOfRealRecvRequests; i++) {
-      status.MPI_ERROR=MPI_SUCCESS;
-      MPI_Waitany(messageInformation_.size(), recvRequests, &finished, &status);
       assert(finished != MPI_UNDEFINED);
 
-      if(status.MPI_ERROR==MPI_SUCCESS) {
-        int& proc = processMap[finished];
+      if(error!=MPI_SUCCESS) {
+        int rank;
+        MPI_Comm_rank(communicator_, &rank);
+        std::cerr<<rank<<": MPI_Error occurred while receiving messages"<<std::endl;
+      }
+
+      for(int i=0; i < finished; ++i) {
+        const int proc = active_->processes[completed_[i]];
         typename InformationMap::const_iterator infoIter = messageInformation_.find(proc);
         assert(infoIter != messageInformation_.end());
 
-        MessageInformation info = (FORWARD) ? infoIter->second.second : infoIter->second.first;
-        assert(info.start_+info.size_ <= recvBufferSize);
-
-        MessageScatterer<Data,GatherScatter,FORWARD,Flag>() (interfaces_, dest, recvBuffer+info.start_, proc);
-      }else{
-        std::cerr<<rank<<": MPI_Error occurred while receiving message from "<<processMap[finished]<<std::endl;
-        //success=0;
+        const MessageInformation& info = (FORWARD) ? infoIter->second.second : infoIter->second.first;
+        DUNE_COMMUNICATION_PACK_PHASE;
+        scatter<GatherScatter,FORWARD>(dest, recvBuffer+info.start_, proc);
       }
+      pendingReceives_ -= finished;
+
+      if(!wait)
+        break;
     }
 
-    MPI_Status recvStatus;
+    if(pendingReceives_)
+      return false;
 
-    // Wait for completion of sends
-    for(i=0; i< messageInformation_.size(); i++)
-      if(MPI_SUCCESS!=MPI_Wait(sendRequests+i, &recvStatus)) {
-        std::cerr<<rank<<": MPI_Error occurred while sending message to "<<processMap[finished]<<std::endl;
-        //success=0;
-      }
-    /*
-       int globalSuccess;
-       MPI_Allreduce(&success, &globalSuccess, 1, MPI_INT, MPI_MIN, interface_->communicator());
+    // Check the completion of the sends
+    int flag = 1;
+    if(!wait)
+      MPI_Testall(requests.size()-active_->receives, requests.data()+active_->receives,
+                  &flag, MPI_STATUSES_IGNORE);
+    return flag;
+  }
 
-       if(!globalSuccess)
-       DUNE_THROW(CommunicationError, "A communication error occurred!");
-     */
-    delete[] processMap;
-    delete[] sendRequests;
-    delete[] recvRequests;
+  template<class GatherScatter, bool FORWARD, class Data>
+  void BufferedCommunicator::finishSendRecv(Data& dest)
+  {
+    DUNE_COMMUNICATION_SCOPE("BufferedCommunicator::finish");
+    progressSendRecv<GatherScatter,FORWARD>(dest, true);
 
+    // Wait for completion of sends
+    DUNE_COMMUNICATION_WAIT_PHASE;
+    std::vector<MPI_Request>& requests = active_->requests;
+    if(MPI_SUCCESS!=MPI_Waitall(requests.size()-active_->receives,
+                                requests.data()+active_->receives,
+                                MPI_STATUSES_IGNORE)) {
+      int rank;
+      MPI_Comm_rank(communicator_, &rank);
+      std::cerr<<rank<<": MPI_Error occurred while sending messages"<<std::endl;
+    }
+    active_ = nullptr;
+  }
+
+  template<class GatherScatter, bool FORWARD, class Data>
+  void BufferedCommunicator::sendRecv(const Data& source, Data& dest)
+  {
+    startSendRecv<GatherScatter,FORWARD>(source);
+    finishSendRecv<GatherScatter,FORWARD>(dest);
   }
 
 #endif  // DOXYGEN
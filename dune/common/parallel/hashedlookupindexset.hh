@@ -0,0 +1,341 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_PARALLEL_HASHEDLOOKUPINDEXSET_HH
+#define DUNE_COMMON_PARALLEL_HASHEDLOOKUPINDEXSET_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/indexset.hh>
+
+namespace Dune
+{
+  /** @addtogroup Common_Parallel
+   *
+   * @{
+   */
+  /**
+   * @file
+   * @brief Provides a GlobalLookupIndexSet with hashed lookup of global indices.
+   */
+
+  /**
+   * @brief A GlobalLookupIndexSet that finds the index pair of a global index
+   * in a hash table instead of by binary search in the index set.
+   *
+   * The table is built once in the constructor. If the global indices are
+   * integral and compact, i.e. their range is at most twice the number of
+   * indices, they are mapped directly to the index pairs. Otherwise an open
+   * addressing hash table with linear probing is used. For non integral
+   * global indices std::hash has to be specialized.
+   *
+   * Many global indices can be looked up at once with lookup(), which
+   * prefetches the table entries of the following indices.
+   *
+   * The table becomes invalid if the index set is resized.
+   */
+  template<class I>
+  class HashedGlobalLookupIndexSet
+    : public GlobalLookupIndexSet<I>
+  {
+    typedef GlobalLookupIndexSet<I> Base;
+
+  public:
+    /**
+     * @brief The type of the index set.
+     */
+    typedef I ParallelIndexSet;
+
+    /**
+     * @brief The type of the global index.
+     */
+    typedef typename ParallelIndexSet::GlobalIndex GlobalIndex;
+
+    /**
+     * @brief The type of the index pair.
+     */
+    typedef typename Base::IndexPair IndexPair;
+
+    /**
+     * @brief Constructor.
+     * @param indexset The index set we want to be able to lookup the corresponding
+     * global index of a local index.
+     * @param size The number of indices present, i.e. one more than the maximum local index.
+     */
+    HashedGlobalLookupIndexSet(const ParallelIndexSet& indexset, std::size_t size);
+
+    /**
+     * @brief Constructor.
+     * @param indexset The index set we want to be able to lookup the corresponding
+     * global index of a local index.
+     */
+    HashedGlobalLookupIndexSet(const ParallelIndexSet& indexset);
+
+    /**
+     * @brief Find the index pair with a specific global id.
+     *
+     * If the global index is present several times the first pair of the
+     * index set is returned.
+     * @param global The globally unique id of the pair.
+     * @return The pair of indices for the id.
+     * @exception RangeError Thrown if the global id is not known.
+     */
+    inline const IndexPair&
+    operator[](const GlobalIndex& global) const;
+
+    /**
+     * @brief Find the index pair with a specific global id.
+     * @param global The globally unique id of the pair.
+     * @return A pointer to the pair of indices for the id or nullptr if the
+     * global id is not known.
+     */
+    inline const IndexPair*
+    find(const GlobalIndex& global) const;
+
+    /**
+     * @brief Find the index pairs of several global indices.
+     *
+     * While searching for a global index the table entries of the
+     * global indices a few positions ahead are prefetched.
+     * @param globals A range of global indices.
+     * @param out Output iterator to write the pointers to the pairs to. For
+     * unknown global indices nullptr is written.
+     * @return The output iterator after the last written pointer.
+     */
+    template<class Globals, class Out>
+    Out lookup(const Globals& globals, Out out) const;
+
+    /**
+     * @brief Whether the global indices are mapped directly to the pairs.
+     */
+    bool isDense() const
+    {
+      return dense_;
+    }
+
+  private:
+    /** @brief An entry of the hash table. */
+    struct Slot
+    {
+      /** @brief The global index. */
+      GlobalIndex global;
+      /** @brief The pair of the global index, nullptr for empty slots. */
+      const IndexPair* pair;
+    };
+
+    /** @brief The number of indices looked up ahead in lookup(). */
+    constexpr static std::size_t prefetchDistance = 8;
+
+    /** @brief Build the direct mapping or the hash table. */
+    void build();
+
+    /** @brief Build the hash table with room for n indices. */
+    void buildHashTable(std::size_t n);
+
+    /** @brief Whether the global indices are compact enough to map them directly. */
+    bool isCompact(std::size_t n, const GlobalIndex& min, const GlobalIndex& max) const;
+
+    /** @brief The position of a global index in the hash table. */
+    inline std::size_t position(const GlobalIndex& global) const;
+
+    /**
+     * @brief The position of a global index in the direct mapping.
+     * @return The position or direct_.size() if the index is out of range.
+     */
+    inline std::size_t directPosition(const GlobalIndex& global) const;
+
+    /** @brief Prefetch the table entry of a global index. */
+    inline void prefetch(const GlobalIndex& global) const;
+
+    /** @brief Whether the global indices are mapped directly. */
+    bool dense_;
+
+    /** @brief The smallest global index of the direct mapping. */
+    GlobalIndex offset_;
+
+    /** @brief The pairs of the global indices offset_, offset_+1, ... */
+    std::vector<const IndexPair*> direct_;
+
+    /** @brief The hash table with a power of two entries. */
+    std::vector<Slot> slots_;
+
+    /** @brief The shift to get the position from the hash value. */
+    unsigned shift_;
+  };
+
+  /** @} */
+
+  template<class I>
+  HashedGlobalLookupIndexSet<I>::HashedGlobalLookupIndexSet(const I& indexset,
+                                                            std::size_t size)
+    : Base(indexset, size), dense_(false), offset_(), shift_(0)
+  {
+    build();
+  }
+
+  template<class I>
+  HashedGlobalLookupIndexSet<I>::HashedGlobalLookupIndexSet(const I& indexset)
+    : Base(indexset), dense_(false), offset_(), shift_(0)
+  {
+    build();
+  }
+
+  template<class I>
+  bool HashedGlobalLookupIndexSet<I>::isCompact(std::size_t n, const GlobalIndex& min,
+                                                const GlobalIndex& max) const
+  {
+    if constexpr (std::is_integral<GlobalIndex>::value) {
+      typedef std::make_unsigned_t<GlobalIndex> Unsigned;
+      const Unsigned range = Unsigned(max) - Unsigned(min);
+      return std::uintmax_t(range) < 2*std::uintmax_t(n);
+    }
+    else
+      return false;
+  }
+
+  template<class I>
+  inline std::size_t HashedGlobalLookupIndexSet<I>::directPosition(const GlobalIndex& global) const
+  {
+    if constexpr (std::is_integral<GlobalIndex>::value) {
+      typedef std::make_unsigned_t<GlobalIndex> Unsigned;
+      if(global < offset_)
+        return direct_.size();
+      return std::min<std::uintmax_t>(Unsigned(global) - Unsigned(offset_), direct_.size());
+    }
+    else
+      return direct_.size();
+  }
+
+  template<class I>
+  void HashedGlobalLookupIndexSet<I>::build()
+  {
+    std::size_t n = 0;
+    GlobalIndex min = GlobalIndex(), max = GlobalIndex();
+    for(auto pair = this->begin(); pair != this->end(); ++pair, ++n) {
+      // the pairs are sorted by their global index
+      if(n == 0)
+        min = pair->global();
+      max = pair->global();
+    }
+
+    dense_ = n > 0 && isCompact(n, min, max);
+
+    if(dense_) {
+      offset_ = min;
+      direct_.assign(2*n, nullptr);
+      direct_.resize(directPosition(max) + 1);
+      for(auto pair = this->begin(); pair != this->end(); ++pair) {
+        const IndexPair*& entry = direct_[directPosition(pair->global())];
+        if(!entry)
+          entry = &(*pair);
+      }
+    }
+    else
+      buildHashTable(n);
+  }
+
+  template<class I>
+  void HashedGlobalLookupIndexSet<I>::buildHashTable(std::size_t n)
+  {
+    // Keep the load factor at most 1/2
+    unsigned bits = 1;
+    while((std::size_t(1) << bits) < 2*n)
+      ++bits;
+    shift_ = 64 - bits;
+    slots_.assign(std::size_t(1) << bits, Slot{GlobalIndex(), nullptr});
+    const std::size_t mask = slots_.size() - 1;
+
+    for(auto pair = this->begin(); pair != this->end(); ++pair) {
+      std::size_t slot = position(pair->global());
+      while(slots_[slot].pair && !(slots_[slot].global == pair->global()))
+        slot = (slot + 1) & mask;
+      // keep the first pair of a global index
+      if(!slots_[slot].pair)
+        slots_[slot] = Slot{pair->global(), &(*pair)};
+    }
+  }
+
+  template<class I>
+  inline std::size_t HashedGlobalLookupIndexSet<I>::position(const GlobalIndex& global) const
+  {
+    std::uint64_t hash;
+    if constexpr (std::is_integral<GlobalIndex>::value)
+      hash = std::uint64_t(global);
+    else
+      hash = std::hash<GlobalIndex>()(global);
+    // Fibonacci hashing spreads consecutive indices over the table
+    return std::size_t((hash * UINT64_C(0x9E3779B97F4A7C15)) >> shift_);
+  }
+
+  template<class I>
+  inline void HashedGlobalLookupIndexSet<I>::prefetch([[maybe_unused]] const GlobalIndex& global) const
+  {
+#if defined(__GNUC__)
+    if(dense_) {
+      const std::size_t entry = directPosition(global);
+      if(entry < direct_.size())
+        __builtin_prefetch(direct_.data() + entry);
+    }
+    else
+      __builtin_prefetch(slots_.data() + position(global));
+#endif
+  }
+
+  template<class I>
+  inline const typename HashedGlobalLookupIndexSet<I>::IndexPair*
+  HashedGlobalLookupIndexSet<I>::find(const GlobalIndex& global) const
+  {
+    if(dense_) {
+      const std::size_t entry = directPosition(global);
+      return entry < direct_.size() ? direct_[entry] : nullptr;
+    }
+
+    const std::size_t mask = slots_.size() - 1;
+    for(std::size_t slot = position(global); slots_[slot].pair; slot = (slot + 1) & mask)
+      if(slots_[slot].global == global)
+        return slots_[slot].pair;
+    return nullptr;
+  }
+
+  template<class I>
+  inline const typename HashedGlobalLookupIndexSet<I>::IndexPair&
+  HashedGlobalLookupIndexSet<I>::operator[](const GlobalIndex& global) const
+  {
+    const IndexPair* pair = find(global);
+    if(!pair)
+      DUNE_THROW(RangeError, "Global index " << global << " is not in the index set");
+    return *pair;
+  }
+
+  template<class I>
+  template<class Globals, class Out>
+  Out HashedGlobalLookupIndexSet<I>::lookup(const Globals& globals, Out out) const
+  {
+    using std::begin;
+    using std::end;
+    const auto last = end(globals);
+    auto ahead = begin(globals);
+    for(std::size_t i = 0; i < prefetchDistance && ahead != last; ++i, ++ahead)
+      prefetch(*ahead);
+
+    for(auto global = begin(globals); global != last; ++global, ++out) {
+      if(ahead != last) {
+        prefetch(*ahead);
+        ++ahead;
+      }
+      *out = find(*global);
+    }
+    return out;
+  }
+
+} // end namespace Dune
+
+#endif
@@ -0,0 +1,272 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_PARALLEL_HIERARCHICALCOMMUNICATION_HH
+#define DUNE_COMMON_PARALLEL_HIERARCHICALCOMMUNICATION_HH
+
+/*!
+   \file
+   \brief Collective communication through shared memory within a node
+   and between one leader per node.
+
+   \ingroup ParallelCommunication
+ */
+
+#if HAVE_MPI
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include <mpi.h>
+
+namespace Dune
+{
+  namespace Impl
+  {
+    /*! \brief Collective operations of a communicator split into groups
+        of processes sharing memory.
+
+        The processes of a group exchange their data through a shared
+        memory window. Only the first process of each group, its leader,
+        communicates with the other groups. The groups are the shared
+        memory nodes, optionally split further into groups of at most
+        `groupSize` processes, e.g. one per socket.
+
+        All operations are collective on the communicator. The data has to
+        be described by a datatype with lower bound 0 whose elements are
+        stored contiguously in memory, see supports().
+     */
+    class HierarchicalCommunication
+    {
+    public:
+      HierarchicalCommunication(MPI_Comm comm, int groupSize = 0)
+        : comm_(comm), win_(MPI_WIN_NULL), base_(nullptr), size_(0)
+      {
+        int rank, size;
+        MPI_Comm_rank(comm_, &rank);
+        MPI_Comm_size(comm_, &size);
+
+        MPI_Comm shared;
+        MPI_Comm_split_type(comm_, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &shared);
+        if (groupSize > 0) {
+          int sharedRank;
+          MPI_Comm_rank(shared, &sharedRank);
+          MPI_Comm_split(shared, sharedRank/groupSize, sharedRank, &group_);
+          MPI_Comm_free(&shared);
+        }
+        else
+          group_ = shared;
+        MPI_Comm_rank(group_, &groupRank_);
+
+        MPI_Comm_split(comm_, groupRank_ == 0 ? 0 : MPI_UNDEFINED, rank, &leaders_);
+        int leaderRank = -1;
+        if (leaders_ != MPI_COMM_NULL)
+          MPI_Comm_rank(leaders_, &leaderRank);
+        MPI_Bcast(&leaderRank, 1, MPI_INT, 0, group_);
+
+        // The group and the position in it of all processes
+        int mine[2] = {leaderRank, groupRank_};
+        std::vector<int> all(2*size);
+        MPI_Allgather(mine, 2, MPI_INT, all.data(), 2, MPI_INT, comm_);
+        groupOf_.resize(size);
+        positionOf_.resize(size);
+        int groups = 0;
+        for (int r = 0; r < size; ++r) {
+          groupOf_[r] = all[2*r];
+          positionOf_[r] = all[2*r+1];
+          groups = std::max(groups, groupOf_[r]+1);
+        }
+        members_.assign(groups, std::vector<int>());
+        for (int r = 0; r < size; ++r) {
+          std::vector<int>& members = members_[groupOf_[r]];
+          members.resize(std::max<std::size_t>(members.size(), positionOf_[r]+1));
+          members[positionOf_[r]] = r;
+        }
+        myGroup_ = groupOf_[rank];
+      }
+
+      HierarchicalCommunication(const HierarchicalCommunication&) = delete;
+      HierarchicalCommunication& operator=(const HierarchicalCommunication&) = delete;
+
+      //! Has to be called collectively before MPI is finalized.
+      ~HierarchicalCommunication()
+      {
+        int finalized = 0;
+        MPI_Finalized(&finalized);
+        if (finalized)
+          return;
+        freeWindow();
+        if (leaders_ != MPI_COMM_NULL)
+          MPI_Comm_free(&leaders_);
+        MPI_Comm_free(&group_);
+      }
+
+      //! The number of groups.
+      int groups() const
+      {
+        return members_.size();
+      }
+
+      //! The number of processes in the group of this process.
+      int groupSize() const
+      {
+        return members_[myGroup_].size();
+      }
+
+      //! Whether data of the datatype can be copied as count*extent bytes.
+      static bool supports(MPI_Datatype datatype)
+      {
+        MPI_Aint lb, extent, trueLb, trueExtent;
+        MPI_Type_get_extent(datatype, &lb, &extent);
+        MPI_Type_get_true_extent(datatype, &trueLb, &trueExtent);
+        return lb == 0 && trueLb >= 0 && trueLb + trueExtent <= extent;
+      }
+
+      //! See MPI_Allreduce, in may be MPI_IN_PLACE.
+      int allreduce(const void* in, void* out, int count, MPI_Datatype datatype, MPI_Op op)
+      {
+        if (in == MPI_IN_PLACE)
+          in = out;
+        const std::size_t bytes = count*extent(datatype);
+        const int members = groupSize();
+        // contributions of the members followed by the result
+        char* window = reserve((members+1)*bytes);
+        char* result = window + members*bytes;
+        std::memcpy(window + groupRank_*bytes, in, bytes);
+        sync();
+        int ret = MPI_SUCCESS;
+        if (groupRank_ == 0) {
+          std::memcpy(result, window + (members-1)*bytes, bytes);
+          for (int i = members-2; i >= 0; --i)
+            MPI_Reduce_local(window + i*bytes, result, count, datatype, op);
+          if (groups() > 1)
+            ret = MPI_Allreduce(MPI_IN_PLACE, result, count, datatype, op, leaders_);
+        }
+        sync();
+        std::memcpy(out, result, bytes);
+        return ret;
+      }
+
+      //! See MPI_Bcast.
+      int broadcast(void* inout, int count, MPI_Datatype datatype, int root)
+      {
+        const std::size_t bytes = count*extent(datatype);
+        char* window = reserve(bytes);
+        if (positionOf_[root] == groupRank_ && groupOf_[root] == myGroup_)
+          std::memcpy(window, inout, bytes);
+        sync();
+        int ret = MPI_SUCCESS;
+        if (groupRank_ == 0 && groups() > 1)
+          ret = MPI_Bcast(window, count, datatype, groupOf_[root], leaders_);
+        sync();
+        std::memcpy(inout, window, bytes);
+        return ret;
+      }
+
+      //! See MPI_Allgatherv.
+      int allgatherv(const void* in, int count, void* out, const int* counts,
+                     const int* displ, MPI_Datatype datatype)
+      {
+        const std::size_t e = extent(datatype);
+        // the data is gathered group by group in the order of the members
+        std::vector<int> groupCounts(groups(), 0), groupDispl(groups(), 0);
+        std::vector<std::size_t> offset(groupOf_.size());
+        int total = 0;
+        for (int g = 0; g < groups(); ++g) {
+          groupDispl[g] = total;
+          for (int r : members_[g]) {
+            offset[r] = total;
+            total += counts[r];
+          }
+          groupCounts[g] = total - groupDispl[g];
+        }
+        char* window = reserve(total*e);
+        int rank = members_[myGroup_][groupRank_];
+        std::memcpy(window + offset[rank]*e, in, count*e);
+        sync();
+        int ret = MPI_SUCCESS;
+        if (groupRank_ == 0 && groups() > 1)
+          ret = MPI_Allgatherv(MPI_IN_PLACE, 0, datatype, window, groupCounts.data(),
+                               groupDispl.data(), datatype, leaders_);
+        sync();
+        for (std::size_t r = 0; r < offset.size(); ++r)
+          std::memcpy(static_cast<char*>(out) + displ[r]*e, window + offset[r]*e, counts[r]*e);
+        return ret;
+      }
+
+    private:
+      static std::size_t extent(MPI_Datatype datatype)
+      {
+        MPI_Aint lb, extent;
+        MPI_Type_get_extent(datatype, &lb, &extent);
+        return extent;
+      }
+
+      // Shared memory with at least size bytes for the next operation.
+      // All members have to call this with the same size.
+      //
+      // The window consists of two halves used by consecutive operations
+      // in turn. Hence a member may start the next operation while others
+      // still read the result of the current one. When an operation uses a
+      // half again, all members have passed the synchronization of the
+      // operation in between.
+      char* reserve(std::size_t size)
+      {
+        if (size > size_ || win_ == MPI_WIN_NULL) {
+          freeWindow();
+          size_ = std::max({size, 2*size_, std::size_t(64)});
+          char* base;
+          MPI_Win_allocate_shared(groupRank_ == 0 ? 2*size_ : 0, 1, MPI_INFO_NULL,
+                                  group_, &base, &win_);
+          MPI_Aint querySize;
+          int dispUnit;
+          MPI_Win_shared_query(win_, 0, &querySize, &dispUnit, &base_);
+          MPI_Win_lock_all(MPI_MODE_NOCHECK, win_);
+        }
+        half_ = 1 - half_;
+        return base_ + half_*size_;
+      }
+
+      void freeWindow()
+      {
+        if (win_ != MPI_WIN_NULL) {
+          MPI_Win_unlock_all(win_);
+          MPI_Win_free(&win_);
+        }
+      }
+
+      // Makes the writes to the window visible to all members
+      void sync()
+      {
+        MPI_Win_sync(win_);
+        MPI_Barrier(group_);
+        MPI_Win_sync(win_);
+      }
+
+      MPI_Comm comm_;
+      MPI_Comm group_;
+      MPI_Comm leaders_;
+      int groupRank_;
+      int myGroup_;
+      //! The group, i.e. the rank of its leader in leaders_, of each process.
+      std::vector<int> groupOf_;
+      //! The rank in its group of each process.
+      std::vector<int> positionOf_;
+      //! The processes of each group.
+      std::vector<std::vector<int> > members_;
+      MPI_Win win_;
+      char* base_;
+      //! The size of each half of the window.
+      std::size_t size_;
+      //! The half of the window used by the current operation.
+      int half_ = 0;
+    };
+
+  } // end namespace Impl
+} // end namespace Dune
+
+#endif // HAVE_MPI
+#endif // DUNE_COMMON_PARALLEL_HIERARCHICALCOMMUNICATION_HH
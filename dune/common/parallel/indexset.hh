@@ -6,8 +6,14 @@
 #define DUNE_COMMON_PARALLEL_INDEXSET_HH
 
 #include <algorithm>
+#include <array>
+#include <climits>
+#include <cstddef>
 #include <cstdint> // for uint32_t
 #include <iostream>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 #include <dune/common/arraylist.hh>
 #include <dune/common/exceptions.hh>
@@ -354,10 +360,17 @@ namespace Dune
      * Let \f$(g_i,l_i)_{i=0}^N \f$ be the set of all indices then \f$l_i < l_j\f$
      * if and
      * only if \f$g_i < g_j\f$ for arbitrary \f$i \neq j\f$.
+     *
+     * The new indices are sorted with a radix sort if the global
+     * indices are integral. Indices with the same global index keep
+     * the order in which they were added unless their local indices
+     * are ordered by LocalIndexComparator.
+     * @param threads The number of threads used to sort and merge the
+     * indices. Small index sets are always processed by one thread.
      * @exception InvalidState If index set was not in
      * ParallelIndexSetState::RESIZE mode.
      */
-    void endResize();
+    void endResize(std::size_t threads = 1);
 
     /**
      * @brief Find the index pair with a specific global id.
@@ -482,10 +495,10 @@ namespace Dune
     /** @brief Whether entries were deleted in resize mode. */
     bool deletedEntries_;
     /**
-     * @brief Merges the _localIndices and newIndices arrays and creates a new
-     * localIndices array.
+     * @brief Merges the _localIndices and the sorted new indices and creates
+     * a new localIndices array.
      */
-    inline void merge();
+    inline void merge(const std::vector<IndexPair>& added, std::size_t threads);
   };
 
 
@@ -630,6 +643,187 @@ namespace Dune
     }
   };
 
+  namespace Impl
+  {
+    /** @brief The minimal number of index pairs a thread sorts or merges. */
+    constexpr std::size_t minPairsPerThread = std::size_t(1) << 15;
+
+    /** @brief The number of threads worth using for n index pairs. */
+    inline std::size_t indexSetThreads(std::size_t threads, std::size_t n)
+    {
+      return std::max<std::size_t>(1, std::min(threads, n/minPairsPerThread));
+    }
+
+    /** @brief Calls f(t) for t=0,...,threads-1, each in its own thread. */
+    template<class F>
+    void forEachThread(std::size_t threads, F&& f)
+    {
+      std::vector<std::thread> team;
+      team.reserve(threads-1);
+      for(std::size_t t=1; t<threads; ++t)
+        team.emplace_back(std::ref(f), t);
+      f(std::size_t(0));
+      for(auto& thread : team)
+        thread.join();
+    }
+
+    /**
+     * @brief Merges two sorted ranges, taking elements of the first range
+     * before equivalent ones of the second like std::merge.
+     *
+     * The output is split evenly among the threads by searching the
+     * corresponding positions in both ranges (merge path).
+     */
+    template<class T, class C>
+    void parallelMerge(const std::vector<T>& first, const std::vector<T>& second,
+                       typename std::vector<T>::iterator out, C compare, std::size_t threads)
+    {
+      const std::size_t n1 = first.size(), n2 = second.size();
+      // The number of elements of the first range among the first k outputs
+      auto split = [&](std::size_t k){
+                     std::size_t low = k > n2 ? k-n2 : 0, high = std::min(k, n1);
+                     while(low < high) {
+                       const std::size_t i = (low+high)/2, j = k-i;
+                       if(j > 0 && !compare(second[j-1], first[i]))
+                         low = i+1;
+                       else
+                         high = i;
+                     }
+                     return low;
+                   };
+      threads = indexSetThreads(threads, n1+n2);
+      forEachThread(threads, [&](std::size_t t){
+          const std::size_t begin = (n1+n2)*t/threads, end = (n1+n2)*(t+1)/threads;
+          const std::size_t i0 = split(begin), i1 = split(end);
+          std::merge(first.begin()+i0, first.begin()+i1,
+                     second.begin()+(begin-i0), second.begin()+(end-i1),
+                     out+begin, compare);
+        });
+    }
+
+    /**
+     * @brief Sorts index pairs stably by their integral global index with a
+     * least significant digit radix sort.
+     *
+     * Digits that are equal for all pairs are skipped.
+     */
+    template<class Pair>
+    void radixSortByGlobal(std::vector<Pair>& pairs, std::size_t threads)
+    {
+      typedef std::decay_t<decltype(pairs[0].global())> Global;
+      typedef std::make_unsigned_t<Global> Key;
+      constexpr int bits = 8;
+      constexpr std::size_t buckets = std::size_t(1) << bits;
+      constexpr int digits = (sizeof(Key)*CHAR_BIT + bits - 1)/bits;
+      // Flipping the sign bit orders negative before positive indices
+      constexpr Key flip = std::is_signed<Global>::value ? Key(Key(1) << (sizeof(Key)*CHAR_BIT-1)) : Key(0);
+      typedef std::array<std::size_t,buckets> Histogram;
+
+      const std::size_t n = pairs.size();
+      threads = indexSetThreads(threads, n);
+      auto chunk = [&](std::size_t t){ return n*t/threads; };
+      auto digit = [&](const Pair& pair, int d){
+                     return std::size_t((Key(pair.global()) ^ flip) >> (d*bits)) & (buckets-1);
+                   };
+
+      // the histograms of all digits of the chunk of each thread
+      std::vector<std::array<Histogram,digits> > counts(threads);
+      forEachThread(threads, [&](std::size_t t){
+          auto& count = counts[t];
+          for(auto& histogram : count)
+            histogram.fill(0);
+          for(std::size_t i=chunk(t); i<chunk(t+1); ++i)
+            for(int d=0; d<digits; ++d)
+              ++count[d][digit(pairs[i], d)];
+        });
+
+      std::vector<Pair> scratch(n);
+      std::vector<Histogram> offsets(threads);
+      for(int d=0; d<digits; ++d) {
+        std::size_t largest = 0;
+        for(std::size_t b=0; b<buckets; ++b) {
+          std::size_t total = 0;
+          for(const auto& count : counts)
+            total += count[d][b];
+          largest = std::max(largest, total);
+        }
+        if(largest == n)
+          continue;
+
+        // Each thread scatters its chunk, after the pairs of the same
+        // digit of the preceding chunks.
+        std::size_t offset = 0;
+        for(std::size_t b=0; b<buckets; ++b)
+          for(std::size_t t=0; t<threads; ++t) {
+            offsets[t][b] = offset;
+            offset += counts[t][d][b];
+          }
+        forEachThread(threads, [&](std::size_t t){
+            auto& position = offsets[t];
+            for(std::size_t i=chunk(t); i<chunk(t+1); ++i)
+              scratch[position[digit(pairs[i], d)]++] = pairs[i];
+          });
+        pairs.swap(scratch);
+
+        // The chunks contain other pairs now, count their remaining digits.
+        if(threads > 1)
+          forEachThread(threads, [&](std::size_t t){
+              auto& count = counts[t];
+              for(int e=d+1; e<digits; ++e)
+                count[e].fill(0);
+              for(std::size_t i=chunk(t); i<chunk(t+1); ++i)
+                for(int e=d+1; e<digits; ++e)
+                  ++count[e][digit(pairs[i], e)];
+            });
+      }
+    }
+
+    /**
+     * @brief Sorts index pairs with IndexSetSortFunctor.
+     */
+    template<class TG, class TL>
+    void sortIndexPairs(std::vector<IndexPair<TG,TL> >& pairs, std::size_t threads)
+    {
+      typedef IndexSetSortFunctor<TG,TL> Compare;
+      if constexpr (std::is_integral<TG>::value && !std::is_same<TG,bool>::value) {
+        radixSortByGlobal(pairs, threads);
+        // order the pairs with equal global indices by their local indices
+        for(auto first = pairs.begin(); first != pairs.end();) {
+          auto last = first+1;
+          while(last != pairs.end() && last->global() == first->global())
+            ++last;
+          if(last-first > 1)
+            std::stable_sort(first, last, Compare());
+          first = last;
+        }
+      }
+      else {
+        const std::size_t n = pairs.size();
+        threads = indexSetThreads(threads, n);
+        // sort chunks of the pairs and merge them pairwise
+        std::vector<std::size_t> bounds(threads+1);
+        for(std::size_t t=0; t<=threads; ++t)
+          bounds[t] = n*t/threads;
+        forEachThread(threads, [&](std::size_t t){
+            std::stable_sort(pairs.begin()+bounds[t], pairs.begin()+bounds[t+1], Compare());
+          });
+        std::vector<IndexPair<TG,TL> > first, second;
+        while(bounds.size() > 2) {
+          std::vector<std::size_t> merged(1, 0);
+          for(std::size_t c=0; c+2<bounds.size(); c+=2) {
+            first.assign(pairs.begin()+bounds[c], pairs.begin()+bounds[c+1]);
+            second.assign(pairs.begin()+bounds[c+1], pairs.begin()+bounds[c+2]);
+            parallelMerge(first, second, pairs.begin()+bounds[c], Compare(), threads);
+            merged.push_back(bounds[c+2]);
+          }
+          if(bounds.size()%2 == 0)
+            merged.push_back(bounds.back());
+          bounds.swap(merged);
+        }
+      }
+    }
+  } // end namespace Impl
+
 
 
   template<class TG, class TL>
@@ -818,7 +1012,7 @@ namespace Dune
   }
 
   template<class TG, class TL, int N>
-  void ParallelIndexSet<TG,TL,N>::endResize() {
+  void ParallelIndexSet<TG,TL,N>::endResize(std::size_t threads) {
     // Checks in unproductive code
 #ifndef NDEBUG
     if(state_ != RESIZE)
@@ -826,65 +1020,39 @@ namespace Dune
                  <<"in RESIZE state!");
 #endif
 
-    std::sort(newIndices_.begin(), newIndices_.end(), IndexSetSortFunctor<TG,TL>());
-    merge();
+    // Sort in contiguous memory
+    std::vector<IndexPair> added(newIndices_.begin(), newIndices_.end());
+    newIndices_.clear();
+    Impl::sortIndexPairs(added, threads);
+    merge(added, threads);
     seqNo_++;
     state_ = GROUND;
   }
 
 
   template<class TG, class TL, int N>
-  inline void ParallelIndexSet<TG,TL,N>::merge(){
+  inline void ParallelIndexSet<TG,TL,N>::merge(const std::vector<IndexPair>& added,
+                                              std::size_t threads)
+  {
     if(localIndices_.size()==0)
     {
-      localIndices_=newIndices_;
-      newIndices_.clear();
+      for(const auto& pair : added)
+        localIndices_.push_back(pair);
     }
-    else if(newIndices_.size()>0 || deletedEntries_)
+    else if(added.size()>0 || deletedEntries_)
     {
-      ArrayList<IndexPair,N> tempPairs;
-
-      auto old = localIndices_.begin();
-      auto added = newIndices_.begin();
-      const auto endold = localIndices_.end();
-      const auto endadded = newIndices_.end();
-
-      while(old != endold && added!= endadded)
-      {
-        if(old->local().state()==DELETED) {
-          old.eraseToHere();
-        }
-        else
-        {
-          if(old->global() < added->global() ||
-             (old->global() == added->global()
-              && LocalIndexComparator<TL>::compare(old->local(),added->local())))
-          {
-            tempPairs.push_back(*old);
-            old.eraseToHere();
-            continue;
-          }else
-          {
-            tempPairs.push_back(*added);
-            added.eraseToHere();
-          }
-        }
-      }
-
-      while(old != endold)
-      {
-        if(old->local().state()!=DELETED) {
-          tempPairs.push_back(*old);
-        }
-        old.eraseToHere();
-      }
-
-      while(added!= endadded)
-      {
-        tempPairs.push_back(*added);
-        added.eraseToHere();
-      }
-      localIndices_ = tempPairs;
+      std::vector<IndexPair> old;
+      old.reserve(localIndices_.size());
+      for(const auto& pair : localIndices_)
+        if(pair.local().state()!=DELETED)
+          old.push_back(pair);
+      localIndices_.clear();
+
+      // New pairs are placed before equivalent old ones.
+      std::vector<IndexPair> pairs(old.size()+added.size());
+      Impl::parallelMerge(added, old, pairs.begin(), IndexSetSortFunctor<TG,TL>(), threads);
+      for(const auto& pair : pairs)
+        localIndices_.push_back(pair);
     }
   }
 
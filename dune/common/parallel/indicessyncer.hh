@@ -10,16 +10,21 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstring>
 #include <functional>
 #include <limits>
 #include <map>
 #include <tuple>
+#include <type_traits>
+#include <vector>
 
 #include <mpi.h>
 
 #include <dune/common/stdstreams.hh>
 #include <dune/common/sllist.hh>
+#include <dune/common/parallel/communicationstatistics.hh>
 #include <dune/common/parallel/indexset.hh>
+#include <dune/common/parallel/mpitraits.hh>
 #include <dune/common/parallel/remoteindices.hh>
 
 namespace Dune
@@ -108,35 +113,48 @@ namespace Dune
     /** @brief The remote indices. */
     RemoteIndices& remoteIndices_;
 
-    /** @brief The send buffers for the neighbour processes. */
-    char** sendBuffers_;
-
-    /** @brief The receive buffer. */
-    char* receiveBuffer_;
-
-    /** @brief The size of the send buffers. */
-    std::size_t* sendBufferSizes_;
-
-    /** @brief The size of the receive buffer in bytes. */
-    int receiveBufferSize_; // int because of MPI
-
     /**
-     * @brief Information about the messages to send to a neighbouring process.
+     * @brief A message to or from a neighbouring process.
+     *
+     * The message is stored as a struct of arrays. For each published index
+     * it holds the global index, its attribute and the number of its remote
+     * indices. For all these remote indices it holds the process and the
+     * attribute. The arrays are copied to and from the sent bytes with memcpy.
+     * Global indices that are not trivially copyable are packed with
+     * MPI_Pack according to their MPITraits instead.
      */
-    struct MessageInformation
+    struct Message
     {
-      MessageInformation()
-        : publish(), pairs()
-      {}
-      /** @brief The number of indices we publish for the other process. */
-      int publish;
-      /**
-       * @brief The number of pairs (attribute and process number)
-       * we publish to the neighbour process.
-       */
-      int pairs;
+      /** @brief The published global indices. */
+      std::vector<GlobalIndex> globals;
+      /** @brief The attributes of the published indices. */
+      std::vector<char> attributes;
+      /** @brief The number of remote indices of each published index. */
+      std::vector<int> counts;
+      /** @brief The processes of the remote indices. */
+      std::vector<int> processes;
+      /** @brief The attributes of the remote indices. */
+      std::vector<char> remoteAttributes;
+
+      /** @brief The number of bytes of the packed message. */
+      std::size_t bytes(MPI_Comm comm) const;
+
+      /** @brief Copy the message to a buffer of bytes() bytes. */
+      void pack(char* buffer, MPI_Comm comm) const;
+
+      /** @brief Copy the message from a buffer. */
+      void unpack(const char* buffer, MPI_Comm comm);
     };
 
+    /** @brief The send buffers for the neighbour processes. */
+    std::vector<std::vector<char> > sendBuffers_;
+
+    /** @brief The receive buffer. */
+    std::vector<char> receiveBuffer_;
+
+    /** @brief The message received last. */
+    Message receiveMessage_;
+
     /**
      * @brief Default numberer for sync().
      */
@@ -154,9 +172,6 @@ namespace Dune
       }
     };
 
-    /** @brief The mpi datatype for the MessageInformation */
-    MPI_Datatype datatype_;
-
     /** @brief Our rank. */
     int rank_;
 
@@ -210,9 +225,6 @@ namespace Dune
      */
     BoolMap oldMap_;
 
-    /** @brief Information about the messages we send. */
-    std::map<int,MessageInformation> infoSend_;
-
     /** @brief The type of the remote index list. */
     typedef typename RemoteIndices::RemoteIndexList RemoteIndexList;
 
@@ -320,6 +332,21 @@ namespace Dune
        */
       bool isAtEnd() const;
 
+      /**
+       * @brief Whether searching for a pair can continue at the current position.
+       *
+       * This is the case if the last pair searched for is smaller, i.e.
+       * all entries before the current position are smaller than the pair.
+       * @param global The pair to search for.
+       */
+      bool canSearch(const std::pair<GlobalIndex,Attribute>& global) const;
+
+      /**
+       * @brief Remember the pair that was searched for last.
+       * @param global The pair searched for.
+       */
+      void searched(const std::pair<GlobalIndex,Attribute>& global);
+
     private:
       /**
        * @brief The iterator tuple.
@@ -331,6 +358,12 @@ namespace Dune
        * singly linked list of remote indices positioned at the end.
        */
       IteratorTuple iterators_;
+
+      /** @brief The pair searched for last. */
+      std::pair<GlobalIndex,Attribute> last_;
+
+      /** @brief Whether there was a search since the last reset. */
+      bool searched_;
     };
 
     /** @brief Type of the map from ranks to iterator tuples. */
@@ -349,17 +382,15 @@ namespace Dune
      */
     IteratorsMap iteratorsMap_;
 
-    /** @brief Calculates the message sizes to send. */
-    void calculateMessageSizes();
-
     /**
-     * @brief Pack and send the message for another process.
-     * @param destination The rank of the process we send to.
-     * @param buffer The allocated buffer to use.
-     * @param bufferSize The size of the buffer.
-     * @param req The MPI_Request to setup the nonblocking send.
+     * @brief Pack the messages for all neighbours and send them.
+     *
+     * The messages are packed in one pass over the index set.
+     * @param neighbours The ranks of the neighbours in ascending order.
+     * @param noNeighbours The number of neighbours.
+     * @param requests The MPI_Requests to setup the nonblocking sends, one per neighbour.
      */
-    void packAndSend(int destination, char* buffer, std::size_t bufferSize, MPI_Request& req);
+    void packAndSend(const int* neighbours, std::size_t noNeighbours, MPI_Request* requests);
 
     /**
      * @brief Recv and unpack the message from another process and add the indices.
@@ -370,11 +401,6 @@ namespace Dune
     template<typename T1>
     void recvAndUnpack(T1& numberer, int hardSource, bool useHardSource);
 
-    /**
-     * @brief Register the MPI datatype for the MessageInformation.
-     */
-    void registerMessageDatatype();
-
     /**
      * @brief Insert an entry into the  remote index list if not yet present.
      */
@@ -556,12 +582,13 @@ namespace Dune
                                          GlobalIndexList& globalIndices,
                                          BoolList& booleans)
     : iterators_(remoteIndices.beginModify(), globalIndices.beginModify(),
-                 booleans.beginModify(), remoteIndices.end())
+                 booleans.beginModify(), remoteIndices.end()),
+      last_(), searched_(false)
   { }
 
   template<typename T>
   IndicesSyncer<T>::Iterators::Iterators()
-    : iterators_()
+    : iterators_(), last_(), searched_(false)
   {}
 
   template<typename T>
@@ -610,6 +637,7 @@ namespace Dune
     std::get<0>(iterators_) = remoteIndices.beginModify();
     std::get<1>(iterators_) = globalIndices.beginModify();
     std::get<2>(iterators_) = booleans.beginModify();
+    searched_ = false;
   }
 
   template<typename T>
@@ -625,111 +653,103 @@ namespace Dune
   }
 
   template<typename T>
-  void IndicesSyncer<T>::registerMessageDatatype()
+  inline bool IndicesSyncer<T>::Iterators::canSearch(const std::pair<GlobalIndex,Attribute>& global) const
   {
-    MPI_Datatype type[2] = {MPI_INT, MPI_INT};
-    int blocklength[2] = {1,1};
-    MPI_Aint displacement[2];
-    MPI_Aint base;
-
-    // Compute displacement
-    MessageInformation message;
-
-    MPI_Get_address( &(message.publish), displacement);
-    MPI_Get_address( &(message.pairs), displacement+1);
-
-    // Make the displacement relative
-    MPI_Get_address(&message, &base);
-    displacement[0] -= base;
-    displacement[1] -= base;
-
-    MPI_Type_create_struct( 2, blocklength, displacement, type, &datatype_);
-    MPI_Type_commit(&datatype_);
+    return searched_ && last_ < global;
   }
 
   template<typename T>
-  void IndicesSyncer<T>::calculateMessageSizes()
+  inline void IndicesSyncer<T>::Iterators::searched(const std::pair<GlobalIndex,Attribute>& global)
   {
-    auto iEnd = indexSet_.end();
-    auto collIter = remoteIndices_.template iterator<true>();
-
-    for(auto index = indexSet_.begin(); index != iEnd; ++index) {
-      collIter.advance(index->global(), index->local().attribute());
-      if(collIter.empty())
-        break;
-      int knownRemote=0;
-      auto end = collIter.end();
+    last_ = global;
+    searched_ = true;
+  }
 
-      // Count the remote indices we know.
-      for(auto valid = collIter.begin(); valid != end; ++valid) {
-        ++knownRemote;
+  namespace Impl
+  {
+    // The number of bytes of size values in a message of IndicesSyncer
+    template<class V>
+    std::size_t indicesSyncerArrayBytes(std::size_t size, MPI_Comm comm)
+    {
+      if constexpr (std::is_trivially_copyable<V>::value)
+        return size*sizeof(V);
+      else {
+        int bytes = 0;
+        MPI_Pack_size(size, MPITraits<V>::getType(), comm, &bytes);
+        return bytes;
       }
+    }
 
-      if(knownRemote>0) {
-        Dune::dverb<<rank_<<": publishing "<<knownRemote<<" for index "<<index->global()<< " for processes ";
-
-        // Update MessageInformation
-        for(auto valid = collIter.begin(); valid != end; ++valid) {
-          ++(infoSend_[valid.process()].publish);
-          (infoSend_[valid.process()].pairs) += knownRemote;
-          Dune::dverb<<valid.process()<<" ";
-          Dune::dverb<<"(publish="<<infoSend_[valid.process()].publish<<", pairs="<<infoSend_[valid.process()].pairs
-                     <<") ";
-        }
-        Dune::dverb<<std::endl;
+    template<class V>
+    void packIndicesSyncerArray(char*& buffer, const std::vector<V>& values, MPI_Comm comm)
+    {
+      const std::size_t bytes = indicesSyncerArrayBytes<V>(values.size(), comm);
+      if constexpr (std::is_trivially_copyable<V>::value) {
+        if(values.size())
+          std::memcpy(buffer, values.data(), bytes);
       }
+      else {
+        int position = 0;
+        MPI_Pack(const_cast<V*>(values.data()), values.size(), MPITraits<V>::getType(),
+                 buffer, bytes, &position, comm);
+      }
+      buffer += bytes;
     }
 
-    const auto end = infoSend_.end();
-
-    // Now determine the buffersizes needed for each neighbour using MPI_Pack_size
-    MessageInformation dummy;
-
-    auto messageIter= infoSend_.begin();
-    const auto rend = remoteIndices_.end();
-    int neighbour=0;
-
-    for(auto remote = remoteIndices_.begin(); remote != rend; ++remote, ++neighbour) {
-      MessageInformation* message;
-      MessageInformation recv;
-
-      if(messageIter != end && messageIter->first==remote->first) {
-        // We want to send message information to that process
-        message = const_cast<MessageInformation*>(&(messageIter->second));
-        ++messageIter;
-      }else
-        // We do not want to send information but the other process might.
-        message = &dummy;
-
-      sendBufferSizes_[neighbour]=0;
-      int tsize;
-      // The number of indices published
-      MPI_Pack_size(1, MPI_INT,remoteIndices_.communicator(), &tsize);
-      sendBufferSizes_[neighbour] += tsize;
-
-      for(int i=0; i < message->publish; ++i) {
-        // The global index
-        MPI_Pack_size(1, MPITraits<GlobalIndex>::getType(), remoteIndices_.communicator(), &tsize);
-        sendBufferSizes_[neighbour] += tsize;
-        // The attribute in the local index
-        MPI_Pack_size(1, MPI_CHAR, remoteIndices_.communicator(), &tsize);
-        sendBufferSizes_[neighbour] += tsize;
-        // The number of corresponding remote indices
-        MPI_Pack_size(1, MPI_INT, remoteIndices_.communicator(), &tsize);
-        sendBufferSizes_[neighbour] += tsize;
+    template<class V>
+    void unpackIndicesSyncerArray(const char*& buffer, std::vector<V>& values, std::size_t size,
+                                  MPI_Comm comm)
+    {
+      const std::size_t bytes = indicesSyncerArrayBytes<V>(size, comm);
+      values.resize(size);
+      if constexpr (std::is_trivially_copyable<V>::value) {
+        if(size)
+          std::memcpy(values.data(), buffer, bytes);
       }
-      for(int i=0; i < message->pairs; ++i) {
-        // The process of the remote index
-        MPI_Pack_size(1, MPI_INT, remoteIndices_.communicator(), &tsize);
-        sendBufferSizes_[neighbour] += tsize;
-        // The attribute of the remote index
-        MPI_Pack_size(1, MPI_CHAR, remoteIndices_.communicator(), &tsize);
-        sendBufferSizes_[neighbour] += tsize;
+      else {
+        int position = 0;
+        MPI_Unpack(const_cast<char*>(buffer), bytes, &position, values.data(), size,
+                   MPITraits<V>::getType(), comm);
       }
-
-      Dune::dverb<<rank_<<": Buffer (neighbour="<<remote->first<<") size is "<< sendBufferSizes_[neighbour]<<" for publish="<<message->publish<<" pairs="<<message->pairs<<std::endl;
+      buffer += bytes;
     }
+  } // end namespace Impl
 
+  template<typename T>
+  std::size_t IndicesSyncer<T>::Message::bytes(MPI_Comm comm) const
+  {
+    return 2*sizeof(std::size_t)
+           + Impl::indicesSyncerArrayBytes<GlobalIndex>(globals.size(), comm)
+           + globals.size()*(sizeof(char)+sizeof(int))
+           + processes.size()*(sizeof(int)+sizeof(char));
+  }
+
+  template<typename T>
+  void IndicesSyncer<T>::Message::pack(char* buffer, MPI_Comm comm) const
+  {
+    assert(attributes.size()==globals.size() && counts.size()==globals.size());
+    assert(remoteAttributes.size()==processes.size());
+    std::size_t sizes[2] = {globals.size(), processes.size()};
+    std::memcpy(buffer, sizes, sizeof(sizes));
+    buffer += sizeof(sizes);
+    Impl::packIndicesSyncerArray(buffer, globals, comm);
+    Impl::packIndicesSyncerArray(buffer, attributes, comm);
+    Impl::packIndicesSyncerArray(buffer, counts, comm);
+    Impl::packIndicesSyncerArray(buffer, processes, comm);
+    Impl::packIndicesSyncerArray(buffer, remoteAttributes, comm);
+  }
+
+  template<typename T>
+  void IndicesSyncer<T>::Message::unpack(const char* buffer, MPI_Comm comm)
+  {
+    std::size_t sizes[2];
+    std::memcpy(sizes, buffer, sizeof(sizes));
+    buffer += sizeof(sizes);
+    Impl::unpackIndicesSyncerArray(buffer, globals, sizes[0], comm);
+    Impl::unpackIndicesSyncerArray(buffer, attributes, sizes[0], comm);
+    Impl::unpackIndicesSyncerArray(buffer, counts, sizes[0], comm);
+    Impl::unpackIndicesSyncerArray(buffer, processes, sizes[1], comm);
+    Impl::unpackIndicesSyncerArray(buffer, remoteAttributes, sizes[1], comm);
   }
 
   template<typename T>
@@ -743,6 +763,7 @@ namespace Dune
   template<typename T1>
   void IndicesSyncer<T>::sync(T1& numberer, bool useFixedOrder)
   {
+    DUNE_COMMUNICATION_SCOPE("IndicesSyncer::sync");
     // The pointers to the local indices in the remote indices
     // will become invalid due to the resorting of the index set.
     // Therefore store the corresponding global indices.
@@ -752,8 +773,8 @@ namespace Dune
     // Number of neighbours might change during the syncing.
     // save the old neighbours
     std::size_t noOldNeighbours = remoteIndices_.neighbours();
+    DUNE_COMMUNICATION_NEIGHBOURS(noOldNeighbours);
     int* oldNeighbours = new int[noOldNeighbours];
-    sendBufferSizes_ = new std::size_t[noOldNeighbours];
     std::size_t neighbourI = 0;
 
     for(auto remote = remoteIndices_.begin(); remote != end; ++remote, ++neighbourI) {
@@ -781,20 +802,6 @@ namespace Dune
       assert(checkReset(iteratorsMap_[remote->first], rList,global,added));
     }
 
-    // Exchange indices with each neighbour
-    calculateMessageSizes();
-
-    // Allocate the buffers
-    receiveBufferSize_=1;
-    sendBuffers_ = new char*[noOldNeighbours];
-
-    for(std::size_t i=0; i<noOldNeighbours; ++i) {
-      sendBuffers_[i] = new char[sendBufferSizes_[i]];
-      receiveBufferSize_ = std::max<int>(receiveBufferSize_, sendBufferSizes_[i]);
-    }
-
-    receiveBuffer_=new char[receiveBufferSize_];
-
     indexSet_.beginResize();
 
     Dune::dverb<<rank_<<": Neighbours: ";
@@ -808,8 +815,7 @@ namespace Dune
     MPI_Status* statuses = new MPI_Status[noOldNeighbours];
 
     // Pack Message data and start the sends
-    for(std::size_t i = 0; i<noOldNeighbours; ++i)
-      packAndSend(oldNeighbours[i], sendBuffers_[i], sendBufferSizes_[i], requests[i]);
+    packAndSend(oldNeighbours, noOldNeighbours, requests);
 
     // Probe for incoming messages, receive and unpack them
     for(std::size_t i = 0; i<noOldNeighbours; ++i)
@@ -820,11 +826,16 @@ namespace Dune
     //       }
     //     }
 
-    delete[] receiveBuffer_;
+    receiveBuffer_.clear();
 
     // Wait for the completion of the sends
     // Wait for completion of sends
-    if(MPI_SUCCESS!=MPI_Waitall(noOldNeighbours, requests, statuses)) {
+    int error;
+    {
+      DUNE_COMMUNICATION_WAIT_PHASE;
+      error = MPI_Waitall(noOldNeighbours, requests, statuses);
+    }
+    if(MPI_SUCCESS!=error) {
       std::cerr<<": MPI_Error occurred while sending message"<<std::endl;
       for(std::size_t i=0; i< noOldNeighbours; i++)
         if(MPI_SUCCESS!=statuses[i].MPI_ERROR)
@@ -834,11 +845,7 @@ namespace Dune
     delete[] statuses;
     delete[] requests;
 
-    for(std::size_t i=0; i<noOldNeighbours; ++i)
-      delete[] sendBuffers_[i];
-
-    delete[] sendBuffers_;
-    delete[] sendBufferSizes_;
+    sendBuffers_.clear();
 
     // No need for the iterator tuples any more
     iteratorsMap_.clear();
@@ -857,102 +864,65 @@ namespace Dune
   }
 
   template<typename T>
-  void IndicesSyncer<T>::packAndSend(int destination, char* buffer, std::size_t bufferSize, MPI_Request& request)
+  void IndicesSyncer<T>::packAndSend(const int* neighbours, std::size_t noNeighbours,
+                                     MPI_Request* requests)
   {
-    auto iEnd       = indexSet_.end();
-    int bpos       = 0;
-    int published  = 0;
-    int pairs      = 0;
+    auto iEnd = indexSet_.end();
+    const auto iteratorsEnd = iteratorsMap_.end();
 
     assert(checkReset());
+    assert(iteratorsMap_.size() == noNeighbours);
 
-    // Pack the number of indices we publish
-    MPI_Pack(&(infoSend_[destination].publish), 1, MPI_INT, buffer, bufferSize, &bpos,
-             remoteIndices_.communicator());
+    std::vector<Message> messages(noNeighbours);
+    // The neighbours (position in neighbours) and the attributes of the remote
+    // indices present before calling sync at the current index.
+    std::vector<std::pair<std::size_t,char> > known;
 
     for(auto index = indexSet_.begin(); index != iEnd; ++index) {
-      // Search for corresponding remote indices in all iterator tuples
-      auto iteratorsEnd = iteratorsMap_.end();
+      known.clear();
+      std::size_t neighbour = 0;
 
-      // advance all iterators to a position with global index >= index->global()
-      for(auto iterators = iteratorsMap_.begin(); iteratorsEnd != iterators; ++iterators) {
+      // Advance all iterators to a position with global index >= index->global()
+      // and collect the remote indices that were already present before calling sync.
+      for(auto iterators = iteratorsMap_.begin(); iteratorsEnd != iterators; ++iterators, ++neighbour) {
+        assert(iterators->first == neighbours[neighbour]);
         while(iterators->second.isNotAtEnd() &&
               iterators->second.globalIndexPair().first < index->global())
           ++(iterators->second);
-        assert(!iterators->second.isNotAtEnd() || iterators->second.globalIndexPair().first >= index->global());
-      }
-
-      // Add all remote indices positioned at global which were already present before calling sync
-      // to the message.
-      // Count how many remote indices we will send
-      int indices = 0;
-      bool knownRemote = false; // Is the remote process supposed to know this index?
-
-      for(auto iterators = iteratorsMap_.begin(); iteratorsEnd != iterators; ++iterators)
-      {
-        std::pair<GlobalIndex,Attribute> p;
-        if (iterators->second.isNotAtEnd())
-        {
-          p = iterators->second.globalIndexPair();
-        }
-
         if(iterators->second.isNotAtEnd() && iterators->second.isOld()
-           && iterators->second.globalIndexPair().first == index->global()) {
-          indices++;
-          if(destination == iterators->first)
-            knownRemote = true;
-        }
+           && iterators->second.globalIndexPair().first == index->global())
+          known.push_back(std::make_pair(neighbour, char(iterators->second.remoteIndex().attribute())));
       }
 
-      if(!knownRemote)
-        // We do not need to send any indices
-        continue;
-
-      Dune::dverb<<rank_<<": sending "<<indices<<" for index "<<index->global()<<" to "<<destination<<std::endl;
-
-
-      // Pack the global index, the attribute and the number
-      MPI_Pack(const_cast<GlobalIndex*>(&(index->global())), 1, MPITraits<GlobalIndex>::getType(), buffer, bufferSize, &bpos,
-               remoteIndices_.communicator());
-
-      char attr = index->local().attribute();
-      MPI_Pack(&attr, 1, MPI_CHAR, buffer, bufferSize, &bpos,
-               remoteIndices_.communicator());
-
-      // Pack the number of remote indices we send.
-      MPI_Pack(&indices, 1, MPI_INT, buffer, bufferSize, &bpos,
-               remoteIndices_.communicator());
-
-      // Pack the information about the remote indices
-      for(auto iterators = iteratorsMap_.begin(); iteratorsEnd != iterators; ++iterators)
-        if(iterators->second.isNotAtEnd() && iterators->second.isOld()
-           && iterators->second.globalIndexPair().first == index->global()) {
-          int process = iterators->first;
-
-          ++pairs;
-          assert(pairs <= infoSend_[destination].pairs);
-          MPI_Pack(&process, 1, MPI_INT, buffer, bufferSize, &bpos,
-                   remoteIndices_.communicator());
-          char attr2 = iterators->second.remoteIndex().attribute();
-
-          MPI_Pack(&attr2, 1, MPI_CHAR, buffer, bufferSize, &bpos,
-                   remoteIndices_.communicator());
-          --indices;
+      // Publish the index with all its remote indices to all processes knowing it.
+      for(const auto& destination : known) {
+        Message& message = messages[destination.first];
+        message.globals.push_back(index->global());
+        message.attributes.push_back(index->local().attribute());
+        message.counts.push_back(known.size());
+        for(const auto& remote : known) {
+          message.processes.push_back(neighbours[remote.first]);
+          message.remoteAttributes.push_back(remote.second);
         }
-      assert(indices==0);
-      ++published;
-      Dune::dvverb<<" (publish="<<published<<", pairs="<<pairs<<")"<<std::endl;
-      assert(published <= infoSend_[destination].publish);
+      }
     }
-
-    // Make sure we send all expected entries
-    assert(published == infoSend_[destination].publish);
-    assert(pairs == infoSend_[destination].pairs);
     resetIteratorsMap();
 
-    Dune::dverb << rank_<<": Sending message of "<<bpos<<" bytes to "<<destination<<std::endl;
+    sendBuffers_.resize(noNeighbours);
+    for(std::size_t i = 0; i < noNeighbours; ++i) {
+      {
+        DUNE_COMMUNICATION_PACK_PHASE;
+        sendBuffers_[i].resize(messages[i].bytes(remoteIndices_.communicator()));
+        messages[i].pack(sendBuffers_[i].data(), remoteIndices_.communicator());
+      }
+
+      Dune::dverb << rank_<<": Sending message of "<<sendBuffers_[i].size()<<" bytes publishing "
+                  <<messages[i].globals.size()<<" indices to "<<neighbours[i]<<std::endl;
 
-    MPI_Issend(buffer, bpos, MPI_PACKED, destination, 345, remoteIndices_.communicator(),&request);
+      MPI_Issend(sendBuffers_[i].data(), sendBuffers_[i].size(), MPI_BYTE, neighbours[i], 345,
+                 remoteIndices_.communicator(), &requests[i]);
+      DUNE_COMMUNICATION_MESSAGE(sendBuffers_[i].size());
+    }
   }
 
   template<typename T>
@@ -963,8 +933,6 @@ namespace Dune
     Dune::dverb<<"Inserting from "<<process<<" "<<globalPair.first<<", "<<
     globalPair.second<<" "<<attribute<<std::endl;
 
-    resetIteratorsMap();
-
     // There might be cases where there no remote indices for that process yet
     typename IteratorsMap::iterator found = iteratorsMap_.find(process);
 
@@ -978,6 +946,14 @@ namespace Dune
 
     Iterators& iterators = found->second;
 
+    // The pairs of a message arrive in ascending order. Thus we merge them
+    // into the list and only start from the beginning if a pair is not
+    // larger than the last one.
+    if(!iterators.canSearch(globalPair))
+      iterators.reset(*(remoteIndices_.remoteIndices_.find(process)->second.first),
+                      globalMap_[process], oldMap_[process]);
+    iterators.searched(globalPair);
+
     // Search for the remote index
     while(iterators.isNotAtEnd() && iterators.globalIndexPair() < globalPair) {
       // Increment all iterators
@@ -997,8 +973,8 @@ namespace Dune
     for(Iterators tmpIterators = iterators;
         !tmpIterators.isAtEnd() && tmpIterators.globalIndexPair() == globalPair;
         ++tmpIterators)
-      //entry already exists with the same attribute
-      if(tmpIterators.globalIndexPair().second == attribute) {
+      //entry already exists with the same remote attribute
+      if(tmpIterators.remoteIndex().attribute() == attribute) {
         indexIsThere=true;
         break;
       }
@@ -1016,8 +992,6 @@ namespace Dune
     const ParallelIndexSet& constIndexSet = indexSet_;
     auto iEnd   = constIndexSet.end();
     auto index  = constIndexSet.begin();
-    int bpos   = 0;
-    int publish;
 
     assert(checkReset());
 
@@ -1025,59 +999,50 @@ namespace Dune
 
     // We have to determine the message size and source before the receive
 
-    MPI_Probe(useHardSource ? hardSource : MPI_ANY_SOURCE, 345, remoteIndices_.communicator(), &status);
+    int source, count;
+    {
+      DUNE_COMMUNICATION_WAIT_PHASE;
+      MPI_Probe(useHardSource ? hardSource : MPI_ANY_SOURCE, 345, remoteIndices_.communicator(), &status);
 
-    int source=status.MPI_SOURCE;
-    int count;
-    MPI_Get_count(&status, MPI_PACKED, &count);
+      source=status.MPI_SOURCE;
+      MPI_Get_count(&status, MPI_BYTE, &count);
 
-    Dune::dvverb<<rank_<<": Receiving message from "<< source<<" with "<<count<<" bytes"<<std::endl;
+      Dune::dvverb<<rank_<<": Receiving message from "<< source<<" with "<<count<<" bytes"<<std::endl;
 
-    if(count>receiveBufferSize_) {
-      receiveBufferSize_=count;
-      delete[] receiveBuffer_;
-      receiveBuffer_ = new char[receiveBufferSize_];
+      receiveBuffer_.resize(count);
+      MPI_Recv(receiveBuffer_.data(), count, MPI_BYTE, source, 345, remoteIndices_.communicator(), &status);
     }
 
-    MPI_Recv(receiveBuffer_, count, MPI_PACKED, source, 345, remoteIndices_.communicator(), &status);
-
-    // How many global entries were published?
-    MPI_Unpack(receiveBuffer_,  count, &bpos, &publish, 1, MPI_INT, remoteIndices_.communicator());
+    Message& message = receiveMessage_;
+    {
+      DUNE_COMMUNICATION_PACK_PHASE;
+      message.unpack(receiveBuffer_.data(), remoteIndices_.communicator());
+    }
 
-    // Now unpack the remote indices and add them.
-    while(publish>0) {
+    // The processes and attributes to insert into the remote index lists
+    std::vector<std::pair<int,Attribute> > sourceAttributeList;
+    std::size_t pair = 0;
 
-      // Unpack information about the local index on the source process
-      GlobalIndex global;           // global index of the current entry
-      char sourceAttribute; // Attribute on the source process
-      int pairs;
+    // Now add the remote indices of the published global entries.
+    for(std::size_t published = 0; published < message.globals.size(); ++published) {
 
-      MPI_Unpack(receiveBuffer_,  count, &bpos, &global, 1, MPITraits<GlobalIndex>::getType(),
-                 remoteIndices_.communicator());
-      MPI_Unpack(receiveBuffer_,  count, &bpos, &sourceAttribute, 1, MPI_CHAR,
-                 remoteIndices_.communicator());
-      MPI_Unpack(receiveBuffer_,  count, &bpos, &pairs, 1, MPI_INT,
-                 remoteIndices_.communicator());
+      // The information about the local index on the source process
+      const GlobalIndex& global = message.globals[published];
 
       // Insert the entry on the remote process to our
       // remote index list
-      SLList<std::pair<int,Attribute> > sourceAttributeList;
-      sourceAttributeList.push_back(std::make_pair(source,Attribute(sourceAttribute)));
+      sourceAttributeList.clear();
+      sourceAttributeList.push_back(std::make_pair(source,Attribute(message.attributes[published])));
 #ifndef NDEBUG
       bool foundSelf = false;
 #endif
       Attribute myAttribute=Attribute();
 
-      // Unpack the remote indices
-      for(; pairs>0; --pairs) {
-        // Unpack the process id that knows the index
-        int process;
-        char attribute;
-        MPI_Unpack(receiveBuffer_,  count, &bpos, &process, 1, MPI_INT,
-                   remoteIndices_.communicator());
-        // Unpack the attribute
-        MPI_Unpack(receiveBuffer_,  count, &bpos, &attribute, 1, MPI_CHAR,
-                   remoteIndices_.communicator());
+      // The remote indices
+      for(const std::size_t pairsEnd = pair + message.counts[published]; pair < pairsEnd; ++pair) {
+        // The process id that knows the index and its attribute
+        int process = message.processes[pair];
+        char attribute = message.remoteAttributes[pair];
 
         if(process==rank_) {
 #ifndef NDEBUG
@@ -1122,13 +1087,11 @@ namespace Dune
       }
       assert(foundSelf);
       // Insert remote indices
-      typedef typename SLList<std::pair<int,Attribute> >::const_iterator Iter;
-      for(Iter i=sourceAttributeList.begin(), end=sourceAttributeList.end();
-          i!=end; ++i)
-        insertIntoRemoteIndexList(i->first, std::make_pair(global, myAttribute),
-                                  i->second);
-      --publish;
+      for(const auto& sourceAttribute : sourceAttributeList)
+        insertIntoRemoteIndexList(sourceAttribute.first, std::make_pair(global, myAttribute),
+                                  sourceAttribute.second);
     }
+    assert(pair == message.processes.size());
 
     resetIteratorsMap();
   }
@@ -12,6 +12,7 @@
 #include <iostream>
 #include <map>
 #include <tuple>
+#include <vector>
 
 #include <mpi.h>
 
@@ -203,6 +204,52 @@ namespace Dune
     std::size_t* indices_;
   };
 
+  /**
+   * @brief The MPI calls used by a communicator to exchange the messages
+   * along an interface.
+   */
+  enum class CommunicationBackend
+  {
+    /** @brief Nonblocking point-to-point messages to and from each neighbour. */
+    pointToPoint,
+    /**
+     * @brief Neighbourhood collectives on a distributed graph topology
+     * built from the interface.
+     */
+    neighborhoodCollective
+  };
+
+  namespace Impl
+  {
+    /**
+     * @brief Create a distributed graph communicator whose neighbours are
+     * the processes of an interface map.
+     *
+     * The neighbours are the keys of the map in ascending order and are used
+     * as both sources and destinations. Thus the interface has to be
+     * symmetric, i.e. each process has to be part of the interface of all
+     * of its neighbours. This is a collective operation on comm.
+     *
+     * @param comm The communicator the ranks refer to.
+     * @param interfaces The map from rank to the interface information.
+     * @return The new communicator. Has to be freed with MPI_Comm_free.
+     */
+    template<class M>
+    MPI_Comm createNeighborhoodCommunicator(MPI_Comm comm, const M& interfaces)
+    {
+      std::vector<int> neighbours;
+      neighbours.reserve(interfaces.size());
+      for(const auto& entry : interfaces)
+        neighbours.push_back(entry.first);
+
+      MPI_Comm graph;
+      MPI_Dist_graph_create_adjacent(comm, neighbours.size(), neighbours.data(), MPI_UNWEIGHTED,
+                                     neighbours.size(), neighbours.data(), MPI_UNWEIGHTED,
+                                     MPI_INFO_NULL, false, &graph);
+      return graph;
+    }
+  } // end namespace Impl
+
   /** @addtogroup Common_Parallel
    *
    * @{
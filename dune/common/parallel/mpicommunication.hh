@@ -16,14 +16,21 @@
 #if HAVE_MPI
 
 #include <algorithm>
+#include <cassert>
 #include <functional>
 #include <memory>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <mpi.h>
 
 #include <dune/common/binaryfunctions.hh>
 #include <dune/common/exceptions.hh>
 #include <dune/common/parallel/communication.hh>
+#include <dune/common/parallel/communicationstatistics.hh>
+#include <dune/common/parallel/hierarchicalcommunication.hh>
 #include <dune/common/parallel/mpitraits.hh>
 #include <dune/common/parallel/mpifuture.hh>
 #include <dune/common/parallel/mpidata.hh>
@@ -94,6 +101,86 @@ namespace Dune
 
 #undef ComposeMPIOp
 
+  namespace Impl
+  {
+    /**
+     * @brief Selects the MPI operation for reducing with BinaryFunction.
+     *
+     * Type is the type passed to the reduction. The generic version uses
+     * Generic_MPI_Op and leaves count and datatype unchanged.
+     */
+    template<class Type, class BinaryFunction, class Enable=void>
+    struct MPIReduction
+    {
+      static MPI_Op prepare(int&, MPI_Datatype&)
+      {
+        return Generic_MPI_Op<Type, BinaryFunction>::get();
+      }
+    };
+
+    /**
+     * @brief Summation of FieldVectors with intrinsic field type.
+     *
+     * Arrays of FieldVector<K,n> are summed up as n times as many scalars
+     * with MPI_SUM instead of a user defined operation.
+     */
+    template<class Type, class K, int n>
+    struct MPIReduction<Type, std::plus<FieldVector<K,n> >,
+                        std::enable_if_t<MPITraits<K>::is_intrinsic> >
+    {
+      static MPI_Op prepare(int& count, MPI_Datatype& datatype)
+      {
+        static_assert(sizeof(FieldVector<K,n>) == n*sizeof(K),
+                      "FieldVector has to be stored contiguously");
+        if (datatype == MPITraits<FieldVector<K,n> >::getType()) {
+          count *= n;
+          datatype = MPITraits<K>::getType();
+        }
+        assert(datatype == MPITraits<K>::getType());
+        return MPI_SUM;
+      }
+    };
+
+    //! The predefined MPI datatype of the pair (T, int), if any.
+    template<class T>
+    struct MPILocType;
+
+#define ComposeMPILocType(T,type)                                       \
+    template<>                                                          \
+    struct MPILocType<T>{                                               \
+      static MPI_Datatype get(){                                        \
+        return type;                                                    \
+      }                                                                 \
+    }
+
+    ComposeMPILocType(float, MPI_FLOAT_INT);
+    ComposeMPILocType(double, MPI_DOUBLE_INT);
+    ComposeMPILocType(long double, MPI_LONG_DOUBLE_INT);
+    ComposeMPILocType(short, MPI_SHORT_INT);
+    ComposeMPILocType(int, MPI_2INT);
+    ComposeMPILocType(long, MPI_LONG_INT);
+
+#undef ComposeMPILocType
+
+#define ComposeMPILocOp(func,op)                                        \
+    template<class Type, class T>                                       \
+    struct MPIReduction<Type, func<std::pair<T,int> >,                  \
+                        std::void_t<decltype(MPILocType<T>::get())> >{  \
+      static MPI_Op prepare(int&, MPI_Datatype& datatype){              \
+        if (datatype == MPITraits<std::pair<T,int> >::getType())        \
+          datatype = MPILocType<T>::get();                              \
+        assert(datatype == MPILocType<T>::get());                       \
+        return op;                                                      \
+      }                                                                 \
+    }
+
+    ComposeMPILocOp(MinLoc, MPI_MINLOC);
+    ComposeMPILocOp(MaxLoc, MPI_MAXLOC);
+
+#undef ComposeMPILocOp
+
+  } // end namespace Impl
+
 
   //=======================================================
   // use singleton pattern and template specialization to
@@ -129,6 +216,33 @@ namespace Dune
       : Communication(MPI_COMM_SELF)
     {}
 
+    /** @brief Switches on the hierarchical mode.
+     *
+     * In hierarchical mode the processes sharing memory are grouped.
+     * allreduce (and thus sum, prod, min and max), broadcast, allgather
+     * and allgatherv exchange the data within a group through a shared
+     * memory window, and only one process per group communicates with
+     * the other groups. Data whose MPI datatype is not stored
+     * contiguously is communicated as before.
+     *
+     * This method is collective. Copies of this object made afterwards
+     * share the mode, the last of them has to be destroyed collectively
+     * before MPI is finalized.
+     *
+     * @param groupSize If positive, the processes of a node are split
+     * into groups of at most this size, e.g. one per socket.
+     */
+    void enableHierarchicalMode (int groupSize = 0)
+    {
+      hierarchical = std::make_shared<Impl::HierarchicalCommunication>(communicator, groupSize);
+    }
+
+    //! Whether the hierarchical mode is switched on, see enableHierarchicalMode().
+    bool hierarchicalMode () const
+    {
+      return (bool)hierarchical;
+    }
+
     //! @copydoc Communication::rank
     int rank () const
     {
@@ -271,6 +385,8 @@ namespace Dune
     //! @copydoc Communication::barrier
     int barrier () const
     {
+      DUNE_COMMUNICATION_SCOPE("Communication::barrier");
+      DUNE_COMMUNICATION_WAIT_PHASE;
       return MPI_Barrier(communicator);
     }
 
@@ -287,6 +403,12 @@ namespace Dune
     template<typename T>
     int broadcast (T* inout, int len, int root) const
     {
+      DUNE_COMMUNICATION_SCOPE("Communication::broadcast");
+      if (me == root)
+        DUNE_COMMUNICATION_MESSAGE(len*sizeof(T));
+      DUNE_COMMUNICATION_WAIT_PHASE;
+      if (useHierarchical(MPITraits<T>::getType()))
+        return hierarchical->broadcast(inout,len,MPITraits<T>::getType(),root);
       return MPI_Bcast(inout,len,MPITraits<T>::getType(),root,communicator);
     }
 
@@ -309,6 +431,9 @@ namespace Dune
     template<typename T>
     int gather (const T* in, T* out, int len, int root) const
     {
+      DUNE_COMMUNICATION_SCOPE("Communication::gather");
+      DUNE_COMMUNICATION_MESSAGE(len*sizeof(T));
+      DUNE_COMMUNICATION_WAIT_PHASE;
       return MPI_Gather(const_cast<T*>(in),len,MPITraits<T>::getType(),
                         out,len,MPITraits<T>::getType(),
                         root,communicator);
@@ -332,6 +457,9 @@ namespace Dune
     template<typename T>
     int gatherv (const T* in, int sendDataLen, T* out, int* recvDataLen, int* displ, int root) const
     {
+      DUNE_COMMUNICATION_SCOPE("Communication::gatherv");
+      DUNE_COMMUNICATION_MESSAGE(sendDataLen*sizeof(T));
+      DUNE_COMMUNICATION_WAIT_PHASE;
       return MPI_Gatherv(const_cast<T*>(in),sendDataLen,MPITraits<T>::getType(),
                          out,recvDataLen,displ,MPITraits<T>::getType(),
                          root,communicator);
@@ -342,6 +470,10 @@ namespace Dune
     template<typename T>
     int scatter (const T* sendData, T* recvData, int len, int root) const
     {
+      DUNE_COMMUNICATION_SCOPE("Communication::scatter");
+      if (me == root)
+        DUNE_COMMUNICATION_MESSAGE(procs*len*sizeof(T));
+      DUNE_COMMUNICATION_WAIT_PHASE;
       return MPI_Scatter(const_cast<T*>(sendData),len,MPITraits<T>::getType(),
                          recvData,len,MPITraits<T>::getType(),
                          root,communicator);
@@ -365,6 +497,10 @@ namespace Dune
     template<typename T>
     int scatterv (const T* sendData, int* sendDataLen, int* displ, T* recvData, int recvDataLen, int root) const
     {
+      DUNE_COMMUNICATION_SCOPE("Communication::scatterv");
+      if (me == root)
+        DUNE_COMMUNICATION_MESSAGE(std::accumulate(sendDataLen, sendDataLen+procs, std::size_t(0))*sizeof(T));
+      DUNE_COMMUNICATION_WAIT_PHASE;
       return MPI_Scatterv(const_cast<T*>(sendData),sendDataLen,displ,MPITraits<T>::getType(),
                           recvData,recvDataLen,MPITraits<T>::getType(),
                           root,communicator);
@@ -380,6 +516,16 @@ namespace Dune
     template<typename T, typename T1>
     int allgather(const T* sbuf, int count, T1* rbuf) const
     {
+      DUNE_COMMUNICATION_SCOPE("Communication::allgather");
+      DUNE_COMMUNICATION_MESSAGE(count*sizeof(T));
+      DUNE_COMMUNICATION_WAIT_PHASE;
+      if (std::is_same<T,T1>::value && useHierarchical(MPITraits<T>::getType())) {
+        std::vector<int> counts(procs, count), displ(procs);
+        for (int i=0; i<procs; ++i)
+          displ[i] = i*count;
+        return hierarchical->allgatherv(sbuf, count, rbuf, counts.data(), displ.data(),
+                                        MPITraits<T>::getType());
+      }
       return MPI_Allgather(const_cast<T*>(sbuf), count, MPITraits<T>::getType(),
                            rbuf, count, MPITraits<T1>::getType(),
                            communicator);
@@ -404,6 +550,12 @@ namespace Dune
     template<typename T>
     int allgatherv (const T* in, int sendDataLen, T* out, int* recvDataLen, int* displ) const
     {
+      DUNE_COMMUNICATION_SCOPE("Communication::allgatherv");
+      DUNE_COMMUNICATION_MESSAGE(sendDataLen*sizeof(T));
+      DUNE_COMMUNICATION_WAIT_PHASE;
+      if (useHierarchical(MPITraits<T>::getType()))
+        return hierarchical->allgatherv(in, sendDataLen, out, recvDataLen, displ,
+                                        MPITraits<T>::getType());
       return MPI_Allgatherv(const_cast<T*>(in),sendDataLen,MPITraits<T>::getType(),
                             out,recvDataLen,displ,MPITraits<T>::getType(),
                             communicator);
@@ -420,13 +572,21 @@ namespace Dune
       return ret;
     }
 
+    //! @copydoc Communication::allreduce(Type&& in) const
     template<typename BinaryFunction, typename Type>
     Type allreduce(Type&& in) const{
+      DUNE_COMMUNICATION_SCOPE("Communication::allreduce");
       Type lvalue_data = std::forward<Type>(in);
       auto data = getMPIData(lvalue_data);
-      MPI_Allreduce(MPI_IN_PLACE, data.ptr(), data.size(), data.type(),
-                    (Generic_MPI_Op<Type, BinaryFunction>::get()),
-                    communicator);
+      int count = data.size();
+      MPI_Datatype datatype = data.type();
+      MPI_Op op = Impl::MPIReduction<std::decay_t<Type>, BinaryFunction>::prepare(count, datatype);
+      DUNE_COMMUNICATION_MESSAGE(Impl::communicatedBytes(count, datatype));
+      DUNE_COMMUNICATION_WAIT_PHASE;
+      if (useHierarchical(datatype))
+        hierarchical->allreduce(MPI_IN_PLACE, data.ptr(), count, datatype, op);
+      else
+        MPI_Allreduce(MPI_IN_PLACE, data.ptr(), count, datatype, op, communicator);
       return lvalue_data;
     }
 
@@ -438,9 +598,10 @@ namespace Dune
       auto mpidata_out = future.get_mpidata();
       assert(mpidata_out.size() == mpidata_in.size());
       assert(mpidata_out.type() == mpidata_in.type());
-      MPI_Iallreduce(mpidata_in.ptr(), mpidata_out.ptr(),
-                     mpidata_out.size(), mpidata_out.type(),
-                     (Generic_MPI_Op<TIN, BinaryFunction>::get()),
+      int count = mpidata_out.size();
+      MPI_Datatype datatype = mpidata_out.type();
+      MPI_Op op = Impl::MPIReduction<std::decay_t<TIN>, BinaryFunction>::prepare(count, datatype);
+      MPI_Iallreduce(mpidata_in.ptr(), mpidata_out.ptr(), count, datatype, op,
                      communicator, &future.req_);
       return future;
     }
@@ -450,9 +611,10 @@ namespace Dune
     MPIFuture<T> iallreduce(T&& data) const{
       MPIFuture<T> future(std::forward<T>(data));
       auto mpidata = future.get_mpidata();
-      MPI_Iallreduce(MPI_IN_PLACE, mpidata.ptr(),
-                     mpidata.size(), mpidata.type(),
-                     (Generic_MPI_Op<T, BinaryFunction>::get()),
+      int count = mpidata.size();
+      MPI_Datatype datatype = mpidata.type();
+      MPI_Op op = Impl::MPIReduction<std::decay_t<T>, BinaryFunction>::prepare(count, datatype);
+      MPI_Iallreduce(MPI_IN_PLACE, mpidata.ptr(), count, datatype, op,
                      communicator, &future.req_);
       return future;
     }
@@ -461,14 +623,26 @@ namespace Dune
     template<typename BinaryFunction, typename Type>
     int allreduce(const Type* in, Type* out, int len) const
     {
-      return MPI_Allreduce(const_cast<Type*>(in), out, len, MPITraits<Type>::getType(),
-                           (Generic_MPI_Op<Type, BinaryFunction>::get()),communicator);
+      DUNE_COMMUNICATION_SCOPE("Communication::allreduce");
+      DUNE_COMMUNICATION_MESSAGE(len*sizeof(Type));
+      DUNE_COMMUNICATION_WAIT_PHASE;
+      MPI_Datatype datatype = MPITraits<Type>::getType();
+      MPI_Op op = Impl::MPIReduction<Type, BinaryFunction>::prepare(len, datatype);
+      if (useHierarchical(datatype))
+        return hierarchical->allreduce(in, out, len, datatype, op);
+      return MPI_Allreduce(const_cast<Type*>(in), out, len, datatype, op, communicator);
     }
 
   private:
+    bool useHierarchical (MPI_Datatype datatype) const
+    {
+      return hierarchical && Impl::HierarchicalCommunication::supports(datatype);
+    }
+
     MPI_Comm communicator;
     int me;
     int procs;
+    std::shared_ptr<Impl::HierarchicalCommunication> hierarchical;
   };
 } // namespace dune
 
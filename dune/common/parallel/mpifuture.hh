@@ -7,11 +7,14 @@
 
 #if HAVE_MPI
 
+#include <cstddef>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <optional>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <mpi.h>
 
@@ -83,6 +86,18 @@ namespace Dune{
       }
       void get(){}
     };
+
+    // Gives access to the request and status of MPIFutures
+    struct MPIFutureAccess{
+      template<class F>
+      static MPI_Request& request(F& future){
+        return future.req_;
+      }
+      template<class F>
+      static MPI_Status& status(F& future){
+        return future.status_;
+      }
+    };
   }
 
   /*! \brief Provides a future-like object for MPI communication.  It contains
@@ -96,6 +111,7 @@ namespace Dune{
     Impl::Buffer<R> data_;
     Impl::Buffer<S> send_data_;
     friend class Communication<MPI_Comm>;
+    friend struct Impl::MPIFutureAccess;
   public:
     MPIFuture(bool valid = false)
       : req_(MPI_REQUEST_NULL)
@@ -179,6 +195,85 @@ namespace Dune{
     }
   };
 
+  namespace Impl{
+    // The requests of a range of MPIFutures
+    template<class Range>
+    std::vector<MPI_Request> collectRequests(Range& futures){
+      std::vector<MPI_Request> requests;
+      for(auto& future : futures){
+        if(!future.valid())
+          DUNE_THROW(InvalidFutureException, "The MPIFuture is not valid!");
+        requests.push_back(MPIFutureAccess::request(future));
+      }
+      return requests;
+    }
+  }
+
+  /*! \brief Waits until all MPIFutures in a range are completed.
+
+    All requests are passed to a single MPI_Waitall.
+   */
+  template<class Range>
+  void waitAll(Range& futures){
+    std::vector<MPI_Request> requests = Impl::collectRequests(futures);
+    std::vector<MPI_Status> statuses(requests.size());
+    MPI_Waitall(requests.size(), requests.data(), statuses.data());
+    std::size_t i = 0;
+    for(auto& future : futures){
+      Impl::MPIFutureAccess::request(future) = requests[i];
+      Impl::MPIFutureAccess::status(future) = statuses[i++];
+    }
+  }
+
+  /*! \brief Waits until one of the MPIFutures in a range is completed.
+
+    \returns the position of the completed future in the range or the
+    size of the range if all futures were completed before.
+   */
+  template<class Range>
+  std::size_t waitAny(Range& futures){
+    std::vector<MPI_Request> requests = Impl::collectRequests(futures);
+    int index;
+    MPI_Status status;
+    MPI_Waitany(requests.size(), requests.data(), &index, &status);
+    if(index == MPI_UNDEFINED)
+      return requests.size();
+    auto future = std::begin(futures);
+    std::advance(future, index);
+    Impl::MPIFutureAccess::request(*future) = requests[index];
+    Impl::MPIFutureAccess::status(*future) = status;
+    return index;
+  }
+
+  /*! \brief Waits until at least one of the MPIFutures in a range is
+    completed.
+
+    \returns the positions of all futures in the range completed by this
+    call. It is empty if all futures were completed before.
+   */
+  template<class Range>
+  std::vector<std::size_t> waitSome(Range& futures){
+    std::vector<MPI_Request> requests = Impl::collectRequests(futures);
+    std::vector<int> indices(requests.size());
+    std::vector<MPI_Status> statuses(requests.size());
+    int count;
+    MPI_Waitsome(requests.size(), requests.data(), &count, indices.data(), statuses.data());
+    std::vector<std::size_t> completed;
+    if(count == MPI_UNDEFINED)
+      return completed;
+    completed.assign(indices.begin(), indices.begin() + count);
+    std::size_t i = 0;
+    for(auto& future : futures){
+      Impl::MPIFutureAccess::request(future) = requests[i++];
+    }
+    for(int k = 0; k < count; ++k){
+      auto future = std::begin(futures);
+      std::advance(future, indices[k]);
+      Impl::MPIFutureAccess::status(*future) = statuses[k];
+    }
+    return completed;
+  }
+
 }
 #endif // HAVE_MPI
 #endif // DUNE_COMMON_PARALLEL_MPIFUTURE_HH
@@ -17,6 +17,10 @@
 #include <dune/common/parallel/communication.hh>
 #include <dune/common/parallel/mpicommunication.hh>
 
+#if DUNE_COMMUNICATION_STATISTICS
+#include <dune/common/parallel/communicationstatistics.hh>
+#endif
+
 #if HAVE_MPI
 #include <dune/common/stdstreams.hh>
 #endif
@@ -143,6 +147,19 @@ namespace Dune
       return singleton;
     }
 
+    /**
+     * @brief Get the singleton instance of the helper.
+     *
+     * The requested thread support level is ignored, as there is
+     * no MPI library that has to be thread-safe.
+     */
+    DUNE_EXPORT static FakeMPIHelper& instance([[maybe_unused]] int argc,
+                                               [[maybe_unused]] char** argv,
+                                               [[maybe_unused]] int requiredThreadLevel)
+    {
+      return instance();
+    }
+
     /**
      * @brief return rank of process, i.e. zero
      */
@@ -258,9 +275,47 @@ namespace Dune
      * @param argv The arguments provided to main.
      */
     DUNE_EXPORT static MPIHelper& instance(int* argc = nullptr, char*** argv = nullptr)
+    {
+      return instance(argc, argv, MPI_THREAD_SINGLE);
+    }
+
+    /**
+     * @brief Get the singleton instance of the helper and request a level
+     * of thread support.
+     *
+     * On the first call MPI is initialized with `MPI_Init_thread`:
+     * \code
+     * int main(int argc, char** argv){
+     *   auto& helper = MPIHelper::instance(argc, argv, MPI_THREAD_MULTIPLE);
+     *   if (helper.threadLevel() < MPI_THREAD_MULTIPLE)
+     *     ...
+     * }
+     * \endcode
+     *
+     * The level provided by the MPI library may be lower than the
+     * requested one, see threadLevel(). Afterwards, all arguments to
+     * this function will be ignored.
+     *
+     * @param argc The number of arguments provided to main.
+     * @param argv The arguments provided to main.
+     * @param requiredThreadLevel One of `MPI_THREAD_SINGLE`, `MPI_THREAD_FUNNELED`,
+     *        `MPI_THREAD_SERIALIZED` and `MPI_THREAD_MULTIPLE`.
+     */
+    DUNE_EXPORT static MPIHelper& instance(int& argc, char**& argv, int requiredThreadLevel)
+    {
+      return instance(&argc, &argv, requiredThreadLevel);
+    }
+
+    /**
+     * @brief Get the singleton instance of the helper and request a level
+     * of thread support.
+     *
+     * @relates instance(int&, char**&, int)
+     */
+    DUNE_EXPORT static MPIHelper& instance(int* argc, char*** argv, int requiredThreadLevel)
     {
       assert((argc == nullptr) == (argv == nullptr));
-      static MPIHelper instance{argc, argv};
+      static MPIHelper instance{argc, argv, requiredThreadLevel};
       return instance;
     }
 
@@ -273,6 +328,14 @@ namespace Dune
      */
     int size () const { return size_; }
 
+    /**
+     * @brief return the level of thread support provided by MPI
+     *
+     * The level may be lower than the one requested by instance(), or
+     * differ from it if MPI was not initialized by the MPIHelper.
+     */
+    int threadLevel () const { return threadLevel_; }
+
     //! \brief calls MPI_Finalize
     ~MPIHelper()
     {
@@ -280,6 +343,9 @@ namespace Dune
       MPI_Finalized( &wasFinalized );
       if(!wasFinalized && initializedHere_)
       {
+#if DUNE_COMMUNICATION_STATISTICS
+        CommunicationStatistics::instance().finalize(MPI_COMM_WORLD);
+#endif
         MPI_Finalize();
         dverb << "Called MPI_Finalize on p=" << rank_ << "!" <<std::endl;
       }
@@ -289,11 +355,12 @@ namespace Dune
   private:
     int rank_;
     int size_;
+    int threadLevel_;
     bool initializedHere_;
     void prevent_warning(int){}
 
-    //! \brief calls MPI_Init with argc and argv as parameters
-    MPIHelper(int* argc, char*** argv)
+    //! \brief calls MPI_Init_thread with argc and argv as parameters
+    MPIHelper(int* argc, char*** argv, int requiredThreadLevel)
     : initializedHere_(false)
     {
       int wasInitialized = -1;
@@ -302,10 +369,12 @@ namespace Dune
       {
         rank_ = -1;
         size_ = -1;
-        static int is_initialized = MPI_Init(argc, argv);
+        static int is_initialized = MPI_Init_thread(argc, argv, requiredThreadLevel, &threadLevel_);
         prevent_warning(is_initialized);
         initializedHere_ = true;
       }
+      else
+        MPI_Query_thread(&threadLevel_);
 
       MPI_Comm_rank(MPI_COMM_WORLD,&rank_);
       MPI_Comm_size(MPI_COMM_WORLD,&size_);
@@ -313,6 +382,11 @@ namespace Dune
       assert( rank_ >= 0 );
       assert( size_ >= 1 );
 
+#if DUNE_COMMUNICATION_STATISTICS
+      // construct the statistics first, so that they outlive the helper
+      CommunicationStatistics::instance();
+#endif
+
       dverb << "Called  MPI_Init on p=" << rank_ << "!" << std::endl;
     }
 
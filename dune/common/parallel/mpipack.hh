@@ -12,6 +12,13 @@
  * objects. All objects that can be used for MPI communication can
  * also be packed and unpacked to/from MPIPack.
  *
+ * If the MPI library packs in the native data representation, i.e.
+ * the processes are homogeneous, trivially copyable data is copied into
+ * the buffer with memcpy instead of MPI_Pack. The space needed for a
+ * message can be computed with packSize() and allocated at once with
+ * reserve() before packing. Buffers can be reused with clear() or
+ * with an MPIPackBufferPool.
+ *
  * @author Nils-Arne Dreier
  * @ingroup ParallelCommunication
  */
@@ -22,21 +29,44 @@
 
 #if HAVE_MPI
 
+#include <cstddef>
+#include <cstring>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <mpi.h>
 
+#include <dune/common/exceptions.hh>
 #include <dune/common/parallel/mpicommunication.hh>
 #include <dune/common/parallel/mpidata.hh>
 
 
 namespace Dune {
 
+  namespace Impl {
+
+    // The type of the elements described by MPIData<T>
+    template<class T, class = void>
+    struct MPIPackElement
+    {
+      using type = std::decay_t<T>;
+    };
+
+    template<class T>
+    struct MPIPackElement<T, std::void_t<typename std::decay_t<T>::value_type,
+                                         decltype(std::declval<T&>().data())>>
+    {
+      using type = typename std::decay_t<T>::value_type;
+    };
+
+  } // end namespace Impl
+
   class MPIPack {
     std::vector<char> _buffer;
     int _position;
     MPI_Comm _comm;
+    bool _native;
 
     friend struct MPIData<MPIPack>;
     friend struct MPIData<const MPIPack>;
@@ -45,8 +75,25 @@ namespace Dune {
       : _buffer(size)
       , _position(0)
       , _comm(comm)
+      , _native(packsNatively(comm))
     {}
 
+    /** @brief Constructs an MPIPack that reuses the memory of a buffer.
+     *
+     * The content of the buffer is discarded, its capacity is kept.
+     * \param buffer buffer e.g. obtained from release() or an MPIPackBufferPool
+     * \param size initial size of the internal buffer
+     */
+    MPIPack(Communication<MPI_Comm> comm, std::vector<char>&& buffer, std::size_t size = 0)
+      : _buffer(std::move(buffer))
+      , _position(0)
+      , _comm(comm)
+      , _native(packsNatively(comm))
+    {
+      _buffer.clear();
+      _buffer.resize(size);
+    }
+
     // Its not valid to copy a MPIPack but you can move it
     MPIPack(const MPIPack&) = delete;
     MPIPack& operator = (const MPIPack& other) = delete;
@@ -61,12 +108,18 @@ namespace Dune {
     template<class T>
     void pack(const T& data){
       auto mpidata = getMPIData(data);
-      int size = getPackSize(mpidata.size(), _comm, mpidata.type());
       constexpr bool has_static_size = decltype(getMPIData(std::declval<T&>()))::static_size;
-      if(!has_static_size)
-        size += getPackSize(1, _comm, MPI_INT);
+      int size = packedBytes<T>(mpidata, !has_static_size);
       if (_position + size > 0 && size_t(_position + size) > _buffer.size()) // resize buffer if necessary
         _buffer.resize(_position + size);
+      if(isTrivial<T>(mpidata)){
+        if(!has_static_size){
+          int size = mpidata.size();
+          copy(&size, sizeof(int));
+        }
+        copy(mpidata.ptr(), mpidata.size()*sizeof(typename Impl::MPIPackElement<T>::type));
+        return;
+      }
       if(!has_static_size){
         int size = mpidata.size();
         MPI_Pack(&size, 1, MPI_INT, _buffer.data(), _buffer.size(),
@@ -80,12 +133,18 @@ namespace Dune {
     /** @brief Unpacks data from the object
      *
      * @throw MPIError
+     * @throw RangeError if data copied with memcpy would be read beyond the
+     * end of the buffer. Otherwise MPI_Unpack reports this as an MPI error.
      */
     template<class T>
     auto /*void*/ unpack(T& data)
       -> std::enable_if_t<decltype(getMPIData(data))::static_size, void>
     {
       auto mpidata = getMPIData(data);
+      if(isTrivial<T>(mpidata)){
+        extract(mpidata.ptr(), mpidata.size()*sizeof(typename Impl::MPIPackElement<T>::type));
+        return;
+      }
       MPI_Unpack(_buffer.data(), _buffer.size(), &_position,
                  mpidata.ptr(), mpidata.size(),
                  mpidata.type(), _comm);
@@ -94,6 +153,8 @@ namespace Dune {
     /** @brief Unpacks data from the object
      *
      * @throw MPIError
+     * @throw RangeError if data copied with memcpy would be read beyond the
+     * end of the buffer. Otherwise MPI_Unpack reports this as an MPI error.
      */
     template<class T>
     auto /*void*/ unpack(T& data)
@@ -101,6 +162,12 @@ namespace Dune {
     {
       auto mpidata = getMPIData(data);
       int size = 0;
+      if(isTrivial<T>(mpidata)){
+        extract(&size, sizeof(int));
+        mpidata.resize(size);
+        extract(mpidata.ptr(), mpidata.size()*sizeof(typename Impl::MPIPackElement<T>::type));
+        return;
+      }
       MPI_Unpack(_buffer.data(), _buffer.size(), &_position,
                  &size, 1,
                  MPI_INT, _comm);
@@ -139,6 +206,42 @@ namespace Dune {
       return *this;
     }
 
+    /** @brief Returns the number of bytes needed to pack the data.
+     *
+     * Packing several objects into a buffer that was enlarged by the sum
+     * of their sizes with reserve() needs no further allocation.
+     */
+    template<class T>
+    int packSize(const T& data) const {
+      auto mpidata = getMPIData(data);
+      constexpr bool has_static_size = decltype(getMPIData(std::declval<T&>()))::static_size;
+      return packedBytes<T>(mpidata, !has_static_size);
+    }
+
+    /** @brief Enlarges the internal buffer such that size bytes can be
+     * packed at the current position without reallocation.
+     */
+    void reserve(std::size_t size){
+      if(_position + size > _buffer.size())
+        _buffer.resize(_position + size);
+    }
+
+    /** @brief Empties the buffer and resets the position. The allocated
+     * memory is kept for packing the next message.
+     */
+    void clear(){
+      _buffer.clear();
+      _position = 0;
+    }
+
+    /** @brief Moves the internal buffer out of the MPIPack, e.g. to return
+     * it to an MPIPackBufferPool. The MPIPack is empty afterwards.
+     */
+    std::vector<char> release(){
+      _position = 0;
+      return std::exchange(_buffer, std::vector<char>());
+    }
+
     /** @brief Resizes the internal buffer.
         \param size new size of internal buffer
      */
@@ -187,6 +290,24 @@ namespace Dune {
       return size;
     }
 
+    /** @brief Whether MPI_Pack stores data in the native representation
+     * for this communicator.
+     *
+     * Then packing trivially copyable data with memcpy gives the same
+     * bytes. This is checked by packing a test pattern.
+     */
+    static bool packsNatively(const MPI_Comm& comm){
+      const int i = 0x01020304;
+      const double d = 1.0/3.0;
+      char packed[64];
+      int position = 0;
+      MPI_Pack(&i, 1, MPI_INT, packed, sizeof(packed), &position, comm);
+      MPI_Pack(&d, 1, MPI_DOUBLE, packed, sizeof(packed), &position, comm);
+      return position == sizeof(int) + sizeof(double)
+        && std::memcmp(packed, &i, sizeof(int)) == 0
+        && std::memcmp(packed + sizeof(int), &d, sizeof(double)) == 0;
+    }
+
     friend bool operator==(const MPIPack& a, const MPIPack& b) {
       return  a._buffer == b._buffer && a._comm == b._comm;
     }
@@ -194,6 +315,78 @@ namespace Dune {
       return !(a==b);
     }
 
+  private:
+    // Whether the data is copied with memcpy instead of MPI_Pack
+    template<class T, class D>
+    bool isTrivial(D& mpidata) const {
+      using Element = typename Impl::MPIPackElement<T>::type;
+      if constexpr (std::is_trivially_copyable<Element>::value)
+        return _native && mpidata.type() == MPITraits<Element>::getType();
+      else
+        return false;
+    }
+
+    template<class T, class D>
+    int packedBytes(D& mpidata, bool withSize) const {
+      if(isTrivial<T>(mpidata))
+        return (withSize ? sizeof(int) : 0)
+          + mpidata.size()*sizeof(typename Impl::MPIPackElement<T>::type);
+      int size = getPackSize(mpidata.size(), _comm, mpidata.type());
+      if(withSize)
+        size += getPackSize(1, _comm, MPI_INT);
+      return size;
+    }
+
+    void copy(const void* data, std::size_t size){
+      std::memcpy(_buffer.data() + _position, data, size);
+      _position += size;
+    }
+
+    void extract(void* data, std::size_t size){
+      if(_position + size > _buffer.size())
+        DUNE_THROW(RangeError, "Unpacking beyond the end of the MPIPack");
+      std::memcpy(data, _buffer.data() + _position, size);
+      _position += size;
+    }
+  };
+
+  /** @brief A pool of buffers for MPIPack.
+   *
+   * Buffers returned to the pool keep their memory, such that packing
+   * messages of similar size repeatedly needs no new allocations.
+   * \code
+   * MPIPackBufferPool pool;
+   * MPIPack pack(comm, pool.get());
+   * pack << data;
+   * comm.send(pack, dest, tag);
+   * pool.put(pack.release());
+   * \endcode
+   */
+  class MPIPackBufferPool {
+    std::vector<std::vector<char>> _buffers;
+  public:
+    /** @brief Takes a buffer from the pool or creates a new one.
+     */
+    std::vector<char> get(){
+      if(_buffers.empty())
+        return std::vector<char>();
+      std::vector<char> buffer = std::move(_buffers.back());
+      _buffers.pop_back();
+      return buffer;
+    }
+
+    /** @brief Returns a buffer to the pool.
+     */
+    void put(std::vector<char>&& buffer){
+      if(buffer.capacity() > 0)
+        _buffers.push_back(std::move(buffer));
+    }
+
+    /** @brief The number of buffers in the pool.
+     */
+    std::size_t size() const {
+      return _buffers.size();
+    }
   };
 
   template<class P>
@@ -0,0 +1,278 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_PARALLEL_MPIPROGRESS_HH
+#define DUNE_COMMON_PARALLEL_MPIPROGRESS_HH
+
+/**
+ * @file
+ * @brief Runs continuations when MPIFutures complete.
+ * @ingroup ParallelCommunication
+ */
+
+#if HAVE_MPI
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <mpi.h>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/future.hh>
+#include <dune/common/parallel/mpifuture.hh>
+
+namespace Dune{
+
+  /*! \brief Runs continuations of MPIFutures as soon as their
+    communication is completed.
+
+    A continuation is registered with then() and called with the result of
+    the future. It may start further communication and register
+    continuations for it, which allows to pipeline dependent
+    communication:
+    \code
+    MPIProgressEngine engine;
+    engine.then(comm.irecv(data, source, tag), [&](auto data){
+        engine.then(comm.isend(process(data), dest, tag), [](auto){});
+      });
+    engine.wait();
+    \endcode
+
+    The requests are tested with MPI_Testsome either by explicit calls of
+    progress() or wait() or by a progress thread started with
+    startThread(). Continuations are run by the thread calling progress(),
+    i.e. possibly by the progress thread. While the progress thread runs,
+    progress() and wait() called by the owning thread run continuations
+    concurrently to it, so continuations that share state must synchronize
+    their access to it.
+
+    An exception thrown by a continuation propagates out of the progress()
+    or wait() that runs it. If the progress thread runs it, the exception
+    is stored and rethrown by the next call of progress(), wait() or
+    stopThread() of the owning thread. Only the first exception is kept
+    until it is rethrown.
+   */
+  class MPIProgressEngine{
+    // A future together with its continuation
+    struct Task{
+      virtual ~Task() = default;
+      virtual MPI_Request& request() = 0;
+      virtual MPI_Status& status() = 0;
+      virtual void run() = 0;
+    };
+
+    template<class F, class C>
+    struct Continuation
+      : public Task
+    {
+      Continuation(F&& future, C&& continuation)
+        : future_(std::move(future))
+        , continuation_(std::forward<C>(continuation))
+      {}
+
+      MPI_Request& request() override{
+        return Impl::MPIFutureAccess::request(future_);
+      }
+
+      MPI_Status& status() override{
+        return Impl::MPIFutureAccess::status(future_);
+      }
+
+      void run() override{
+        if constexpr (std::is_void<decltype(future_.get())>::value){
+          future_.get();
+          continuation_();
+        }else
+          continuation_(future_.get());
+      }
+
+      F future_;
+      std::decay_t<C> continuation_;
+    };
+
+  public:
+    MPIProgressEngine() = default;
+    MPIProgressEngine(const MPIProgressEngine&) = delete;
+    MPIProgressEngine& operator=(const MPIProgressEngine&) = delete;
+
+    //! Stops the progress thread. Pending futures and a stored exception are discarded.
+    ~MPIProgressEngine(){
+      joinThread();
+    }
+
+    /*! \brief Registers a continuation that is called with the result of
+      the future once its communication is completed.
+
+      For futures of void the continuation is called without arguments.
+     */
+    template<class R, class S, class C>
+    void then(MPIFuture<R,S>&& future, C&& continuation){
+      if(!future.valid())
+        DUNE_THROW(InvalidFutureException, "The MPIFuture is not valid!");
+      auto task = std::make_unique<Continuation<MPIFuture<R,S>,C>>(std::move(future),
+                                                                   std::forward<C>(continuation));
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+      }
+      condition_.notify_one();
+    }
+
+    /*! \brief Tests all pending futures and runs the continuations of the
+      completed ones.
+
+      Rethrows an exception of a continuation run by the progress thread
+      before testing the futures.
+
+      \returns the number of pending continuations
+     */
+    std::size_t progress(){
+      rethrowThreadException();
+      return progressImpl(false);
+    }
+
+    //! Runs progress() until all continuations, including those registered by continuations, are done.
+    void wait(){
+      while(progress() > 0)
+        std::this_thread::yield();
+      // the progress thread may have run the last continuation
+      rethrowThreadException();
+    }
+
+    //! The number of continuations that are not done yet.
+    std::size_t pending() const{
+      std::lock_guard<std::mutex> lock(mutex_);
+      return tasks_.size() + running_;
+    }
+
+    /*! \brief Starts a thread that calls progress() while continuations
+      are pending.
+
+      \throws InvalidStateException if MPI does not support MPI_THREAD_MULTIPLE.
+     */
+    void startThread(){
+      int provided;
+      MPI_Query_thread(&provided);
+      if(provided < MPI_THREAD_MULTIPLE)
+        DUNE_THROW(InvalidStateException, "The progress thread requires MPI_THREAD_MULTIPLE");
+      if(thread_.joinable())
+        return;
+      stop_ = false;
+      thread_ = std::thread([this]{
+          while(true){
+            {
+              std::unique_lock<std::mutex> lock(mutex_);
+              condition_.wait(lock, [this]{ return stop_ || !tasks_.empty(); });
+              if(stop_)
+                return;
+            }
+            progressImpl(true);
+            std::this_thread::yield();
+          }
+        });
+    }
+
+    /*! \brief Stops the progress thread.
+
+      Rethrows an exception of a continuation run by the progress thread.
+     */
+    void stopThread(){
+      joinThread();
+      rethrowThreadException();
+    }
+
+  private:
+    // An exception of a continuation run by the progress thread is stored
+    // together with the update of the pending continuations, so that an
+    // owner seeing no pending continuations also sees the exception.
+    std::size_t progressImpl(bool inThread){
+      std::vector<std::unique_ptr<Task>> completed;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::size_t n = tasks_.size();
+        requests_.resize(n);
+        indices_.resize(n);
+        statuses_.resize(n);
+        for(std::size_t i = 0; i < n; ++i){
+          requests_[i] = tasks_[i]->request();
+          // completed before, e.g. by get() in another continuation
+          if(requests_[i] == MPI_REQUEST_NULL)
+            completed.push_back(std::move(tasks_[i]));
+        }
+        int count = 0;
+        if(n > 0)
+          MPI_Testsome(n, requests_.data(), &count, indices_.data(), statuses_.data());
+        for(int k = 0; k < count && count != MPI_UNDEFINED; ++k){
+          Task& task = *tasks_[indices_[k]];
+          task.request() = requests_[indices_[k]];
+          task.status() = statuses_[k];
+          completed.push_back(std::move(tasks_[indices_[k]]));
+        }
+        tasks_.erase(std::remove(tasks_.begin(), tasks_.end(), nullptr), tasks_.end());
+        running_ += completed.size();
+      }
+
+      std::size_t run = 0;
+      try{
+        for(; run < completed.size(); ++run)
+          completed[run]->run();
+      }catch(...){
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ -= completed.size();
+        if(!inThread)
+          throw;
+        // an exception must not leave the thread, hand it to the owner
+        if(!exception_)
+          exception_ = std::current_exception();
+        return tasks_.size() + running_;
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      running_ -= completed.size();
+      return tasks_.size() + running_;
+    }
+
+    void joinThread(){
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+      }
+      condition_.notify_all();
+      if(thread_.joinable())
+        thread_.join();
+    }
+
+    void rethrowThreadException(){
+      std::exception_ptr exception;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::swap(exception, exception_);
+      }
+      if(exception)
+        std::rethrow_exception(exception);
+    }
+
+    std::vector<std::unique_ptr<Task>> tasks_;
+    std::size_t running_ = 0;
+    std::vector<MPI_Request> requests_;
+    std::vector<int> indices_;
+    std::vector<MPI_Status> statuses_;
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+    std::thread thread_;
+    bool stop_ = false;
+    std::exception_ptr exception_;
+  };
+
+}
+
+#endif // HAVE_MPI
+#endif // DUNE_COMMON_PARALLEL_MPIPROGRESS_HH
@@ -20,6 +20,7 @@
 #include <complex>
 #include <cstddef>
 #include <cstdint>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
@@ -196,6 +197,58 @@ namespace Dune
   template<typename T1, typename T2>
   MPI_Datatype MPITraits<std::pair<T1,T2> >::type=MPI_DATATYPE_NULL;
 
+  template<typename... T>
+  struct MPITraits<std::tuple<T...> >
+  {
+  public:
+    inline static MPI_Datatype getType();
+  private:
+    static MPI_Datatype type;
+  };
+  template<typename... T>
+  MPI_Datatype MPITraits<std::tuple<T...> >::getType()
+  {
+    static_assert(sizeof...(T) > 0, "There is no MPI datatype for empty tuples");
+    if(type==MPI_DATATYPE_NULL) {
+      constexpr int n = sizeof...(T);
+      int length[n];
+      MPI_Aint disp[n];
+      MPI_Datatype types[n] = {MPITraits<T>::getType()...};
+
+      // The layout of std::tuple is unspecified, hence ask for the addresses
+      using Tuple = std::tuple<T...>;
+      Tuple tuple;
+      MPI_Aint base;
+      MPI_Get_address(&tuple, &base);
+      std::apply([&](auto&... element){
+          int i = 0;
+          ((length[i] = 1, MPI_Get_address(&element, disp+i), disp[i] -= base, ++i), ...);
+        }, tuple);
+
+      MPI_Datatype tmp;
+      MPI_Type_create_struct(n, length, disp, types, &tmp);
+
+      MPI_Type_create_resized(tmp, 0, sizeof(Tuple), &type);
+      MPI_Type_commit(&type);
+
+      MPI_Type_free(&tmp);
+    }
+    return type;
+  }
+
+  template<typename... T>
+  MPI_Datatype MPITraits<std::tuple<T...> >::type=MPI_DATATYPE_NULL;
+
+  template<class... T> class TupleVector;
+
+  template<typename... T>
+  struct MPITraits<TupleVector<T...> >
+    : public MPITraits<std::tuple<T...> >
+  {
+    static_assert(sizeof(TupleVector<T...>) == sizeof(std::tuple<T...>),
+                  "TupleVector has to have the layout of std::tuple");
+  };
+
 #endif // !DOXYGEN
 
 } // namespace Dune
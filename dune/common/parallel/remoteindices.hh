@@ -7,13 +7,17 @@
 
 #if HAVE_MPI
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
 #include <iostream>
 #include <ostream>
 #include <map>
 #include <memory>
+#include <optional>
 #include <set>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -22,6 +26,7 @@
 #include <dune/common/exceptions.hh>
 #include <dune/common/sllist.hh>
 #include <dune/common/stdstreams.hh>
+#include <dune/common/parallel/future.hh>
 #include <dune/common/parallel/indexset.hh>
 #include <dune/common/parallel/mpitraits.hh>
 #include <dune/common/parallel/plocalindex.hh>
@@ -48,7 +53,48 @@ namespace Dune {
   };
 
 
-  template<typename T, typename A>
+  /**
+   * @brief Storage policy of RemoteIndices keeping the remote indices of
+   * each process in a singly linked list (SLList).
+   *
+   * This is the default. The remote indices can be modified with a
+   * RemoteIndexListModifier and synchronized with an IndicesSyncer.
+   */
+  struct SLListRemoteIndexStorage
+  {
+    /** @brief The type of the list of remote indices of a process. */
+    template<class RI, class A>
+    using List = SLList<RI,A>;
+
+    /** @brief Prepare a list for appending up to n remote indices. */
+    template<class L>
+    static void reserve(L&, std::size_t)
+    {}
+  };
+
+  /**
+   * @brief Storage policy of RemoteIndices keeping the remote indices of
+   * each process contiguously in a std::vector.
+   *
+   * Iterating over the remote indices, e.g. while building an Interface,
+   * does not need to follow pointers from node to node. The lists can
+   * neither be changed with a RemoteIndexListModifier nor by an IndicesSyncer.
+   */
+  struct VectorRemoteIndexStorage
+  {
+    /** @brief The type of the list of remote indices of a process. */
+    template<class RI, class A>
+    using List = std::vector<RI,A>;
+
+    /** @brief Prepare a list for appending up to n remote indices. */
+    template<class L>
+    static void reserve(L& list, std::size_t n)
+    {
+      list.reserve(list.size()+n);
+    }
+  };
+
+  template<typename T, typename A, typename S>
   class RemoteIndices;
 
   template<typename T1, typename T2>
@@ -77,7 +123,7 @@ namespace Dune {
 
     template<typename T, typename A, typename A1>
     friend void repairLocalIndexPointers(std::map<int,SLList<std::pair<typename T::GlobalIndex, typename T::LocalIndex::Attribute>,A> >&,
-                                         RemoteIndices<T,A1>&,
+                                         RemoteIndices<T,A1,SLListRemoteIndexStorage>&,
                                          const T&);
 
     template<typename T, typename A, bool mode>
@@ -151,12 +197,12 @@ namespace Dune {
     char attribute_;
   };
 
-  template<class T, class A>
-  std::ostream& operator<<(std::ostream& os, const RemoteIndices<T,A>& indices);
+  template<class T, class A, class S>
+  std::ostream& operator<<(std::ostream& os, const RemoteIndices<T,A,S>& indices);
 
   class InterfaceBuilder;
 
-  template<class T, class A>
+  template<class T, class A, class S=SLListRemoteIndexStorage>
   class CollectiveIterator;
 
   // forward declaration needed for friend declaration.
@@ -178,14 +224,17 @@ namespace Dune {
    *
    * This information is managed by this class. The information can either
    * be computed automatically calling rebuild (which requires information
-   * to be sent in a ring) or set up by hand using the
+   * to be sent in a ring unless the neighbours are known or discovered,
+   * see setNeighbourDiscovery(bool)) or set up by hand using the
    * RemoteIndexListModifiers returned by function getModifier(int).
    *
    * @tparam T The type of the underlying index set.
    * @tparam A The type of the allocator to use.
+   * @tparam S The storage policy of the remote index lists, either
+   * SLListRemoteIndexStorage or VectorRemoteIndexStorage.
    */
   template<class T, class A=std::allocator<RemoteIndex<typename T::GlobalIndex,
-              typename T::LocalIndex::Attribute> > >
+              typename T::LocalIndex::Attribute> >, class S=SLListRemoteIndexStorage>
   class RemoteIndices
   {
     friend class InterfaceBuilder;
@@ -197,7 +246,7 @@ namespace Dune {
 
     template<class G, class T1, class T2>
     friend void fillIndexSetHoles(const G& graph, Dune::OwnerOverlapCopyCommunication<T1,T2>& oocomm);
-    friend std::ostream& operator<< <>(std::ostream&, const RemoteIndices<T>&);
+    friend std::ostream& operator<< <>(std::ostream&, const RemoteIndices&);
 
   public:
 
@@ -208,7 +257,7 @@ namespace Dune {
 
     /**
      * @brief The type of the collective iterator over all remote indices. */
-    typedef CollectiveIterator<T,A> CollectiveIteratorT;
+    typedef CollectiveIterator<T,A,S> CollectiveIteratorT;
 
     /**
      * @brief The type of the global index.
@@ -237,8 +286,11 @@ namespace Dune {
      */
     using Allocator = typename std::allocator_traits<A>::template rebind_alloc<RemoteIndex>;
 
+    /** @brief The storage policy of the remote index lists. */
+    typedef S Storage;
+
     /** @brief The type of the remote index list. */
-    typedef Dune::SLList<RemoteIndex,Allocator>
+    typedef typename Storage::template List<RemoteIndex,Allocator>
     RemoteIndexList;
 
     /** @brief The type of the map from rank to remote index list. */
@@ -258,7 +310,8 @@ namespace Dune {
      * May be the same as the source indexset.
      * @param neighbours Optional: The neighbours the process shares indices with.
      * If this parameter is omitted a ring communication with all indices will take
-     * place to calculate this information which is O(P).
+     * place to calculate this information which is O(P), unless neighbour
+     * discovery is enabled by setNeighbourDiscovery(bool).
      * @param includeSelf If true, sending from indices of the processor to other
      * indices on the same processor is enabled even if the same indexset is used
      * on both the
@@ -278,6 +331,28 @@ namespace Dune {
      */
     void setIncludeSelf(bool includeSelf);
 
+    /**
+     * @brief Tell whether the neighbours should be discovered by a sparse
+     * data exchange if none were provided.
+     *
+     * If enabled and no neighbours were set, rebuild() sends every public
+     * global index to a rendezvous process determined by hashing it. The
+     * rendezvous processes tell each process which other processes know
+     * the same global indices. Afterwards the indices are only exchanged
+     * with these neighbours using a nonblocking consensus
+     * (MPI_Issend and MPI_Ibarrier). Thus the costs depend on the number of
+     * neighbours instead of the number of processes and no buffer has
+     * to be sized for the largest index set of all processes. The resulting
+     * remote indices are the same as the ones computed by the ring
+     * communication.
+     *
+     * The setting has to be the same on all processes. If std::hash is not
+     * available for the global index type, the ring communication is used.
+     *
+     * @param discover If true neighbour discovery is enabled.
+     */
+    void setNeighbourDiscovery(bool discover);
+
     /**
      * @brief Set the index sets and communicator we work with.
      *
@@ -292,7 +367,8 @@ namespace Dune {
      * May be the same as the source indexset.
      * @param neighbours Optional: The neighbours the process shares indices with.
      * If this parameter is omitted a ring communication with all indices will take
-     * place to calculate this information which is O(P).
+     * place to calculate this information which is O(P), unless neighbour
+     * discovery is enabled by setNeighbourDiscovery(bool).
      */
     void setIndexSets(const ParallelIndexSet& source, const ParallelIndexSet& destination,
                       const MPI_Comm& comm, const std::vector<int>& neighbours=std::vector<int>());
@@ -327,6 +403,126 @@ namespace Dune {
     template<bool ignorePublic>
     void rebuild();
 
+  private:
+    struct RebuildState;
+
+  public:
+    /**
+     * @brief Handle of a rebuild started by rebuildAsync().
+     *
+     * Models the interface of Dune::Future<void>, i.e. it can be wrapped
+     * into a Dune::Future. The rebuild advances whenever ready() is
+     * called and is completed by wait() or get(), which have to be called
+     * on all processes. If the handle is destroyed before, the rebuild is
+     * completed by the destructor.
+     */
+    class Rebuild
+    {
+      friend class RemoteIndices;
+
+      Rebuild(RemoteIndices& remoteIndices, std::unique_ptr<RebuildState> state)
+        : remoteIndices_(&remoteIndices), state_(std::move(state)), valid_(true)
+      {}
+
+    public:
+      /** @brief Constructs an invalid handle. */
+      Rebuild()
+        : remoteIndices_(nullptr), valid_(false)
+      {}
+
+      Rebuild(Rebuild&& other)
+        : remoteIndices_(other.remoteIndices_), state_(std::move(other.state_)),
+          valid_(std::exchange(other.valid_, false))
+      {}
+
+      Rebuild& operator=(Rebuild&& other)
+      {
+        complete();
+        remoteIndices_ = other.remoteIndices_;
+        state_ = std::move(other.state_);
+        valid_ = std::exchange(other.valid_, false);
+        return *this;
+      }
+
+      /** @brief Completes a pending rebuild. */
+      ~Rebuild()
+      {
+        complete();
+      }
+
+      /** @brief Wait for the completion of the rebuild. */
+      void wait()
+      {
+        if(!valid_)
+          DUNE_THROW(InvalidFutureException, "The rebuild is not valid");
+        complete();
+      }
+
+      /**
+       * @brief Advance the rebuild without blocking.
+       * @return True if the rebuild is complete.
+       */
+      bool ready() const
+      {
+        if(!valid_)
+          DUNE_THROW(InvalidFutureException, "The rebuild is not valid");
+        if(state_ && remoteIndices_->progressRebuild(*state_, false))
+          complete();
+        return !state_;
+      }
+
+      /** @brief Whether the handle belongs to a rebuild. */
+      bool valid() const
+      {
+        return valid_;
+      }
+
+      /** @brief Wait for the completion and invalidate the handle. */
+      void get()
+      {
+        wait();
+        valid_ = false;
+      }
+
+    private:
+      void complete() const
+      {
+        if(state_) {
+          remoteIndices_->finishRebuild(*state_);
+          state_.reset();
+        }
+      }
+
+      RemoteIndices* remoteIndices_;
+      mutable std::unique_ptr<RebuildState> state_;
+      bool valid_;
+    };
+
+    /**
+     * @brief Starts rebuilding the set of remote indices.
+     *
+     * Like rebuild() but only the local setup is done before returning.
+     * The exchange of the indices uses nonblocking communication
+     * (MPI_Iallreduce and a ring of MPI_Isend/MPI_Irecv without neighbour
+     * information, MPI_Issend to the neighbours otherwise, and the
+     * nonblocking consensus of the neighbour discovery) and advances
+     * whenever ready() is called on the returned handle. Thus local work
+     * can overlap the rebuild:
+     * \code
+     * auto rebuild = remoteIndices.rebuildAsync<false>();
+     * while(!rebuild.ready())
+     *   assembleSomeMore();
+     * rebuild.get();
+     * \endcode
+     * Until the rebuild is complete the index sets must not be changed,
+     * the remote indices must not be used, and no other rebuild may be in
+     * progress on the same communicator.
+     *
+     * @return The handle to complete the rebuild with.
+     */
+    template<bool ignorePublic>
+    Rebuild rebuildAsync();
+
     bool operator==(const RemoteIndices& ri) const;
 
     /**
@@ -352,6 +548,8 @@ namespace Dune {
      * @warning Use with care. If the remote index list is inconsistent
      * after the modification the communication might result in a dead lock!
      *
+     * Only available with the storage policy SLListRemoteIndexStorage.
+     *
      * @tparam mode If true the index set corresponding to the remote indices might get modified.
      * Therefore the internal pointers to the indices need to be repaired.
      * @tparam send If true the remote index information at the sending side will
@@ -421,7 +619,16 @@ namespace Dune {
     std::set<int> neighbourIds;
 
     /** @brief The communicator tag to use. */
-    const static int commTag_=333;
+    constexpr static int commTag_=333;
+
+    /**
+     * @brief The communicator tags to use for the neighbour discovery.
+     *
+     * The first one is used for sending the global indices to the rendezvous
+     * processes, the second one for the replies.
+     */
+    constexpr static int discoveryTag_=334;
+    constexpr static int discoveryReplyTag_=335;
 
     /**
      * @brief The sequence number of the source index set when the remote indices
@@ -453,6 +660,12 @@ namespace Dune {
      */
     bool includeSelf;
 
+    /**
+     * @brief If true, the neighbours are discovered by a sparse data
+     * exchange if none were set.
+     */
+    bool discoverNeighbours_;
+
     /** @brief The index pair type. */
     typedef IndexPair<GlobalIndex, LocalIndex>
     PairType;
@@ -466,7 +679,140 @@ namespace Dune {
     RemoteIndexMap remoteIndices_;
 
     /**
-     * @brief Build the remote mapping.
+     * @brief Exchange of messages with an unknown set of senders.
+     *
+     * Implements the nonblocking consensus: the messages are sent
+     * with MPI_Issend and incoming messages are received until all of our
+     * sends were matched and a nonblocking barrier has completed on all
+     * processes.
+     */
+    template<typename V>
+    class SparseExchange
+    {
+    public:
+      /**
+       * @brief Starts the exchange.
+       * @param out The messages to send, keyed by the destination rank.
+       * @param type The MPI datatype of the entries.
+       * @param tag The communicator tag to use.
+       * @param comm The communicator to use.
+       */
+      SparseExchange(std::map<int,std::vector<V> > out, MPI_Datatype type, int tag,
+                     MPI_Comm comm)
+        : out_(std::move(out)), barrier_(MPI_REQUEST_NULL), barrierActive_(false),
+          type_(type), tag_(tag), comm_(comm)
+      {
+        requests_.reserve(out_.size());
+        for(const auto& [proc, message] : out_) {
+          requests_.emplace_back();
+          MPI_Issend(message.data(), message.size(), type_, proc, tag_, comm_,
+                     &requests_.back());
+        }
+      }
+
+      SparseExchange(const SparseExchange&) = delete;
+
+      /**
+       * @brief Receives the messages arrived so far.
+       * @return True if the exchange is complete.
+       */
+      bool test()
+      {
+        int arrived = true;
+        while(arrived) {
+          MPI_Status status;
+          MPI_Iprobe(MPI_ANY_SOURCE, tag_, comm_, &arrived, &status);
+          if(arrived) {
+            int count;
+            MPI_Get_count(&status, type_, &count);
+            std::vector<V>& message = in[status.MPI_SOURCE];
+            message.resize(count);
+            MPI_Recv(message.data(), count, type_, status.MPI_SOURCE, tag_, comm_,
+                     MPI_STATUS_IGNORE);
+          }
+        }
+
+        int done = false;
+        if(barrierActive_)
+          MPI_Test(&barrier_, &done, MPI_STATUS_IGNORE);
+        else{
+          int sent;
+          MPI_Testall(requests_.size(), requests_.data(), &sent, MPI_STATUSES_IGNORE);
+          if(sent) {
+            // All our messages were received, wait for the others
+            MPI_Ibarrier(comm_, &barrier_);
+            barrierActive_ = true;
+          }
+        }
+        return done;
+      }
+
+      /** @brief The received messages, keyed by the source rank. */
+      std::map<int,std::vector<V> > in;
+
+    private:
+      std::map<int,std::vector<V> > out_;
+      std::vector<MPI_Request> requests_;
+      MPI_Request barrier_;
+      bool barrierActive_;
+      MPI_Datatype type_;
+      int tag_;
+      MPI_Comm comm_;
+    };
+
+    /**
+     * @brief The state of a rebuild in progress.
+     */
+    struct RebuildState
+    {
+      enum Phase {
+        //! Sending the global indices to the rendezvous processes.
+        discover,
+        //! Receiving the neighbours from the rendezvous processes.
+        reply,
+        //! Computing the maximal message size for the ring.
+        allreduce,
+        //! Sending the indices around the ring.
+        ring,
+        //! Exchanging the indices with the neighbours.
+        exchange,
+        done
+      };
+
+      Phase phase = done;
+      int rank, procs;
+      int sourceSeqNo, destSeqNo;
+      bool ignorePublic;
+      // Do we need to send two index sets?
+      char sendTwo;
+      // The number of local indices to publish of each index set
+      int sourcePublish, destPublish;
+      int publish, maxPublish;
+      std::vector<PairType*> sourcePairs, destPairs;
+      // Our message and, for the ring, the message passed on
+      std::vector<char> buffer[2];
+      // The size of our message
+      int position = 0;
+      // The current step of the ring
+      int step = 0;
+      std::vector<MPI_Request> requests;
+      std::set<int> exchangeIds;
+      std::size_t received = 0;
+      std::vector<char> recvBuffer;
+      std::optional<SparseExchange<GlobalIndex> > discovery;
+      std::optional<SparseExchange<int> > replies;
+
+      PairType** destination()
+      {
+        return sendTwo ? destPairs.data() : sourcePairs.data();
+      }
+    };
+
+    /**
+     * @brief Starts building the remote mapping.
+     *
+     * Frees the remote indices, packs the published indices and starts
+     * the communication.
      *
      * If the template parameter ignorePublic is true all indices will be treated
      * as public.
@@ -476,7 +822,49 @@ namespace Dune {
      * sending and receiving side.
      */
     template<bool ignorePublic>
-    inline void buildRemote(bool includeSelf);
+    inline std::unique_ptr<RebuildState> startRebuild(bool includeSelf);
+
+    /**
+     * @brief Advances a rebuild.
+     * @param wait If true, blocks until the rebuild is complete.
+     * @return True if the rebuild is complete.
+     */
+    inline bool progressRebuild(RebuildState& state, bool wait);
+
+    /**
+     * @brief Waits for the completion of a rebuild and marks the remote
+     * indices as synced with the index sets.
+     */
+    inline void finishRebuild(RebuildState& state);
+
+    /** @brief Starts a step of the ring communication. */
+    inline void startRingStep(RebuildState& state);
+
+    /** @brief Starts exchanging the indices with the neighbours. */
+    inline void startExchange(RebuildState& state);
+
+    /**
+     * @brief The published global indices, keyed by their rendezvous
+     * process.
+     *
+     * Each published global index is sent to a rendezvous process
+     * determined by its hash value. The rendezvous process sends
+     * back the processes that published the same global index.
+     *
+     * If the template parameter ignorePublic is true all indices will be treated
+     * as public.
+     */
+    template<bool ignorePublic>
+    inline std::map<int,std::vector<GlobalIndex> > publishToRendezvous();
+
+    /**
+     * @brief Tells the publishers of the same global index at this
+     * rendezvous process that they are neighbours.
+     * @param atRendezvous The global indices received, keyed by the publisher.
+     * @return The neighbours of each publisher.
+     */
+    inline std::map<int,std::vector<int> >
+    matchAtRendezvous(const std::map<int,std::vector<GlobalIndex> >& atRendezvous);
 
     /**
      * @brief Count the number of public indices in an index set.
@@ -549,7 +937,7 @@ namespace Dune {
   class RemoteIndexListModifier
   {
 
-    template<typename T1, typename A1>
+    template<typename T1, typename A1, typename S1>
     friend class RemoteIndices;
 
   public:
@@ -702,7 +1090,7 @@ namespace Dune {
    * @brief A collective iterator for moving over the remote indices for
    * all processes collectively.
    */
-  template<class T, class A>
+  template<class T, class A, class S>
   class CollectiveIterator
   {
 
@@ -733,7 +1121,7 @@ namespace Dune {
     using Allocator = typename std::allocator_traits<A>::template rebind_alloc<RemoteIndex>;
 
     /** @brief The type of the remote index list. */
-    typedef Dune::SLList<RemoteIndex,Allocator> RemoteIndexList;
+    typedef typename S::template List<RemoteIndex,Allocator> RemoteIndexList;
 
     /** @brief The of map for storing the iterators. */
     typedef std::map<int,std::pair<typename RemoteIndexList::const_iterator,
@@ -953,34 +1341,40 @@ namespace Dune {
     return *localIndex_;
   }
 
-  template<typename T, typename A>
-  inline RemoteIndices<T,A>::RemoteIndices(const ParallelIndexSet& source,
+  template<typename T, typename A, typename S>
+  inline RemoteIndices<T,A,S>::RemoteIndices(const ParallelIndexSet& source,
                                            const ParallelIndexSet& destination,
                                            const MPI_Comm& comm,
                                            const std::vector<int>& neighbours,
                                            bool includeSelf_)
     : source_(&source), target_(&destination), comm_(comm),
       sourceSeqNo_(-1), destSeqNo_(-1), publicIgnored(false), firstBuild(true),
-      includeSelf(includeSelf_)
+      includeSelf(includeSelf_), discoverNeighbours_(false)
   {
     setNeighbours(neighbours);
   }
 
-  template<typename T, typename A>
-  void RemoteIndices<T,A>::setIncludeSelf(bool b)
+  template<typename T, typename A, typename S>
+  void RemoteIndices<T,A,S>::setIncludeSelf(bool b)
   {
     includeSelf=b;
   }
 
-  template<typename T, typename A>
-  RemoteIndices<T,A>::RemoteIndices()
+  template<typename T, typename A, typename S>
+  void RemoteIndices<T,A,S>::setNeighbourDiscovery(bool b)
+  {
+    discoverNeighbours_=b;
+  }
+
+  template<typename T, typename A, typename S>
+  RemoteIndices<T,A,S>::RemoteIndices()
     : source_(0), target_(0), sourceSeqNo_(-1),
       destSeqNo_(-1), publicIgnored(false), firstBuild(true),
-      includeSelf(false)
+      includeSelf(false), discoverNeighbours_(false)
   {}
 
-  template<class T, typename A>
-  void RemoteIndices<T,A>::setIndexSets(const ParallelIndexSet& source,
+  template<class T, typename A, typename S>
+  void RemoteIndices<T,A,S>::setIndexSets(const ParallelIndexSet& source,
                                         const ParallelIndexSet& destination,
                                         const MPI_Comm& comm,
                                         const std::vector<int>& neighbours)
@@ -993,31 +1387,31 @@ namespace Dune {
     setNeighbours(neighbours);
   }
 
-  template<typename T, typename A>
-  const typename RemoteIndices<T,A>::ParallelIndexSet&
-  RemoteIndices<T,A>::sourceIndexSet() const
+  template<typename T, typename A, typename S>
+  const typename RemoteIndices<T,A,S>::ParallelIndexSet&
+  RemoteIndices<T,A,S>::sourceIndexSet() const
   {
     return *source_;
   }
 
 
-  template<typename T, typename A>
-  const typename RemoteIndices<T,A>::ParallelIndexSet&
-  RemoteIndices<T,A>::destinationIndexSet() const
+  template<typename T, typename A, typename S>
+  const typename RemoteIndices<T,A,S>::ParallelIndexSet&
+  RemoteIndices<T,A,S>::destinationIndexSet() const
   {
     return *target_;
   }
 
 
-  template<typename T, typename A>
-  RemoteIndices<T,A>::~RemoteIndices()
+  template<typename T, typename A, typename S>
+  RemoteIndices<T,A,S>::~RemoteIndices()
   {
     free();
   }
 
-  template<typename T, typename A>
+  template<typename T, typename A, typename S>
   template<bool ignorePublic>
-  inline void RemoteIndices<T,A>::packEntries(IndexPair<GlobalIndex,LocalIndex>** pairs,
+  inline void RemoteIndices<T,A,S>::packEntries(IndexPair<GlobalIndex,LocalIndex>** pairs,
                                               const ParallelIndexSet& indexSet,
                                               char* p_out, MPI_Datatype type,
                                               int bufferSize,
@@ -1041,8 +1435,8 @@ namespace Dune {
     assert(i==n);
   }
 
-  template<typename T, typename A>
-  inline int RemoteIndices<T,A>::noPublic(const ParallelIndexSet& indexSet)
+  template<typename T, typename A, typename S>
+  inline int RemoteIndices<T,A,S>::noPublic(const ParallelIndexSet& indexSet)
   {
 
     int noPublic=0;
@@ -1057,8 +1451,8 @@ namespace Dune {
   }
 
 
-  template<typename T, typename A>
-  inline void RemoteIndices<T,A>::unpackCreateRemote(char* p_in, PairType** sourcePairs,
+  template<typename T, typename A, typename S>
+  inline void RemoteIndices<T,A,S>::unpackCreateRemote(char* p_in, PairType** sourcePairs,
                                                      PairType** destPairs, int remoteProc,
                                                      int sourcePublish, int destPublish,
                                                      int bufferSize, bool sendTwo,
@@ -1125,25 +1519,35 @@ namespace Dune {
   }
 
 
-  template<typename T, typename A>
+  template<typename T, typename A, typename S>
   template<bool ignorePublic>
-  inline void RemoteIndices<T,A>::buildRemote(bool includeSelf_)
+  inline std::unique_ptr<typename RemoteIndices<T,A,S>::RebuildState>
+  RemoteIndices<T,A,S>::startRebuild(bool includeSelf_)
   {
+    free();
+
+    auto state = std::make_unique<RebuildState>();
+    state->sourceSeqNo = source_->seqNo();
+    state->destSeqNo = target_->seqNo();
+    state->ignorePublic = ignorePublic;
+
     // Processor configuration
-    int rank, procs;
+    int& rank = state->rank;
+    int& procs = state->procs;
     MPI_Comm_rank(comm_, &rank);
     MPI_Comm_size(comm_, &procs);
 
     // number of local indices to publish
     // The indices of the destination will be send.
-    int sourcePublish, destPublish;
+    int& sourcePublish = state->sourcePublish;
+    int& destPublish = state->destPublish;
 
     // Do we need to send two index sets?
-    char sendTwo = (source_ != target_);
+    char sendTwo = state->sendTwo = (source_ != target_);
 
     if(procs==1 && !(sendTwo || includeSelf_))
       // Nothing to communicate
-      return;
+      return state;
 
     sourcePublish = (ignorePublic) ? source_->size() : noPublic(*source_);
 
@@ -1153,30 +1557,29 @@ namespace Dune {
       // we only need to send one set of indices
       destPublish = 0;
 
-    int maxPublish, publish=sourcePublish+destPublish;
+    state->publish = sourcePublish+destPublish;
 
-    // Calculate maximum number of indices send
-    MPI_Allreduce(&publish, &maxPublish, 1, MPI_INT, MPI_MAX, comm_);
+    neighbourIds.erase(rank);
 
-    // allocate buffers
-    PairType** destPairs;
-    PairType** sourcePairs = new PairType*[sourcePublish>0 ? sourcePublish : 1];
+    // Discovery is only possible if the global indices can be hashed
+    constexpr bool canDiscover = std::is_default_constructible_v<std::hash<GlobalIndex> >;
+    const bool discover = canDiscover && discoverNeighbours_ && neighbourIds.empty();
+    // Without neighbour information the indices are sent in a ring
+    const bool ring = !discover && neighbourIds.empty();
 
+    // allocate buffers
+    state->sourcePairs.resize(sourcePublish>0 ? sourcePublish : 1);
     if(sendTwo)
-      destPairs = new PairType*[destPublish>0 ? destPublish : 1];
-    else
-      destPairs=sourcePairs;
+      state->destPairs.resize(destPublish>0 ? destPublish : 1);
 
-    char** buffer = new char*[2];
     int bufferSize;
-    int position=0;
     int intSize;
     int charSize;
 
     // calculate buffer size
     MPI_Datatype type = MPITraits<PairType>::getType();
 
-    MPI_Pack_size(maxPublish, type, comm_,
+    MPI_Pack_size(state->publish, type, comm_,
                   &bufferSize);
     MPI_Pack_size(1, MPI_INT, comm_,
                   &intSize);
@@ -1190,127 +1593,292 @@ namespace Dune {
 
     if(bufferSize<=0) bufferSize=1;
 
-    buffer[0] = new char[bufferSize];
-    buffer[1] = new char[bufferSize];
-
+    std::vector<char>& buffer = state->buffer[0];
+    buffer.resize(bufferSize);
+    int& position = state->position;
 
     // pack entries into buffer[0], p_out below!
-    MPI_Pack(&sendTwo, 1, MPI_CHAR, buffer[0], bufferSize, &position,
+    MPI_Pack(&sendTwo, 1, MPI_CHAR, buffer.data(), bufferSize, &position,
              comm_);
 
     // The number of indices we send for each index set
-    MPI_Pack(&sourcePublish, 1, MPI_INT, buffer[0], bufferSize, &position,
+    MPI_Pack(&sourcePublish, 1, MPI_INT, buffer.data(), bufferSize, &position,
              comm_);
-    MPI_Pack(&destPublish, 1, MPI_INT, buffer[0], bufferSize, &position,
+    MPI_Pack(&destPublish, 1, MPI_INT, buffer.data(), bufferSize, &position,
              comm_);
 
     // Now pack the source indices and setup the destination pairs
-    packEntries<ignorePublic>(sourcePairs, *source_, buffer[0], type,
+    packEntries<ignorePublic>(state->sourcePairs.data(), *source_, buffer.data(), type,
                               bufferSize, &position, sourcePublish);
     // If necessary send the dest indices and setup the source pairs
     if(sendTwo)
-      packEntries<ignorePublic>(destPairs, *target_, buffer[0], type,
+      packEntries<ignorePublic>(state->destPairs.data(), *target_, buffer.data(), type,
                                 bufferSize, &position, destPublish);
 
 
     // Update remote indices for ourself
     if(sendTwo|| includeSelf_)
-      unpackCreateRemote(buffer[0], sourcePairs, destPairs, rank, sourcePublish,
-                         destPublish, bufferSize, sendTwo, includeSelf_);
+      unpackCreateRemote(buffer.data(), state->sourcePairs.data(), state->destination(),
+                         rank, sourcePublish, destPublish, bufferSize, sendTwo,
+                         includeSelf_);
+
+    if constexpr (canDiscover) {
+      if(discover) {
+        state->discovery.emplace(publishToRendezvous<ignorePublic>(),
+                                 MPITraits<GlobalIndex>::getType(), discoveryTag_, comm_);
+        state->phase = RebuildState::discover;
+        return state;
+      }
+    }
 
-    neighbourIds.erase(rank);
+    if(ring) {
+      // Calculate maximum number of indices send
+      state->requests.resize(2, MPI_REQUEST_NULL);
+      MPI_Iallreduce(&state->publish, &state->maxPublish, 1, MPI_INT, MPI_MAX, comm_,
+                     state->requests.data());
+      state->phase = RebuildState::allreduce;
+    }
+    else{
+      // Messages are only exchanged with the neighbours and received
+      // into buffers of the probed size.
+      state->exchangeIds = neighbourIds;
+      startExchange(*state);
+    }
+    return state;
+  }
 
-    if(neighbourIds.size()==0)
-    {
-      Dune::dvverb<<rank<<": Sending messages in a ring"<<std::endl;
-      // send messages in ring
-      for(int proc=1; proc<procs; proc++) {
-        // pointers to the current input and output buffers
-        char* p_out = buffer[1-(proc%2)];
-        char* p_in = buffer[proc%2];
-
-        MPI_Status status;
-        if(rank%2==0) {
-          MPI_Ssend(p_out, bufferSize, MPI_PACKED, (rank+1)%procs,
-                    commTag_, comm_);
-          MPI_Recv(p_in, bufferSize, MPI_PACKED, (rank+procs-1)%procs,
-                   commTag_, comm_, &status);
-        }else{
-          MPI_Recv(p_in, bufferSize, MPI_PACKED, (rank+procs-1)%procs,
-                   commTag_, comm_, &status);
-          MPI_Ssend(p_out, bufferSize, MPI_PACKED, (rank+1)%procs,
-                    commTag_, comm_);
-        }
+  template<typename T, typename A, typename S>
+  inline void RemoteIndices<T,A,S>::startRingStep(RebuildState& state)
+  {
+    // pointers to the current input and output buffers
+    char* p_out = state.buffer[1-(state.step%2)].data();
+    char* p_in = state.buffer[state.step%2].data();
+    const int bufferSize = state.buffer[0].size();
+
+    MPI_Irecv(p_in, bufferSize, MPI_PACKED, (state.rank+state.procs-1)%state.procs,
+              commTag_, comm_, &state.requests[0]);
+    MPI_Isend(p_out, bufferSize, MPI_PACKED, (state.rank+1)%state.procs,
+              commTag_, comm_, &state.requests[1]);
+  }
 
+  template<typename T, typename A, typename S>
+  inline void RemoteIndices<T,A,S>::startExchange(RebuildState& state)
+  {
+    state.requests.resize(state.exchangeIds.size());
+    auto req = state.requests.begin();
+    // Only send the information to the neighbouring processors
+    for(int neighbour : state.exchangeIds)
+      MPI_Issend(state.buffer[0].data(), state.position, MPI_PACKED, neighbour, commTag_,
+                 comm_, &*req++);
+    state.phase = RebuildState::exchange;
+  }
+
+  template<typename T, typename A, typename S>
+  inline bool RemoteIndices<T,A,S>::progressRebuild(RebuildState& state, bool wait)
+  {
+    while(true) {
+      switch(state.phase) {
+      case RebuildState::discover :
+        if constexpr (std::is_default_constructible_v<std::hash<GlobalIndex> >) {
+          if(!state.discovery->test()) {
+            if(wait)
+              continue;
+            return false;
+          }
+          // Tell the publishers with whom they share indices
+          state.replies.emplace(matchAtRendezvous(state.discovery->in),
+                                MPITraits<int>::getType(), discoveryReplyTag_, comm_);
+          state.discovery.reset();
+          state.phase = RebuildState::reply;
+        }
+        break;
+      case RebuildState::reply :
+        if(!state.replies->test()) {
+          if(wait)
+            continue;
+          return false;
+        }
+        for(const auto& [proc, ranks] : state.replies->in)
+          state.exchangeIds.insert(ranks.begin(), ranks.end());
+        state.replies.reset();
+        startExchange(state);
+        break;
+      case RebuildState::allreduce :
+      {
+        int flag = true;
+        if(wait)
+          MPI_Wait(state.requests.data(), MPI_STATUS_IGNORE);
+        else
+          MPI_Test(state.requests.data(), &flag, MPI_STATUS_IGNORE);
+        if(!flag)
+          return false;
+
+        int bufferSize;
+        int intSize;
+        int charSize;
+        MPI_Pack_size(state.maxPublish, MPITraits<PairType>::getType(), comm_,
+                      &bufferSize);
+        MPI_Pack_size(1, MPI_INT, comm_,
+                      &intSize);
+        MPI_Pack_size(1, MPI_CHAR, comm_,
+                      &charSize);
+        bufferSize += 2 * intSize + charSize;
+        state.buffer[0].resize(std::max<std::size_t>(bufferSize, state.buffer[0].size()));
+        state.buffer[1].resize(state.buffer[0].size());
+
+        Dune::dvverb<<state.rank<<": Sending messages in a ring"<<std::endl;
+        state.step = 1;
+        if(state.step < state.procs)
+          startRingStep(state);
+        state.phase = state.step < state.procs ? RebuildState::ring : RebuildState::done;
+        break;
+      }
+      case RebuildState::ring :
+      {
+        int flag = true;
+        if(wait)
+          MPI_Waitall(2, state.requests.data(), MPI_STATUSES_IGNORE);
+        else
+          MPI_Testall(2, state.requests.data(), &flag, MPI_STATUSES_IGNORE);
+        if(!flag)
+          return false;
 
         // The process these indices are from
-        int remoteProc = (rank+procs-proc)%procs;
+        int remoteProc = (state.rank+state.procs-state.step)%state.procs;
+
+        unpackCreateRemote(state.buffer[state.step%2].data(), state.sourcePairs.data(),
+                           state.destination(), remoteProc, state.sourcePublish,
+                           state.destPublish, state.buffer[0].size(), state.sendTwo);
+        if(++state.step < state.procs)
+          startRingStep(state);
+        else
+          state.phase = RebuildState::done;
+        break;
+      }
+      case RebuildState::exchange :
+      {
+        //Test for received messages
+        while(state.received < state.exchangeIds.size()) {
+          MPI_Status status;
+          int arrived = true;
+          // probe for next message
+          if(wait)
+            MPI_Probe(MPI_ANY_SOURCE, commTag_, comm_, &status);
+          else
+            MPI_Iprobe(MPI_ANY_SOURCE, commTag_, comm_, &arrived, &status);
+          if(!arrived)
+            return false;
+          int remoteProc=status.MPI_SOURCE;
+          int size;
+          MPI_Get_count(&status, MPI_PACKED, &size);
+          // receive buffer, grown to the largest message probed
+          if(state.recvBuffer.size()<std::size_t(size))
+            state.recvBuffer.resize(size);
+          // receive message
+          MPI_Recv(state.recvBuffer.data(), size, MPI_PACKED, remoteProc,
+                   commTag_, comm_, &status);
 
-        unpackCreateRemote(p_in, sourcePairs, destPairs, remoteProc, sourcePublish,
-                           destPublish, bufferSize, sendTwo);
+          unpackCreateRemote(state.recvBuffer.data(), state.sourcePairs.data(),
+                             state.destination(), remoteProc, state.sourcePublish,
+                             state.destPublish, size, state.sendTwo);
+          ++state.received;
+        }
 
+        // wait for completion of pending requests
+        std::vector<MPI_Status> statuses(state.requests.size());
+        int flag = true;
+        int error = wait
+          ? MPI_Waitall(state.requests.size(), state.requests.data(), statuses.data())
+          : MPI_Testall(state.requests.size(), state.requests.data(), &flag, statuses.data());
+        if(int(MPI_ERR_IN_STATUS)==error) {
+          for(const MPI_Status& status : statuses)
+            if(status.MPI_ERROR!=MPI_SUCCESS) {
+              std::cerr<<state.rank<<": MPI_Error occurred while receiving message."<<std::endl;
+              MPI_Abort(comm_, 999);
+            }
+        }
+        if(!flag)
+          return false;
+        state.phase = RebuildState::done;
+        break;
+      }
+      case RebuildState::done :
+        return true;
       }
-
     }
-    else
-    {
-      MPI_Request* requests=new MPI_Request[neighbourIds.size()];
-      MPI_Request* req=requests;
-
-      typedef typename std::set<int>::size_type size_type;
-      size_type noNeighbours=neighbourIds.size();
+  }
 
-      // setup sends
-      for(std::set<int>::iterator neighbour=neighbourIds.begin();
-          neighbour!= neighbourIds.end(); ++neighbour) {
-        // Only send the information to the neighbouring processors
-        MPI_Issend(buffer[0], position , MPI_PACKED, *neighbour, commTag_, comm_, req++);
-      }
+  template<typename T, typename A, typename S>
+  inline void RemoteIndices<T,A,S>::finishRebuild(RebuildState& state)
+  {
+    progressRebuild(state, true);
+    sourceSeqNo_ = state.sourceSeqNo;
+    destSeqNo_ = state.destSeqNo;
+    firstBuild=false;
+    publicIgnored=state.ignorePublic;
+  }
 
-      //Test for received messages
+  template<typename T, typename A, typename S>
+  template<bool ignorePublic>
+  inline std::map<int,std::vector<typename RemoteIndices<T,A,S>::GlobalIndex> >
+  RemoteIndices<T,A,S>::publishToRendezvous()
+  {
+    int procs;
+    MPI_Comm_size(comm_, &procs);
 
-      for(size_type received=0; received <noNeighbours; ++received)
-      {
-        MPI_Status status;
-        // probe for next message
-        MPI_Probe(MPI_ANY_SOURCE, commTag_, comm_, &status);
-        int remoteProc=status.MPI_SOURCE;
-        int size;
-        MPI_Get_count(&status, MPI_PACKED, &size);
-        // receive message
-        MPI_Recv(buffer[1], size, MPI_PACKED, remoteProc,
-                 commTag_, comm_, &status);
-
-        unpackCreateRemote(buffer[1], sourcePairs, destPairs, remoteProc, sourcePublish,
-                           destPublish, bufferSize, sendTwo);
-      }
-      // wait for completion of pending requests
-      MPI_Status* statuses = new MPI_Status[neighbourIds.size()];
-
-      if(int(MPI_ERR_IN_STATUS)==MPI_Waitall(neighbourIds.size(), requests, statuses)) {
-        for(size_type i=0; i < neighbourIds.size(); ++i)
-          if(statuses[i].MPI_ERROR!=MPI_SUCCESS) {
-            std::cerr<<rank<<": MPI_Error occurred while receiving message."<<std::endl;
-            MPI_Abort(comm_, 999);
-          }
+    // Send each published global index to its rendezvous process
+    std::map<int,std::vector<GlobalIndex> > toRendezvous;
+    std::hash<GlobalIndex> hasher;
+
+    auto publishAll = [&](const ParallelIndexSet& indexSet){
+                        for(const auto& index : indexSet)
+                          if(ignorePublic || index.local().isPublic())
+                            toRendezvous[hasher(index.global())%procs].push_back(index.global());
+                      };
+    publishAll(*source_);
+    if(source_ != target_) {
+      publishAll(*target_);
+      // Indices present in both sets only need to be published once.
+      for(auto& [proc, globals] : toRendezvous) {
+        std::sort(globals.begin(), globals.end());
+        globals.erase(std::unique(globals.begin(), globals.end()), globals.end());
       }
-      delete[] requests;
-      delete[] statuses;
     }
+    return toRendezvous;
+  }
 
+  template<typename T, typename A, typename S>
+  inline std::map<int,std::vector<int> >
+  RemoteIndices<T,A,S>::matchAtRendezvous(const std::map<int,std::vector<GlobalIndex> >& atRendezvous)
+  {
+    // Match the global indices published by different processes
+    std::vector<std::pair<GlobalIndex,int> > publishers;
+    for(const auto& [proc, globals] : atRendezvous)
+      for(const auto& global : globals)
+        publishers.emplace_back(global, proc);
+
+    std::sort(publishers.begin(), publishers.end());
+
+    std::map<int,std::set<int> > sharing;
+    for(auto first = publishers.begin(); first != publishers.end();) {
+      auto last = first;
+      while(last != publishers.end() && !(first->first < last->first))
+        ++last;
+      for(auto p = first; p != last; ++p)
+        for(auto q = first; q != last; ++q)
+          if(p->second != q->second)
+            sharing[p->second].insert(q->second);
+      first = last;
+    }
 
-    // delete allocated memory
-    if(destPairs!=sourcePairs)
-      delete[] destPairs;
-
-    delete[] sourcePairs;
-    delete[] buffer[0];
-    delete[] buffer[1];
-    delete[] buffer;
+    std::map<int,std::vector<int> > replies;
+    for(const auto& [proc, ranks] : sharing)
+      replies[proc].assign(ranks.begin(), ranks.end());
+    return replies;
   }
 
-  template<typename T, typename A>
-  inline void RemoteIndices<T,A>::unpackIndices(RemoteIndexList& remote,
+  template<typename T, typename A, typename S>
+  inline void RemoteIndices<T,A,S>::unpackIndices(RemoteIndexList& remote,
                                                 int remoteEntries,
                                                 PairType** local,
                                                 int localEntries,
@@ -1323,6 +1891,10 @@ namespace Dune {
     if(remoteEntries==0)
       return;
 
+    // At most one remote index per received index, unless the global
+    // index is present several times.
+    Storage::reserve(remote, std::min(remoteEntries, localEntries));
+
     PairType index;
     MPI_Unpack(p_in, bufferSize, position, &index, 1,
                type, comm_);
@@ -1382,8 +1954,8 @@ namespace Dune {
   }
 
 
-  template<typename T, typename A>
-  inline void RemoteIndices<T,A>::unpackIndices(RemoteIndexList& send,
+  template<typename T, typename A, typename S>
+  inline void RemoteIndices<T,A,S>::unpackIndices(RemoteIndexList& send,
                                                 RemoteIndexList& receive,
                                                 int remoteEntries,
                                                 PairType** localSource,
@@ -1397,6 +1969,9 @@ namespace Dune {
   {
     int n_in=0, sourceIndex=0, destIndex=0;
 
+    Storage::reserve(send, std::min(remoteEntries, localSourceEntries));
+    Storage::reserve(receive, std::min(remoteEntries, localDestEntries));
+
     //Check if we know the global index
     while(n_in<remoteEntries && (sourceIndex<localSourceEntries || destIndex<localDestEntries)) {
       // Unpack next index
@@ -1424,8 +1999,8 @@ namespace Dune {
 
   }
 
-  template<typename T, typename A>
-  inline void RemoteIndices<T,A>::free()
+  template<typename T, typename A, typename S>
+  inline void RemoteIndices<T,A,S>::free()
   {
     auto lend = remoteIndices_.end();
     for(auto lists=remoteIndices_.begin(); lists != lend; ++lists) {
@@ -1441,43 +2016,43 @@ namespace Dune {
     firstBuild=true;
   }
 
-  template<typename T, typename A>
-  inline int RemoteIndices<T,A>::neighbours() const
+  template<typename T, typename A, typename S>
+  inline int RemoteIndices<T,A,S>::neighbours() const
   {
     return remoteIndices_.size();
   }
 
-  template<typename T, typename A>
+  template<typename T, typename A, typename S>
+  template<bool ignorePublic>
+  inline void RemoteIndices<T,A,S>::rebuild()
+  {
+    rebuildAsync<ignorePublic>().wait();
+  }
+
+  template<typename T, typename A, typename S>
   template<bool ignorePublic>
-  inline void RemoteIndices<T,A>::rebuild()
+  inline typename RemoteIndices<T,A,S>::Rebuild RemoteIndices<T,A,S>::rebuildAsync()
   {
     // Test whether a rebuild is Needed.
     if(firstBuild ||
        ignorePublic!=publicIgnored || !
-       isSynced()) {
-      free();
-
-      buildRemote<ignorePublic>(includeSelf);
-
-      sourceSeqNo_ = source_->seqNo();
-      destSeqNo_ = target_->seqNo();
-      firstBuild=false;
-      publicIgnored=ignorePublic;
-    }
-
-
+       isSynced())
+      return Rebuild(*this, startRebuild<ignorePublic>(includeSelf));
+    return Rebuild(*this, nullptr);
   }
 
-  template<typename T, typename A>
-  inline bool RemoteIndices<T,A>::isSynced() const
+  template<typename T, typename A, typename S>
+  inline bool RemoteIndices<T,A,S>::isSynced() const
   {
     return sourceSeqNo_==source_->seqNo() && destSeqNo_ ==target_->seqNo();
   }
 
-  template<typename T, typename A>
+  template<typename T, typename A, typename S>
   template<bool mode, bool send>
-  RemoteIndexListModifier<T,A,mode> RemoteIndices<T,A>::getModifier(int process)
+  RemoteIndexListModifier<T,A,mode> RemoteIndices<T,A,S>::getModifier(int process)
   {
+    static_assert(std::is_same<S,SLListRemoteIndexStorage>::value,
+                  "Remote indices can only be modified with the storage policy SLListRemoteIndexStorage");
 
     // The user are on their own now!
     // We assume they know what they are doing and just set the
@@ -1509,30 +2084,30 @@ namespace Dune {
       return RemoteIndexListModifier<T,A,mode>(*target_, *(found->second.second));
   }
 
-  template<typename T, typename A>
-  inline typename RemoteIndices<T,A>::const_iterator
-  RemoteIndices<T,A>::find(int proc) const
+  template<typename T, typename A, typename S>
+  inline typename RemoteIndices<T,A,S>::const_iterator
+  RemoteIndices<T,A,S>::find(int proc) const
   {
     return remoteIndices_.find(proc);
   }
 
-  template<typename T, typename A>
-  inline typename RemoteIndices<T,A>::const_iterator
-  RemoteIndices<T,A>::begin() const
+  template<typename T, typename A, typename S>
+  inline typename RemoteIndices<T,A,S>::const_iterator
+  RemoteIndices<T,A,S>::begin() const
   {
     return remoteIndices_.begin();
   }
 
-  template<typename T, typename A>
-  inline typename RemoteIndices<T,A>::const_iterator
-  RemoteIndices<T,A>::end() const
+  template<typename T, typename A, typename S>
+  inline typename RemoteIndices<T,A,S>::const_iterator
+  RemoteIndices<T,A,S>::end() const
   {
     return remoteIndices_.end();
   }
 
 
-  template<typename T, typename A>
-  bool RemoteIndices<T,A>::operator==(const RemoteIndices& ri) const
+  template<typename T, typename A, typename S>
+  bool RemoteIndices<T,A,S>::operator==(const RemoteIndices& ri) const
   {
     if(neighbours()!=ri.neighbours())
       return false;
@@ -1684,22 +2259,22 @@ namespace Dune {
     return found;
   }
 
-  template<typename T, typename A>
+  template<typename T, typename A, typename S>
   template<bool send>
-  inline typename RemoteIndices<T,A>::CollectiveIteratorT RemoteIndices<T,A>::iterator() const
+  inline typename RemoteIndices<T,A,S>::CollectiveIteratorT RemoteIndices<T,A,S>::iterator() const
   {
-    return CollectiveIterator<T,A>(remoteIndices_, send);
+    return CollectiveIterator<T,A,S>(remoteIndices_, send);
   }
 
-  template<typename T, typename A>
-  inline MPI_Comm RemoteIndices<T,A>::communicator() const
+  template<typename T, typename A, typename S>
+  inline MPI_Comm RemoteIndices<T,A,S>::communicator() const
   {
     return comm_;
 
   }
 
-  template<typename T, typename A>
-  CollectiveIterator<T,A>::CollectiveIterator(const RemoteIndexMap& pmap, bool send)
+  template<typename T, typename A, typename S>
+  CollectiveIterator<T,A,S>::CollectiveIterator(const RemoteIndexMap& pmap, bool send)
   {
 
     const auto end = pmap.end();
@@ -1711,8 +2286,8 @@ namespace Dune {
     }
   }
 
-  template<typename T, typename A>
-  inline void CollectiveIterator<T,A>::advance(const GlobalIndex& index)
+  template<typename T, typename A, typename S>
+  inline void CollectiveIterator<T,A,S>::advance(const GlobalIndex& index)
   {
     const auto end = map_.end();
 
@@ -1738,8 +2313,8 @@ namespace Dune {
     noattribute=true;
   }
 
-  template<typename T, typename A>
-  inline void CollectiveIterator<T,A>::advance(const GlobalIndex& index,
+  template<typename T, typename A, typename S>
+  inline void CollectiveIterator<T,A,S>::advance(const GlobalIndex& index,
                                                const Attribute& attribute)
   {
     const auto end = map_.end();
@@ -1774,8 +2349,8 @@ namespace Dune {
     noattribute=false;
   }
 
-  template<typename T, typename A>
-  inline CollectiveIterator<T,A>& CollectiveIterator<T,A>::operator++()
+  template<typename T, typename A, typename S>
+  inline CollectiveIterator<T,A,S>& CollectiveIterator<T,A,S>::operator++()
   {
     const auto end = map_.end();
 
@@ -1799,15 +2374,15 @@ namespace Dune {
     return *this;
   }
 
-  template<typename T, typename A>
-  inline bool CollectiveIterator<T,A>::empty() const
+  template<typename T, typename A, typename S>
+  inline bool CollectiveIterator<T,A,S>::empty() const
   {
     return map_.empty();
   }
 
-  template<typename T, typename A>
-  inline typename CollectiveIterator<T,A>::iterator
-  CollectiveIterator<T,A>::begin()
+  template<typename T, typename A, typename S>
+  inline typename CollectiveIterator<T,A,S>::iterator
+  CollectiveIterator<T,A,S>::begin()
   {
     if(noattribute)
       return iterator(map_.begin(), map_.end(), index_);
@@ -1816,9 +2391,9 @@ namespace Dune {
                       attribute_);
   }
 
-  template<typename T, typename A>
-  inline typename CollectiveIterator<T,A>::iterator
-  CollectiveIterator<T,A>::end()
+  template<typename T, typename A, typename S>
+  inline typename CollectiveIterator<T,A,S>::iterator
+  CollectiveIterator<T,A,S>::end()
   {
     return iterator(map_.end(), map_.end(), index_);
   }
@@ -1830,8 +2405,8 @@ namespace Dune {
     return os;
   }
 
-  template<typename T, typename A>
-  inline std::ostream& operator<<(std::ostream& os, const RemoteIndices<T,A>& indices)
+  template<typename T, typename A, typename S>
+  inline std::ostream& operator<<(std::ostream& os, const RemoteIndices<T,A,S>& indices)
   {
     int rank;
     MPI_Comm_rank(indices.comm_, &rank);
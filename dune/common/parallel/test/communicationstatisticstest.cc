@@ -0,0 +1,100 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <cstddef>
+#include <sstream>
+#include <vector>
+
+#include <dune/common/enumset.hh>
+#include <dune/common/parallel/communicationstatistics.hh>
+#include <dune/common/parallel/communicator.hh>
+#include <dune/common/parallel/indexset.hh>
+#include <dune/common/parallel/interface.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/parallel/plocalindex.hh>
+#include <dune/common/parallel/remoteindices.hh>
+#include <dune/common/test/testsuite.hh>
+
+enum GridFlags {
+  owner, overlap
+};
+
+using ParallelIndexSet = Dune::ParallelIndexSet<int,Dune::ParallelLocalIndex<GridFlags> >;
+using Vector = std::vector<double>;
+
+// A one dimensional decomposition with size owned indices and an overlap of one.
+void setupIndexSet(ParallelIndexSet& indexSet, int rank, int procs, int size)
+{
+  const int start = rank*size;
+  const int end = start+size;
+  indexSet.beginResize();
+  for(int i=(rank>0 ? start-1 : start), local=0; i<(rank<procs-1 ? end+1 : end); ++i, ++local)
+    indexSet.add(i, Dune::ParallelLocalIndex<GridFlags>(local, (i>=start && i<end) ? owner : overlap, true));
+  indexSet.endResize();
+}
+
+int main(int argc, char** argv)
+{
+  auto& helper = Dune::MPIHelper::instance(argc, argv);
+  auto cc = helper.getCommunication();
+  auto& statistics = Dune::CommunicationStatistics::instance();
+  Dune::TestSuite suite;
+
+  suite.require(Dune::CommunicationStatistics::enabled, "enabled");
+  statistics.clear();
+
+  for(int i=0; i<3; ++i)
+    cc.barrier();
+  double value = cc.rank();
+  cc.sum(value);
+  suite.check(statistics.counters("Communication::barrier").calls == 3, "barrier calls");
+  auto allreduce = statistics.counters("Communication::allreduce");
+  suite.check(allreduce.calls == 1, "allreduce calls");
+  suite.check(allreduce.bytes == sizeof(double), "allreduce bytes") << allreduce.bytes;
+  suite.check(allreduce.time >= allreduce.waitTime, "allreduce time");
+
+  ParallelIndexSet indexSet;
+  setupIndexSet(indexSet, cc.rank(), cc.size(), 10);
+  Dune::RemoteIndices<ParallelIndexSet> remoteIndices(indexSet, indexSet, helper.getCommunicator());
+  remoteIndices.rebuild<false>();
+  Dune::Interface interface;
+  interface.build(remoteIndices, Dune::EnumItem<GridFlags,owner>(),
+                  Dune::EnumItem<GridFlags,overlap>());
+
+  Vector data(indexSet.size(), cc.rank());
+  Dune::BufferedCommunicator communicator;
+  communicator.build<Vector>(interface);
+  const int iterations = 5;
+  for(int i=0; i<iterations; ++i)
+    communicator.forward<Dune::CopyGatherScatter<Vector> >(data);
+  communicator.free();
+
+  // Every process sends its first and last owned index to its neighbours.
+  const std::size_t neighbours = (cc.rank()>0) + (cc.rank()<cc.size()-1);
+  auto start = statistics.counters("BufferedCommunicator::start");
+  suite.check(start.calls == iterations, "start calls") << start.calls;
+  suite.check(start.neighbours == iterations*neighbours, "start neighbours") << start.neighbours;
+  suite.check(start.messages == iterations*neighbours, "start messages") << start.messages;
+  suite.check(start.bytes == iterations*neighbours*sizeof(double), "start bytes") << start.bytes;
+  suite.check(statistics.counters("BufferedCommunicator::finish").calls == iterations, "finish calls");
+
+  // Only the scopes record.
+  Dune::Impl::CommunicationScope::message(100);
+  suite.check(statistics.counters("BufferedCommunicator::start").bytes == start.bytes, "outside scope");
+
+  std::ostringstream report;
+  statistics.report(report, helper.getCommunicator());
+  if(cc.rank() == 0) {
+    suite.check(report.str().find("BufferedCommunicator::start") != std::string::npos, "report")
+      << report.str();
+    std::cout << report.str();
+  }
+
+  statistics.clear();
+  suite.check(statistics.counters("Communication::barrier").calls == 0, "clear");
+
+  // reported again by the MPIHelper at finalization
+  cc.barrier();
+  return suite.exit();
+}
@@ -4,8 +4,134 @@
 #include <mpi.h>
 #endif
 
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <dune/common/binaryfunctions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/tuplevector.hh>
 #include <dune/common/parallel/mpihelper.hh>
 
+// Test the reductions that are mapped to intrinsic MPI operations
+template<class CC>
+int testReductions(CC cc)
+{
+    int ret = 0;
+    const int rank = cc.rank(), size = cc.size();
+    const double ranksum = size*(size-1)/2.0;
+
+    using Vector = Dune::FieldVector<double,3>;
+    std::vector<Vector> vectors(5);
+    for (std::size_t i=0; i<vectors.size(); ++i)
+        vectors[i] = {double(rank), double(i), 1.0};
+    cc.sum(vectors.data(), vectors.size());
+    for (std::size_t i=0; i<vectors.size(); ++i)
+        if (vectors[i] != Vector{ranksum, double(i*size), double(size)})
+        {
+            std::cerr<<rank<<": sum of FieldVectors is "<<vectors[i]<<std::endl;
+            ++ret;
+        }
+
+    Vector single = cc.sum(Vector{1.0, double(rank), 2.0});
+    Vector inplace = cc.template iallreduce<std::plus<Vector> >(Vector{1.0, double(rank), 2.0}).get();
+    if (single != inplace || single != Vector{double(size), ranksum, 2.0*size})
+    {
+        std::cerr<<rank<<": sum of a FieldVector is "<<single<<" and "<<inplace<<std::endl;
+        ++ret;
+    }
+
+    // the smallest value is held by the two last ranks
+    using Pair = std::pair<double,int>;
+    const Pair local((rank+2)%size < 2 ? -1.0 : rank, rank);
+    Pair minloc, maxloc;
+    cc.template allreduce<Dune::MinLoc<Pair> >(&local, &minloc, 1);
+    cc.template allreduce<Dune::MaxLoc<Pair> >(&local, &maxloc, 1);
+    const Pair expectedMin(-1.0, size>2 ? size-2 : 0);
+    const Pair expectedMax(size>2 ? size-3.0 : -1.0, size>2 ? size-3 : 0);
+    if (minloc != expectedMin || maxloc != expectedMax)
+    {
+        std::cerr<<rank<<": minloc is ("<<minloc.first<<","<<minloc.second
+                 <<") and maxloc is ("<<maxloc.first<<","<<maxloc.second<<")"<<std::endl;
+        ++ret;
+    }
+
+    // a location type without predefined MPI datatype uses a user defined operation
+    using LongPair = std::pair<int,long>;
+    LongPair longMin;
+    const LongPair longLocal(rank%2, size-rank);
+    cc.template allreduce<Dune::MinLoc<LongPair> >(&longLocal, &longMin, 1);
+    if (longMin != LongPair(0, 2-size%2))
+    {
+        std::cerr<<rank<<": minloc of long locations is ("<<longMin.first<<","<<longMin.second<<")"<<std::endl;
+        ++ret;
+    }
+    return ret;
+}
+
+// Test reducing several values with different operations at once
+template<class CC>
+int testTupleReduction(CC cc)
+{
+    int ret = 0;
+    const int rank = cc.rank(), size = cc.size();
+    using Reduction = Dune::TupleReduction<std::plus<double>, Dune::Max<int>, Dune::Min<long>, Dune::Max<char> >;
+
+    const std::tuple<double,int,long,char> expected(size*(size+1)/2.0, size-1, -size, 'a');
+    auto blocking = cc.template allreduce<Reduction>(std::tuple<double,int,long,char>(rank+1.0, rank, -rank-1, 'a'));
+    Dune::TupleVector<double,int,long,char> inplace(rank+1.0, rank, -rank-1, 'a');
+    cc.template allreduce<Reduction>(inplace);
+    auto nonblocking = cc.template iallreduce<Reduction>(std::tuple<double,int,long,char>(rank+1.0, rank, -rank-1, 'a')).get();
+    if (blocking != expected || static_cast<const std::tuple<double,int,long,char>&>(inplace) != expected
+        || nonblocking != expected)
+    {
+        std::cerr<<rank<<": wrong result of tuple reduction"<<std::endl;
+        ++ret;
+    }
+    return ret;
+}
+
+// Test broadcast and the gather operations
+template<class CC>
+int testCollectives(CC cc)
+{
+    int ret = 0;
+    const int rank = cc.rank(), size = cc.size();
+
+    std::vector<double> values(4, rank);
+    cc.broadcast(values.data(), values.size(), size-1);
+    if (values != std::vector<double>(4, size-1))
+    {
+        std::cerr<<rank<<": broadcast from "<<size-1<<" received "<<values[0]<<std::endl;
+        ++ret;
+    }
+
+    std::vector<std::pair<int,int> > gathered(2*size);
+    const std::pair<int,int> mine[2] = {{rank, 0}, {rank, 1}};
+    cc.allgather(mine, 2, gathered.data());
+    std::vector<int> counts(size), displ(size);
+    for (int r=0; r<size; ++r)
+    {
+        counts[r] = r+1;
+        displ[r] = r*(r+1)/2;
+    }
+    std::vector<int> varying(size*(size+1)/2);
+    const std::vector<int> myVarying(rank+1, rank);
+    cc.allgatherv(myVarying.data(), rank+1, varying.data(), counts.data(), displ.data());
+    for (int r=0; r<size; ++r)
+    {
+        bool correct = gathered[2*r] == std::make_pair(r, 0) && gathered[2*r+1] == std::make_pair(r, 1);
+        for (int i=0; i<=r; ++i)
+            correct = correct && varying[displ[r]+i] == r;
+        if (!correct)
+        {
+            std::cerr<<rank<<": wrong data of rank "<<r<<" gathered"<<std::endl;
+            ++ret;
+        }
+    }
+    return ret;
+}
+
 int main(int argc, char** argv)
 {
     Dune::MPIHelper::instance(argc, argv);
@@ -34,6 +160,30 @@ int main(int argc, char** argv)
 
     [[maybe_unused]] Dune::MPIHelper::MPICommunicator comm = Dune::MPIHelper::getCommunication();
 
+    ret += testReductions(Dune::FakeMPIHelper::getCommunication());
+    ret += testReductions(Dune::MPIHelper::getCommunication());
+    ret += testTupleReduction(Dune::FakeMPIHelper::getCommunication());
+    ret += testTupleReduction(Dune::MPIHelper::getCommunication());
+    ret += testCollectives(Dune::FakeMPIHelper::getCommunication());
+    ret += testCollectives(Dune::MPIHelper::getCommunication());
+
+#if HAVE_MPI
+    // hierarchical mode with one group per node and groups of two processes
+    for (int groupSize : {0, 2})
+    {
+        Dune::Communication<MPI_Comm> hierarchical(MPI_COMM_WORLD);
+        hierarchical.enableHierarchicalMode(groupSize);
+        if (!hierarchical.hierarchicalMode())
+        {
+            std::cerr<<"hierarchical mode was not switched on"<<std::endl;
+            ++ret;
+        }
+        ret += testReductions(hierarchical);
+        ret += testTupleReduction(hierarchical);
+        ret += testCollectives(hierarchical);
+    }
+#endif
+
 #if HAVE_MPI
     if (MPI_COMM_SELF !=  Dune::MPIHelper::getLocalCommunicator())
     {
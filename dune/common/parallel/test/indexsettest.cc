@@ -2,12 +2,19 @@
 // vi: set et ts=4 sw=2 sts=2:
 // SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
 // SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
+#include <iterator>
 #include <ostream>
+#include <random>
+#include <vector>
 
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/hashedlookupindexset.hh>
 #include <dune/common/parallel/indexset.hh>
 #include <dune/common/parallel/localindex.hh>
+#include <dune/common/parallel/plocalindex.hh>
 
 int testDeleteIndices()
 {
@@ -74,7 +81,153 @@ int testDeleteIndices()
   return ret;
 }
 
+template<class G>
+int testHashedLookup(G stride, G first, bool dense)
+{
+  typedef Dune::ParallelIndexSet<G,Dune::LocalIndex,15> IndexSet;
+  IndexSet indexSet;
+
+  indexSet.beginResize();
+  for(int i=0; i<100; i++)
+    if(i%7 != 3)
+      indexSet.add(first+i*stride, Dune::LocalIndex(i));
+  indexSet.endResize();
+
+  Dune::HashedGlobalLookupIndexSet<IndexSet> lookup(indexSet);
+  int ret=0;
+
+  if(lookup.isDense() != dense) {
+    std::cerr<<"Wrong lookup structure!"<<std::endl;
+    ret++;
+  }
+
+  // All indices are found at the same pairs as with binary search.
+  for(const auto& pair : indexSet)
+    if(&lookup[pair.global()] != &indexSet[pair.global()]) {
+      std::cerr<<"Global index "<<pair.global()<<" not found!"<<std::endl;
+      ret++;
+    }
+
+  // Missing indices and indices outside of the range are not found.
+  std::vector<G> globals;
+  for(int i=-5; i<110; i++)
+    globals.push_back(first+i*stride);
+  globals.push_back(first+1);
+
+  std::vector<const typename IndexSet::IndexPair*> pairs;
+  lookup.lookup(globals, std::back_inserter(pairs));
+
+  if(pairs.size() != globals.size()) {
+    std::cerr<<"Wrong number of looked up indices!"<<std::endl;
+    return ++ret;
+  }
+
+  for(std::size_t i=0; i<globals.size(); i++) {
+    const bool present = (i >= 5 && i < 105 && (i-5)%7 != 3 && globals[i] != first+1) || (globals[i] == first+1 && stride == 1);
+    if(pairs[i] != lookup.find(globals[i]) || (pairs[i] != nullptr) != present) {
+      std::cerr<<"Lookup of global index "<<globals[i]<<" failed!"<<std::endl;
+      ret++;
+    }
+    if(pairs[i] && pairs[i]->global() != globals[i]) {
+      std::cerr<<"Wrong pair for global index "<<globals[i]<<"!"<<std::endl;
+      ret++;
+    }
+  }
+
+  try {
+    lookup[first-stride];
+    std::cerr<<"Missing global index did not throw!"<<std::endl;
+    ret++;
+  }
+  catch(const Dune::RangeError&) {}
+
+  return ret;
+}
+
+enum Flag { owner, overlap, border };
+
+// Adds random indices in two resizes and deletes some in the second one.
+// The pairs with equal global indices have to be ordered by their attribute
+// and otherwise keep the order in which they were added.
+template<class G>
+int testSortAndMerge(std::size_t n, std::size_t threads)
+{
+  typedef Dune::ParallelLocalIndex<Flag> Local;
+  typedef Dune::ParallelIndexSet<G,Local,100> IndexSet;
+  typedef typename IndexSet::IndexPair IndexPair;
+  typedef Dune::IndexSetSortFunctor<G,Local> Compare;
+
+  std::mt19937 generator(n);
+  std::uniform_int_distribution<long long> globals(-(long long)n/2, n/2);
+  std::uniform_int_distribution<int> flags(0, 2);
+  auto randomPairs = [&](std::size_t size){
+                       std::vector<IndexPair> pairs;
+                       for(std::size_t i=0; i<size; ++i) {
+                         // negative values wrap around for unsigned indices
+                         const G global = G(globals(generator));
+                         pairs.push_back(IndexPair(global, Local(i, Flag(flags(generator)), i%2)));
+                       }
+                       return pairs;
+                     };
+  const std::vector<IndexPair> first = randomPairs(n), second = randomPairs(n/3);
+
+  IndexSet indexSet;
+  indexSet.beginResize();
+  for(const auto& pair : first)
+    indexSet.add(pair.global(), pair.local());
+  indexSet.endResize(threads);
+
+  std::vector<IndexPair> expected = first;
+  std::stable_sort(expected.begin(), expected.end(), Compare());
+
+  indexSet.beginResize();
+  std::vector<IndexPair> kept;
+  std::size_t i=0;
+  for(auto pair = indexSet.begin(); pair != indexSet.end(); ++pair, ++i)
+    if(i%5 == 0)
+      indexSet.markAsDeleted(pair);
+    else
+      kept.push_back(expected[i]);
+  for(const auto& pair : second)
+    indexSet.add(pair.global(), pair.local());
+  indexSet.endResize(threads);
+
+  std::vector<IndexPair> added = second;
+  std::stable_sort(added.begin(), added.end(), Compare());
+  // new pairs are placed before equivalent old ones
+  expected.clear();
+  std::merge(added.begin(), added.end(), kept.begin(), kept.end(),
+             std::back_inserter(expected), Compare());
+
+  if(indexSet.size() != expected.size()) {
+    std::cerr<<"Wrong number of indices after sorting with "<<threads<<" threads!"<<std::endl;
+    return 1;
+  }
+  int ret=0;
+  i=0;
+  for(auto pair = indexSet.begin(); pair != indexSet.end(); ++pair, ++i)
+    if(pair->global() != expected[i].global() || pair->local() != expected[i].local().local()
+       || pair->local().attribute() != expected[i].local().attribute()) {
+      std::cerr<<"Wrong index "<<*pair<<" at position "<<i<<" after sorting with "
+               <<threads<<" threads, expected "<<expected[i]<<"!"<<std::endl;
+      ++ret;
+      break;
+    }
+  return ret;
+}
+
 int main(int, char **)
 {
-  std::exit(testDeleteIndices());
+  int ret = testDeleteIndices();
+  ret += testHashedLookup<int>(1, -20, true);
+  ret += testHashedLookup<int>(1000, -5000, false);
+  ret += testHashedLookup<long long>(1ll<<40, 7, false);
+  for(std::size_t threads : {1, 3}) {
+    ret += testSortAndMerge<int>(1000, threads);
+    ret += testSortAndMerge<int>(100000, threads);
+    ret += testSortAndMerge<long long>(100000, threads);
+    ret += testSortAndMerge<unsigned>(100000, threads);
+    ret += testSortAndMerge<double>(100000, threads);
+  }
+  std::exit(ret);
 }
@@ -4,13 +4,17 @@
 #include <functional>
 #include <iostream>
 #include <numeric>
+#include <set>
+#include <thread>
 #include <vector>
 
 #include <dune/common/dynvector.hh>
+#include <dune/common/exceptions.hh>
 #include <dune/common/typetraits.hh>
 #include <dune/common/parallel/mpidata.hh>
 #include <dune/common/parallel/mpifuture.hh>
 #include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/parallel/mpiprogress.hh>
 
 namespace Dune {
   template<class Dummy>
@@ -23,9 +27,104 @@ namespace Dune {
   };
 }
 
+// Exchange a value with every rank and wait with waitAll, waitAny and waitSome
+template<class CC>
+int testWaitFunctions(CC& cc){
+  int ret = 0;
+  const int rank = cc.rank(), size = cc.size();
+  std::vector<Dune::MPIFuture<int>> sends, recvs;
+  for(int i = 0; i < size; ++i)
+    recvs.push_back(cc.irecv(-1, i, 10));
+  for(int i = 0; i < size; ++i)
+    sends.push_back(cc.isend(100*rank+i, i, 10));
+
+  std::set<std::size_t> completed;
+  std::size_t any = Dune::waitAny(recvs);
+  if(any < recvs.size())
+    completed.insert(any);
+  while(completed.size() < recvs.size()){
+    std::vector<std::size_t> some = Dune::waitSome(recvs);
+    completed.insert(some.begin(), some.end());
+    if(some.empty())
+      break;
+  }
+  Dune::waitAll(sends);
+  for(int i = 0; i < size; ++i){
+    if(!sends[i].ready() || !recvs[i].ready() || completed.count(i) != 1){
+      std::cerr << "Rank " << rank << ": communication with " << i << " not completed" << std::endl;
+      ++ret;
+    }
+    const int value = recvs[i].get();
+    if(value != 100*i+rank){
+      std::cerr << "Rank " << rank << " received " << value << " from " << i << std::endl;
+      ++ret;
+    }
+  }
+  return ret;
+}
+
+// Pass a token twice around the ring, the second time from a continuation
+template<class CC>
+int testProgressEngine(CC& cc, bool thread){
+  int ret = 0;
+  const int rank = cc.rank(), size = cc.size();
+  const int src = (rank - 1 + size) % size, dest = (rank + 1) % size;
+  Dune::MPIProgressEngine engine;
+  if(thread)
+    engine.startThread();
+  int first = -1, second = -1;
+  bool sent = false;
+  engine.then(cc.irecv(0, src, 20), [&](int token){
+      first = token;
+      engine.then(cc.isend(token+1, dest, 21), [&](int){ sent = true; });
+    });
+  engine.then(cc.irecv(0, src, 21), [&](int token){ second = token; });
+  engine.then(cc.isend(int(rank), dest, 20), [](int){});
+  engine.then(cc.ibarrier(), []{});
+  engine.wait();
+  if(engine.pending() != 0 || !sent || first != src || second != (src - 1 + size) % size + 1){
+    std::cerr << "Rank " << rank << ": continuations received " << first << " and " << second << std::endl;
+    ++ret;
+  }
+  return ret;
+}
+
+// An exception of a continuation run by the progress thread is rethrown by
+// the owning thread
+template<class CC>
+int testProgressThreadException(CC& cc){
+  int ret = 0;
+  Dune::MPIProgressEngine engine;
+  engine.startThread();
+  engine.then(cc.ibarrier(), []{
+      DUNE_THROW(Dune::Exception, "thrown by a continuation");
+    });
+  // only the progress thread runs continuations until it is stopped
+  while(engine.pending() > 0)
+    std::this_thread::yield();
+  bool caught = false;
+  try{
+    engine.stopThread();
+  }catch(const Dune::Exception&){
+    caught = true;
+  }
+  if(!caught){
+    std::cerr << "Rank " << cc.rank() << ": stopThread() did not rethrow" << std::endl;
+    ++ret;
+  }
+  // the exception is rethrown only once
+  try{
+    engine.wait();
+  }catch(const Dune::Exception&){
+    std::cerr << "Rank " << cc.rank() << ": wait() rethrew again" << std::endl;
+    ++ret;
+  }
+  return ret;
+}
 
 int main(int argc, char** argv){
-  auto& mpihelper = Dune::MPIHelper::instance(argc, argv);
+  // the progress thread requires MPI_THREAD_MULTIPLE
+  auto& mpihelper = Dune::MPIHelper::instance(argc, argv, MPI_THREAD_MULTIPLE);
 
   auto cc = mpihelper.getCommunication();
 
@@ -114,6 +213,14 @@ int main(int argc, char** argv){
     std::cout << "Allreduce result on rank " << mpihelper.rank() <<": " << f.get() << std::endl;
   }
 
+  int ret = testWaitFunctions(cc);
+  ret += testProgressEngine(cc, false);
+  if(mpihelper.threadLevel() == MPI_THREAD_MULTIPLE)
+  {
+    ret += testProgressEngine(cc, true);
+    ret += testProgressThreadException(cc);
+  }
+
   // that's wrong, MPIFuture will hold a dangeling reference:
   // Dune::MPIFuture<int&> g;
   // {
@@ -121,5 +228,5 @@ int main(int argc, char** argv){
   //   g = cc.iallreduce<std::plus<int>>(i);
   // }
   // g.wait();
-  return 0;
+  return ret;
 }
@@ -5,6 +5,8 @@
 
 #include <iostream>
 #include <map>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include <dune/common/classname.hh>
@@ -142,6 +144,79 @@ auto testASyncVector(Comm comm)
   return suite;
 }
 
+template<typename Comm>
+auto testMeasureAndReuse(Comm comm)
+{
+  Dune::TestSuite suite("testMeasureAndReuse");
+
+  int rank = comm.rank();
+  int src  = (rank - 1 + comm.size()) % comm.size();
+  int dest = (rank + 1) % comm.size();
+
+  Dune::MPIPackBufferPool pool;
+  for (int round = 0; round < 2; ++round)
+  {
+    Dune::MPIPack pack(comm, pool.get());
+    const std::vector<double> values(10, 0.5);
+    const std::string name = "MPIPack";
+    const std::pair<double,int> pair(2.5, rank);
+
+    // measure
+    std::size_t size = 0;
+    for (int i = 0; i < 1000; ++i)
+      size += pack.packSize(i);
+    size += pack.packSize(values) + pack.packSize(name) + pack.packSize(pair);
+    pack.reserve(size);
+    const char* buffer = static_cast<const char*>(getMPIData(pack).ptr());
+
+    // pack without reallocation
+    for (int i = 0; i < 1000; ++i)
+      pack << i;
+    pack << values << name << pair;
+    suite.check(static_cast<const char*>(getMPIData(pack).ptr()) == buffer)
+      << "packing measured data reallocated the buffer";
+    suite.check(std::size_t(pack.tell()) <= size && pack.size() == size)
+      << "packed " << pack.tell() << " bytes into a buffer of " << pack.size();
+    if (Dune::MPIPack::packsNatively(comm))
+      suite.check(std::size_t(pack.tell()) == 1000*sizeof(int) + sizeof(int) + 10*sizeof(double)
+                  + sizeof(int) + name.size() + pack.packSize(pair))
+        << "trivially copyable data is not packed with memcpy";
+
+    // the message is too large to be sent to ourselves with a blocking send
+    auto sendFuture = comm.isend(std::move(pack), dest, TAG+round);
+    Dune::MPIPack received = comm.rrecv(Dune::MPIPack(comm), src, TAG+round);
+    Dune::MPIPack sent = sendFuture.get();
+    pool.put(sent.release());
+    suite.check(sent.size() == 0 && pool.size() == 1) << "buffer was not returned to the pool";
+
+    bool correct = true;
+    for (int i = 0; i < 1000; ++i)
+    {
+      int j; received >> j;
+      correct = correct && i == j;
+    }
+    std::vector<double> receivedValues;
+    std::string receivedName;
+    std::pair<double,int> receivedPair;
+    received >> receivedValues >> receivedName >> receivedPair;
+    suite.check(correct && receivedValues == values && receivedName == name
+                && receivedPair == std::make_pair(2.5, src))
+      << "received wrong values";
+
+    received.clear();
+    suite.check(received.size() == 0 && received.tell() == 0) << "clear did not empty the buffer";
+    // only the memcpy path checks the end of the buffer, MPI_Unpack
+    // reports it through the error handler of the communicator
+    if (Dune::MPIPack::packsNatively(comm))
+    {
+      int dummy;
+      suite.checkThrow<Dune::RangeError>([&]{ received >> dummy; })
+        << "unpacking from an empty buffer did not throw";
+    }
+  }
+  return suite;
+}
+
 int main(int argc, char** argv){
   Dune::MPIHelper& helper = Dune::MPIHelper::instance(argc, argv);
   Dune::TestSuite suite;
@@ -153,5 +228,7 @@ int main(int argc, char** argv){
 
   suite.subTest(testASync(comm));
 
+  suite.subTest(testMeasureAndReuse(comm));
+
   return suite.exit();
 }
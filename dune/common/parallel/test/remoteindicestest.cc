@@ -3,9 +3,11 @@
 // SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
 // SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
 #include <algorithm>
+#include <functional>
 #include <iostream>
 #include <ostream>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #if HAVE_MPI
@@ -595,15 +597,30 @@ void testRedistributeIndicesBuffered(MPI_Comm comm)
                             sendIndexSet, comm, neighbours);
   RemoteIndices sendIndices1(sendIndexSet,
                              sendIndexSet, comm);
+  RemoteIndices sendIndices2(sendIndexSet,
+                             sendIndexSet, comm);
+  RemoteIndices redistributeIndices1(sendIndexSet,
+                                     receiveIndexSet, comm);
+  RemoteIndices overlapIndices1(receiveIndexSet, receiveIndexSet, comm);
+  sendIndices2.setNeighbourDiscovery(true);
+  redistributeIndices1.setNeighbourDiscovery(true);
+  overlapIndices1.setNeighbourDiscovery(true);
   overlapIndices.rebuild<false>();
   redistributeIndices.rebuild<true>();
   sendIndices.rebuild<true>();
   sendIndices1.rebuild<true>();
+  sendIndices2.rebuild<true>();
+  redistributeIndices1.rebuild<true>();
+  overlapIndices1.rebuild<false>();
 
   if(rank==0)
     std::cout<<sendIndices<<std::endl<<sendIndices1<<std::endl;
 
   assert(sendIndices==sendIndices1);
+  // Neighbour discovery has to yield the same remote indices as the ring
+  assert(sendIndices1==sendIndices2);
+  assert(redistributeIndices==redistributeIndices1);
+  assert(overlapIndices==overlapIndices1);
 
   std::cout<<redistributeIndices<<std::endl;
 
@@ -644,6 +661,480 @@ void testRedistributeIndicesBuffered(MPI_Comm comm)
 }
 
 
+void testPersistentBuffered(MPI_Comm comm)
+{
+  using namespace Dune;
+
+  // The global grid size
+  const int Nx = 20;
+  const int Ny = 2;
+
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+
+  typedef ParallelIndexSet<int,ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+
+  ParallelIndexSet distIndexSet;
+  Array distArray, persistentArray;
+
+  setupDistributed<Nx,Ny>(distArray, distIndexSet, rank, procs);
+  setupDistributed<Nx,Ny>(persistentArray, distIndexSet, rank, procs);
+
+  typedef RemoteIndices<ParallelIndexSet> RemoteIndices;
+  RemoteIndices overlapIndices(distIndexSet, distIndexSet, comm);
+  overlapIndices.rebuild<false>();
+
+  Interface overlapInterface;
+  overlapInterface.build(overlapIndices, EnumItem<GridFlags,owner>(),
+                         EnumItem<GridFlags,overlap>());
+
+  BufferedCommunicator overlapComm;
+  BufferedCommunicator persistentComm(true);
+  overlapComm.build<Array>(overlapInterface);
+  persistentComm.build<Array>(overlapInterface);
+
+  // Communicate several times to reuse the persistent requests
+  for(int i=0; i<3; ++i) {
+    overlapComm.forward<ArrayGatherScatter>(distArray);
+    persistentComm.forward<ArrayGatherScatter>(persistentArray);
+    distArray+=1;
+    persistentArray+=1;
+    overlapComm.backward<ArrayGatherScatter>(distArray);
+    persistentComm.backward<ArrayGatherScatter>(persistentArray);
+  }
+
+  for(auto index = distIndexSet.begin(); index != distIndexSet.end(); ++index)
+    assert(distArray[index->local()]==persistentArray[index->local()]);
+
+  std::cout<<rank<<": persistent array: "<<persistentArray<<std::endl;
+}
+
+void testSplitPhase(MPI_Comm comm)
+{
+  using namespace Dune;
+
+  // The global grid size
+  const int Nx = 20;
+  const int Ny = 2;
+
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+
+  typedef ParallelIndexSet<int,ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+
+  ParallelIndexSet distIndexSet;
+  Array distArray, splitArray, persistentArray, datatypeArray;
+
+  setupDistributed<Nx,Ny>(distArray, distIndexSet, rank, procs);
+  setupDistributed<Nx,Ny>(splitArray, distIndexSet, rank, procs);
+  setupDistributed<Nx,Ny>(persistentArray, distIndexSet, rank, procs);
+  setupDistributed<Nx,Ny>(datatypeArray, distIndexSet, rank, procs);
+
+  typedef RemoteIndices<ParallelIndexSet> RemoteIndices;
+  RemoteIndices overlapIndices(distIndexSet, distIndexSet, comm);
+  overlapIndices.rebuild<false>();
+
+  Interface overlapInterface;
+  overlapInterface.build(overlapIndices, EnumItem<GridFlags,owner>(),
+                         EnumItem<GridFlags,overlap>());
+
+  BufferedCommunicator overlapComm, splitComm;
+  BufferedCommunicator persistentComm(true);
+  overlapComm.build<Array>(overlapInterface);
+  splitComm.build<Array>(overlapInterface);
+  persistentComm.build<Array>(overlapInterface);
+
+  DatatypeCommunicator<ParallelIndexSet> datatypeComm;
+  datatypeComm.build(overlapIndices, EnumItem<GridFlags,owner>(), datatypeArray,
+                     EnumItem<GridFlags,overlap>(), datatypeArray);
+
+  for(int i=0; i<3; ++i) {
+    overlapComm.forward<ArrayGatherScatter>(distArray);
+
+    auto splitExchange = splitComm.forwardBegin<ArrayGatherScatter>(splitArray);
+    // Scatter incrementally while testing for completion
+    while(!splitExchange.ready())
+      ;
+    splitComm.forwardEnd(splitExchange);
+    assert(!splitExchange.valid());
+
+    // Complete by the type erased future
+    Future<void> persistentFuture = persistentComm.forwardBegin<ArrayGatherScatter>(persistentArray);
+    persistentFuture.wait();
+
+    auto datatypeExchange = datatypeComm.forwardBegin();
+    datatypeComm.forwardEnd(datatypeExchange);
+
+    distArray+=1;
+    splitArray+=1;
+    persistentArray+=1;
+    datatypeArray+=1;
+
+    overlapComm.backward<ArrayGatherScatter>(distArray);
+    auto splitBackward = splitComm.backwardBegin<ArrayGatherScatter>(splitArray);
+    splitComm.backwardEnd(splitBackward);
+    auto persistentBackward = persistentComm.backwardBegin<ArrayGatherScatter>(persistentArray);
+    persistentComm.backwardEnd(persistentBackward);
+    auto datatypeBackward = datatypeComm.backwardBegin();
+    datatypeComm.backwardEnd(datatypeBackward);
+  }
+
+  for(auto index = distIndexSet.begin(); index != distIndexSet.end(); ++index) {
+    assert(distArray[index->local()]==splitArray[index->local()]);
+    assert(distArray[index->local()]==persistentArray[index->local()]);
+    assert(distArray[index->local()]==datatypeArray[index->local()]);
+  }
+
+  std::cout<<rank<<": split phase array: "<<splitArray<<std::endl;
+}
+
+void testRebuildAsync(MPI_Comm comm)
+{
+  using namespace Dune;
+
+  // The global grid size
+  const int Nx = 20;
+  const int Ny = 2;
+
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+
+  typedef ParallelIndexSet<int,ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+
+  ParallelIndexSet distIndexSet;
+  Array distArray;
+  setupDistributed<Nx,Ny>(distArray, distIndexSet, rank, procs);
+
+  std::vector<int> neighbours;
+  if(rank>0) neighbours.push_back(rank-1);
+  if(rank<procs-1) neighbours.push_back(rank+1);
+
+  typedef RemoteIndices<ParallelIndexSet> RemoteIndices;
+  RemoteIndices ringIndices(distIndexSet, distIndexSet, comm);
+  RemoteIndices asyncRingIndices(distIndexSet, distIndexSet, comm);
+  RemoteIndices asyncNeighbourIndices(distIndexSet, distIndexSet, comm, neighbours);
+  RemoteIndices asyncDiscoveredIndices(distIndexSet, distIndexSet, comm);
+  asyncDiscoveredIndices.setNeighbourDiscovery(true);
+  ringIndices.rebuild<false>();
+
+  // Overlap the rebuilds with some local work. Only one rebuild may be
+  // in progress on a communicator.
+  auto ringRebuild = asyncRingIndices.rebuildAsync<false>();
+  double work = 0;
+  for(int i=0; !ringRebuild.ready(); ++i)
+    work += i;
+  ringRebuild.get();
+  assert(!ringRebuild.valid());
+  auto neighbourRebuild = asyncNeighbourIndices.rebuildAsync<false>();
+  for(int i=0; !neighbourRebuild.ready(); ++i)
+    work += i;
+  neighbourRebuild.get();
+
+  // Complete by the type erased future
+  Future<void> discoveryRebuild = asyncDiscoveredIndices.rebuildAsync<false>();
+  discoveryRebuild.wait();
+
+  if(!(ringIndices==asyncRingIndices) || !(ringIndices==asyncNeighbourIndices)
+     || !(ringIndices==asyncDiscoveredIndices))
+    DUNE_THROW(Exception, rank<<": asynchronously rebuilt remote indices differ");
+  if(!asyncRingIndices.isSynced())
+    DUNE_THROW(Exception, rank<<": remote indices not synced after rebuildAsync");
+
+  // Nothing to do if the index sets did not change
+  auto synced = asyncRingIndices.rebuildAsync<false>();
+  if(!synced.ready())
+    DUNE_THROW(Exception, rank<<": rebuild of synced remote indices not ready");
+  synced.get();
+
+  bool thrown = false;
+  try {
+    synced.wait();
+  }
+  catch(InvalidFutureException&) {
+    thrown = true;
+  }
+  if(!thrown)
+    DUNE_THROW(Exception, rank<<": waiting for an invalid rebuild did not throw");
+
+  // The rebuild completes in the destructor of the handle
+  distIndexSet.beginResize();
+  distIndexSet.endResize();
+  ringIndices.rebuild<false>();
+  {
+    auto pending = asyncNeighbourIndices.rebuildAsync<false>();
+  }
+  if(!(ringIndices==asyncNeighbourIndices))
+    DUNE_THROW(Exception, rank<<": remote indices differ after destroying the handle");
+
+  std::cout<<rank<<": rebuilt asynchronously, work "<<work<<std::endl;
+}
+
+void testNeighborhood(MPI_Comm comm)
+{
+  using namespace Dune;
+
+  // The global grid size
+  const int Nx = 20;
+  const int Ny = 2;
+
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+
+  typedef ParallelIndexSet<int,ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+
+  ParallelIndexSet distIndexSet;
+  Array distArray, neighborArray, datatypeArray;
+
+  setupDistributed<Nx,Ny>(distArray, distIndexSet, rank, procs);
+  setupDistributed<Nx,Ny>(neighborArray, distIndexSet, rank, procs);
+  setupDistributed<Nx,Ny>(datatypeArray, distIndexSet, rank, procs);
+
+  typedef RemoteIndices<ParallelIndexSet> RemoteIndices;
+  RemoteIndices overlapIndices(distIndexSet, distIndexSet, comm);
+  overlapIndices.rebuild<false>();
+
+  Interface overlapInterface;
+  overlapInterface.build(overlapIndices, EnumItem<GridFlags,owner>(),
+                         EnumItem<GridFlags,overlap>());
+
+  BufferedCommunicator overlapComm;
+  BufferedCommunicator neighborComm(CommunicationBackend::neighborhoodCollective);
+  overlapComm.build<Array>(overlapInterface);
+  neighborComm.build<Array>(overlapInterface);
+
+  DatatypeCommunicator<ParallelIndexSet> datatypeComm(CommunicationBackend::neighborhoodCollective);
+  datatypeComm.build(overlapIndices, EnumItem<GridFlags,owner>(), datatypeArray,
+                     EnumItem<GridFlags,overlap>(), datatypeArray);
+
+  for(int i=0; i<3; ++i) {
+    overlapComm.forward<ArrayGatherScatter>(distArray);
+    if(i%2)
+      neighborComm.forward<ArrayGatherScatter>(neighborArray);
+    else{
+      auto exchange = neighborComm.forwardBegin<ArrayGatherScatter>(neighborArray);
+      while(!exchange.ready())
+        ;
+      neighborComm.forwardEnd(exchange);
+    }
+    datatypeComm.forward();
+
+    distArray+=1;
+    neighborArray+=1;
+    datatypeArray+=1;
+
+    overlapComm.backward<ArrayGatherScatter>(distArray);
+    neighborComm.backward<ArrayGatherScatter>(neighborArray);
+    auto datatypeBackward = datatypeComm.backwardBegin();
+    datatypeComm.backwardEnd(datatypeBackward);
+  }
+
+  for(auto index = distIndexSet.begin(); index != distIndexSet.end(); ++index) {
+    assert(distArray[index->local()]==neighborArray[index->local()]);
+    assert(distArray[index->local()]==datatypeArray[index->local()]);
+  }
+
+  std::cout<<rank<<": neighborhood array: "<<neighborArray<<std::endl;
+}
+
+void testRunCopy(MPI_Comm comm)
+{
+  using namespace Dune;
+
+  // The global grid size
+  const int Nx = 20;
+  const int Ny = 4;
+
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+
+  typedef ParallelIndexSet<int,ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+  typedef std::vector<double> Vector;
+
+  ParallelIndexSet distIndexSet;
+  Array distArray;
+
+  setupDistributed<Nx,Ny>(distArray, distIndexSet, rank, procs);
+  Vector vector(distIndexSet.size()), splitVector;
+  for(auto index = distIndexSet.begin(); index != distIndexSet.end(); ++index)
+    vector[index->local()] = distArray[index->local()];
+  splitVector = vector;
+
+  typedef RemoteIndices<ParallelIndexSet> RemoteIndices;
+  RemoteIndices overlapIndices(distIndexSet, distIndexSet, comm);
+  overlapIndices.rebuild<false>();
+
+  Interface overlapInterface;
+  overlapInterface.build(overlapIndices, EnumItem<GridFlags,owner>(),
+                         EnumItem<GridFlags,overlap>());
+
+  // The vectors are copied by whole runs of consecutive indices
+  BufferedCommunicator overlapComm, vectorComm, splitComm(true);
+  overlapComm.build<Array>(overlapInterface);
+  vectorComm.build<Vector>(overlapInterface);
+  splitComm.build<Vector>(overlapInterface);
+
+  for(int i=0; i<2; ++i) {
+    overlapComm.forward<ArrayGatherScatter>(distArray);
+    vectorComm.forward<CopyGatherScatter<Vector> >(vector);
+    auto exchange = splitComm.forwardBegin<CopyGatherScatter<Vector> >(splitVector);
+    splitComm.forwardEnd(exchange);
+
+    distArray+=1;
+    for(auto& v : vector)
+      v+=1;
+    for(auto& v : splitVector)
+      v+=1;
+
+    overlapComm.backward<ArrayGatherScatter>(distArray);
+    vectorComm.backward<CopyGatherScatter<Vector> >(vector);
+    splitComm.backward<CopyGatherScatter<Vector> >(splitVector);
+  }
+
+  for(auto index = distIndexSet.begin(); index != distIndexSet.end(); ++index) {
+    assert(distArray[index->local()]==vector[index->local()]);
+    assert(distArray[index->local()]==splitVector[index->local()]);
+  }
+
+  std::cout<<rank<<": run copy checked"<<std::endl;
+}
+
+void testVectorStorage(MPI_Comm comm)
+{
+  using namespace Dune;
+
+  // The global grid size
+  const int Nx = 20;
+  const int Ny = 2;
+
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+
+  typedef ParallelIndexSet<int,ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+  typedef RemoteIndices<ParallelIndexSet> ListRemoteIndices;
+  typedef RemoteIndices<ParallelIndexSet, ListRemoteIndices::Allocator,
+      VectorRemoteIndexStorage> VectorRemoteIndices;
+  static_assert(std::is_same<VectorRemoteIndices::RemoteIndexList,
+                    std::vector<ListRemoteIndices::RemoteIndex,ListRemoteIndices::Allocator> >::value,
+                "The remote indices have to be stored in a vector");
+
+  ParallelIndexSet distIndexSet;
+  Array distArray, vectorArray;
+
+  setupDistributed<Nx,Ny>(distArray, distIndexSet, rank, procs);
+  vectorArray.build(distIndexSet.size());
+  for(std::size_t i=0; i<distIndexSet.size(); ++i)
+    vectorArray[i] = distArray[i];
+
+  ListRemoteIndices listIndices(distIndexSet, distIndexSet, comm);
+  VectorRemoteIndices vectorIndices(distIndexSet, distIndexSet, comm);
+  listIndices.rebuild<false>();
+  vectorIndices.rebuild<false>();
+
+  // Both storages contain the same remote indices
+  assert(listIndices.neighbours()==vectorIndices.neighbours());
+  auto vector = vectorIndices.begin();
+  for(auto list = listIndices.begin(); list != listIndices.end(); ++list, ++vector) {
+    assert(list->first==vector->first);
+    assert(std::size_t(list->second.first->size())==vector->second.first->size());
+    assert(std::equal(list->second.first->begin(), list->second.first->end(),
+                      vector->second.first->begin()));
+  }
+
+  // and the collective iterators visit the same remote indices
+  auto listIterator = listIndices.iterator<true>();
+  auto vectorIterator = vectorIndices.iterator<true>();
+  for(const auto& index : distIndexSet) {
+    listIterator.advance(index.global(), index.local().attribute());
+    vectorIterator.advance(index.global(), index.local().attribute());
+    auto vectorRemote = vectorIterator.begin();
+    for(auto listRemote = listIterator.begin(); listRemote != listIterator.end(); ++listRemote, ++vectorRemote) {
+      assert(vectorRemote != vectorIterator.end());
+      assert(listRemote.process()==vectorRemote.process());
+      assert(*listRemote==*vectorRemote);
+    }
+    assert(vectorRemote==vectorIterator.end());
+  }
+
+  Interface listInterface, vectorInterface;
+  listInterface.build(listIndices, EnumItem<GridFlags,owner>(),
+                      EnumItem<GridFlags,overlap>());
+  vectorInterface.build(vectorIndices, EnumItem<GridFlags,owner>(),
+                        EnumItem<GridFlags,overlap>());
+
+  BufferedCommunicator listComm, vectorComm;
+  listComm.build<Array>(listInterface);
+  vectorComm.build<Array>(vectorInterface);
+
+  distArray+=1;
+  vectorArray+=1;
+  listComm.forward<ArrayGatherScatter>(distArray);
+  vectorComm.forward<ArrayGatherScatter>(vectorArray);
+
+  for(std::size_t i=0; i<distIndexSet.size(); ++i)
+    assert(distArray[i]==vectorArray[i]);
+
+  std::cout<<rank<<": vector storage checked"<<std::endl;
+}
+
+// A global index without a specialization of std::hash
+struct PlainGlobalIndex
+{
+  int value;
+
+  friend bool operator==(const PlainGlobalIndex& a, const PlainGlobalIndex& b)
+  {
+    return a.value==b.value;
+  }
+
+  friend bool operator<(const PlainGlobalIndex& a, const PlainGlobalIndex& b)
+  {
+    return a.value<b.value;
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, const PlainGlobalIndex& g)
+  {
+    return os<<g.value;
+  }
+};
+
+static_assert(!std::is_default_constructible<std::hash<PlainGlobalIndex> >::value,
+              "PlainGlobalIndex must not be hashable");
+
+void testNonHashableGlobalIndex(MPI_Comm comm)
+{
+  using namespace Dune;
+
+  int procs, rank;
+  MPI_Comm_size(comm, &procs);
+  MPI_Comm_rank(comm, &rank);
+
+  typedef ParallelIndexSet<PlainGlobalIndex,ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+  typedef RemoteIndices<ParallelIndexSet> RemoteIndices;
+
+  // every process owns one index and overlaps with the one of its right neighbour
+  ParallelIndexSet indexSet;
+  indexSet.beginResize();
+  indexSet.add(PlainGlobalIndex{rank}, ParallelLocalIndex<GridFlags>(0, owner, true));
+  if(rank<procs-1)
+    indexSet.add(PlainGlobalIndex{rank+1}, ParallelLocalIndex<GridFlags>(1, overlap, true));
+  indexSet.endResize();
+
+  // Neighbour discovery needs hashing, the rebuild falls back to the ring
+  RemoteIndices remoteIndices(indexSet, indexSet, comm);
+  remoteIndices.setNeighbourDiscovery(true);
+  remoteIndices.rebuild<false>();
+
+  assert(remoteIndices.neighbours()==(rank>0)+(rank<procs-1));
+
+  std::cout<<rank<<": non-hashable global index checked"<<std::endl;
+}
+
 /**
  * @brief MPI Error.
  * Thrown when an mpi error occurs.
@@ -709,6 +1200,21 @@ int main(int argc, char **argv)
 
   //  testRedistributeIndices(comm);
   testRedistributeIndicesBuffered(comm);
+  MPI_Barrier(comm);
+
+  testPersistentBuffered(comm);
+  MPI_Barrier(comm);
+  testSplitPhase(comm);
+  MPI_Barrier(comm);
+  testRebuildAsync(comm);
+  MPI_Barrier(comm);
+  testNeighborhood(comm);
+  MPI_Barrier(comm);
+  testRunCopy(comm);
+  MPI_Barrier(comm);
+  testVectorStorage(comm);
+  MPI_Barrier(comm);
+  testNonHashableGlobalIndex(comm);
   MPI_Comm_free(&comm);
   MPI_Finalize();
 
@@ -5,6 +5,7 @@
 #include <iostream>
 #include <string>
 #include <tuple>
+#include <type_traits>
 
 #if HAVE_MPI
 #include <mpi.h>
@@ -223,6 +224,99 @@ void addFakeRemoteIndices(T& indices,
   std::cout<<"Added "<<added<<" fake remote indices!"<<std::endl;
 }
 
+/**
+ * @brief A global index that is not trivially copyable.
+ *
+ * It is communicated according to its MPITraits.
+ */
+struct NonTrivialGlobalIndex
+{
+  NonTrivialGlobalIndex(int v=0) : value(v) {}
+  NonTrivialGlobalIndex(const NonTrivialGlobalIndex& other) : value(other.value) {}
+  NonTrivialGlobalIndex& operator=(const NonTrivialGlobalIndex& other)
+  {
+    value = other.value;
+    return *this;
+  }
+
+  friend bool operator==(const NonTrivialGlobalIndex& a, const NonTrivialGlobalIndex& b)
+  {
+    return a.value == b.value;
+  }
+
+  friend bool operator!=(const NonTrivialGlobalIndex& a, const NonTrivialGlobalIndex& b)
+  {
+    return a.value != b.value;
+  }
+
+  friend bool operator<(const NonTrivialGlobalIndex& a, const NonTrivialGlobalIndex& b)
+  {
+    return a.value < b.value;
+  }
+
+  friend bool operator>(const NonTrivialGlobalIndex& a, const NonTrivialGlobalIndex& b)
+  {
+    return a.value > b.value;
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, const NonTrivialGlobalIndex& g)
+  {
+    return os << g.value;
+  }
+
+  int value;
+};
+
+static_assert(!std::is_trivially_copyable<NonTrivialGlobalIndex>::value,
+              "NonTrivialGlobalIndex has to be packed with its MPITraits");
+
+/**
+ * @brief Sync an index set that lacks no indices.
+ *
+ * Every published index is already known together with its remote
+ * indices, whose attributes differ from the local ones at the process
+ * boundaries. Syncing must not insert them a second time.
+ */
+template<typename G>
+bool testSyncWithoutChanges()
+{
+  const int Nx = 6;
+
+  int procs, rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &procs);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  typedef Dune::ParallelIndexSet<G,Dune::ParallelLocalIndex<GridFlags> > ParallelIndexSet;
+  ParallelIndexSet indexSet, syncedIndexSet;
+
+  // Each process owns a block of indices and overlaps with one index of each neighbour
+  const int start = rank*Nx/procs, end = (rank+1)*Nx/procs;
+  const int ostart = rank>0 ? start-1 : start, oend = rank<procs-1 ? end+1 : end;
+
+  indexSet.beginResize();
+  syncedIndexSet.beginResize();
+  for(int i=ostart, localIndex=0; i<oend; ++i, ++localIndex) {
+    GridFlags flag = (i<start || i>=end) ? overlap : owner;
+    indexSet.add(G(i), Dune::ParallelLocalIndex<GridFlags>(localIndex, flag, true));
+    syncedIndexSet.add(G(i), Dune::ParallelLocalIndex<GridFlags>(localIndex, flag, true));
+  }
+  indexSet.endResize();
+  syncedIndexSet.endResize();
+
+  Dune::RemoteIndices<ParallelIndexSet> remoteIndices(indexSet, indexSet, MPI_COMM_WORLD);
+  Dune::RemoteIndices<ParallelIndexSet> syncedRemoteIndices(syncedIndexSet, syncedIndexSet, MPI_COMM_WORLD);
+  remoteIndices.template rebuild<false>();
+  syncedRemoteIndices.template rebuild<false>();
+
+  Dune::IndicesSyncer<ParallelIndexSet> syncer(syncedIndexSet, syncedRemoteIndices);
+  syncer.sync();
+
+  if(areEqual(indexSet, remoteIndices, syncedIndexSet, syncedRemoteIndices))
+    return true;
+  std::cerr<<rank<<": Syncing without changes altered the remote indices!"<<std::endl;
+  return false;
+}
+
 bool testIndicesSyncer()
 {
   //using namespace Dune;
@@ -359,6 +453,10 @@ int main(int argc, char** argv){
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
   bool ret=testIndicesSyncer();
   MPI_Barrier(MPI_COMM_WORLD);
+  ret=testSyncWithoutChanges<int>() && ret;
+  MPI_Barrier(MPI_COMM_WORLD);
+  ret=testSyncWithoutChanges<NonTrivialGlobalIndex>() && ret;
+  MPI_Barrier(MPI_COMM_WORLD);
   std::cout<<rank<<": ENd="<<ret<<std::endl;
   if(!ret)
     MPI_Abort(MPI_COMM_WORLD, 1);
@@ -0,0 +1,80 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/parallel/threadedcommunication.hh>
+#include <dune/common/test/testsuite.hh>
+
+// Runs the tests in thread t of the team
+void testThread(Dune::ThreadedCommunication& comm, int t, int& shared, Dune::TestSuite& suite)
+{
+  const auto& cc = comm.communication();
+  const int threads = comm.threads();
+  const int id = cc.rank()*threads + t;
+  const int n = cc.size()*threads;
+
+  suite.check(comm.sum(t, id+1) == n*(n+1)/2, "sum") << "thread " << t;
+  suite.check(comm.max(t, id) == n-1, "max") << "thread " << t;
+  suite.check(comm.min(t, 1.0*id) == 0.0, "min") << "thread " << t;
+
+  const int root = comm.collective(t, [&](const auto& c){ c.broadcast(&shared, 1, 0); return c.size()-1; });
+  suite.check(root == cc.size()-1, "collective result") << "thread " << t;
+  comm.barrier(t);
+  suite.check(shared == 42, "collective") << "thread " << t;
+
+  // All threads use the same tag, the messages are told apart by the
+  // communicator of the thread.
+  if (comm.threadLevel() >= MPI_THREAD_SERIALIZED) {
+    const auto& own = comm.communication(t);
+    const int next = (cc.rank()+1) % cc.size();
+    const int previous = (cc.rank()+cc.size()-1) % cc.size();
+    Dune::MPIFuture<int> send;
+    {
+      auto lock = comm.lock();
+      send = own.isend(int(id), next, 0);
+    }
+    Dune::MPIFuture<int> receive;
+    {
+      auto lock = comm.lock();
+      receive = own.irecv(int(-1), previous, 0);
+    }
+    while (true) {
+      auto lock = comm.lock();
+      if (receive.ready() && send.ready())
+        break;
+    }
+    auto lock = comm.lock();
+    suite.check(receive.get() == previous*threads + t, "point-to-point") << "thread " << t;
+    send.wait();
+  }
+}
+
+int main(int argc, char** argv)
+{
+  auto& helper = Dune::MPIHelper::instance(argc, argv, MPI_THREAD_MULTIPLE);
+  if (helper.rank() == 0)
+    std::cout << "provided thread level " << helper.threadLevel() << std::endl;
+
+  Dune::TestSuite suite;
+  for (int threads : {1, 4}) {
+    Dune::ThreadedCommunication comm(helper.getCommunicator(), threads);
+    // data shared by the threads
+    int shared = helper.rank() == 0 ? 42 : 0;
+    std::vector<Dune::TestSuite> suites(threads);
+    std::vector<std::thread> team;
+    for (int t = 1; t < threads; ++t)
+      team.emplace_back(testThread, std::ref(comm), t, std::ref(shared), std::ref(suites[t]));
+    // thread 0 is the main thread, which may call MPI with MPI_THREAD_FUNNELED
+    testThread(comm, 0, shared, suites[0]);
+    for (auto& thread : team)
+      thread.join();
+    for (auto& s : suites)
+      suite.subTest(s);
+  }
+  return suite.exit();
+}
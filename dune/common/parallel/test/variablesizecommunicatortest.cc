@@ -10,6 +10,7 @@
 
 #if HAVE_MPI
 #include <mpi.h>
+#include <dune/common/exceptions.hh>
 #endif
 
 #include <dune/common/parallel/interface.hh>
@@ -298,6 +299,77 @@ struct VarDataHandle1D : public VarDataHandle
     }
 };
 
+// A handle whose sizes change without invalidating the size cache.  The
+// sizes of the indices below changeBelow grow by extra.  The index i is
+// received from the index source(i) of the other side.
+struct ChangingDataHandle
+{
+    ChangingDataHandle(int r, int c, bool mirrored)
+    : rank(r), changeBelow(c), mirrored_(mirrored)
+    {}
+    int rank;
+    int changeBelow;
+    std::size_t extra = 0;
+    std::size_t scattered = 0;
+    typedef double DataType;
+    bool fixedSize()
+    {
+        return false;
+    }
+    int source(int i)
+    {
+        return mirrored_ ? 10-i : i;
+    }
+    std::size_t size(int i)
+    {
+        return i%5 + (i<changeBelow ? extra : 0);
+    }
+    template<class B>
+    void gather(B& buffer, int i)
+    {
+        for(std::size_t j=0; j<size(i); j++)
+            buffer.write(static_cast<double>(i+j));
+    }
+    template<class B>
+    void scatter(B& buffer, int i, int size)
+    {
+        const int s = source(i);
+        if(std::size_t(size) != this->size(s)) {
+          std::cerr << rank <<": Received " << size << " entries for " << i
+                    << " instead of " << this->size(s) << "!" << std::endl;
+          std::abort();
+        }
+        for(int k=0; k<size; k++)
+        {
+            double index;
+            buffer.read(index);
+            if(index != s+k) {
+              std::cerr << rank << ": Communicated value does not match!" << std::endl;
+              std::abort();
+            }
+        }
+        // entries of size zero may be scattered or skipped
+        scattered += size != 0;
+    }
+    // Check that an entry was scattered for each received index with nonzero size
+    template<class Interface>
+    void verify(const Interface& inf)
+    {
+        std::size_t expected = 0;
+        for(const auto& neighbour : inf)
+            for(std::size_t j=0; j<neighbour.second.second.size(); ++j)
+                expected += size(source(neighbour.second.second[j])) != 0;
+        if(scattered != expected) {
+          std::cerr << rank << ": Scattered " << scattered << " entries instead of "
+                    << expected << "!" << std::endl;
+          std::abort();
+        }
+        scattered = 0;
+    }
+private:
+    bool mirrored_;
+};
+
 int main(int argc, char** argv)
 {
     MPI_Init(&argc, &argv);
@@ -333,6 +405,43 @@ int main(int argc, char** argv)
         std::cout<<"===================== backward ========================="<<std::endl;
         comm.backward(vhandle);
         vhandle.verify(procs, 0, 0);
+        std::cout<<"================== fused handles ======================="<<std::endl;
+        MyDataHandle1D fhandle(0);
+        VarDataHandle1D fvhandle(0);
+        comm.forward(fhandle, fvhandle);
+        fhandle.verify(procs, 0, 0);
+        fvhandle.verify(procs, 0, 0);
+        std::cout<<"=================== cached sizes ======================="<<std::endl;
+        Dune::VariableSizeCommunicator<>::SizeCache cache;
+        for(int i=0; i<2; ++i)
+        {
+            comm.forward(vhandle, cache);
+            vhandle.verify(procs, 0, 0);
+        }
+        // The changed sizes are renegotiated without invalidating the cache
+        ChangingDataHandle changing(0, 5, true);
+        Dune::VariableSizeCommunicator<>::SizeCache changingCache;
+        for(std::size_t extra : {0, 0, 2, 2, 0})
+        {
+            changing.extra = extra;
+            comm.forward(changing, changingCache);
+            changing.verify(inf);
+        }
+        std::cout<<"================ neighborhood collective ==============="<<std::endl;
+        Dune::VariableSizeCommunicator<> ncomm(MPI_COMM_SELF, inf, 6,
+                                               Dune::CommunicationBackend::neighborhoodCollective);
+        MyDataHandle1D nhandle(0);
+        ncomm.forward(nhandle);
+        nhandle.verify(procs, 0, 0);
+        VarDataHandle1D nvhandle(0);
+        ncomm.forward(nvhandle);
+        nvhandle.verify(procs, 0, 0);
+        ncomm.backward(nvhandle);
+        nvhandle.verify(procs, 0, 0);
+        Dune::FusedDataHandle<MyDataHandle1D,VarDataHandle1D> fused(fhandle, fvhandle);
+        ncomm.forward(fused);
+        fhandle.verify(procs, 0, 0);
+        fvhandle.verify(procs, 0, 0);
     }
     else
     {
@@ -429,6 +538,101 @@ int main(int argc, char** argv)
         comm.backward(vhandle);
         MPI_Barrier(MPI_COMM_WORLD);
         vhandle.verify(procs, start, end);
+        MPI_Barrier(MPI_COMM_WORLD);
+        if(rank==0)
+            std::cout<<"=================== split phase ========================"<<std::endl;
+        MPI_Barrier(MPI_COMM_WORLD);
+        MyDataHandle shandle(rank);
+        auto exchange = comm.forwardBegin(shandle);
+        while(!exchange.ready())
+            ;
+        comm.forwardEnd(exchange);
+        shandle.verify(procs, start, end);
+        MPI_Barrier(MPI_COMM_WORLD);
+        VarDataHandle svhandle(rank);
+        Dune::Future<void> future = comm.forwardBegin(svhandle);
+        future.get();
+        svhandle.verify(procs, start, end);
+        MPI_Barrier(MPI_COMM_WORLD);
+        if(rank==0)
+            std::cout<<"=================== cached sizes ======================="<<std::endl;
+        MPI_Barrier(MPI_COMM_WORLD);
+        VarDataHandle chandle(rank);
+        Dune::VariableSizeCommunicator<>::SizeCache cache;
+        for(int i=0; i<3; ++i)
+        {
+            comm.forward(chandle, cache);
+            chandle.verify(procs, start, end);
+            comm.backward(chandle, cache);
+            chandle.verify(procs, start, end);
+        }
+        cache.invalidate();
+        comm.forward(chandle, cache);
+        chandle.verify(procs, start, end);
+        auto cexchange = comm.forwardBegin(chandle, cache);
+        comm.forwardEnd(cexchange);
+        chandle.verify(procs, start, end);
+        // The sizes change for the neighbours below the middle only and are
+        // renegotiated without invalidating the cache
+        ChangingDataHandle changing(rank, N/2, false);
+        Dune::VariableSizeCommunicator<>::SizeCache changingCache;
+        for(std::size_t extra : {0, 0, 2, 2, 0})
+        {
+            changing.extra = extra;
+            comm.forward(changing, changingCache);
+            changing.verify(inf);
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+        if(rank==0)
+            std::cout<<"================== fused handles ======================="<<std::endl;
+        MPI_Barrier(MPI_COMM_WORLD);
+        MyDataHandle fhandle(rank);
+        VarDataHandle fvhandle(rank);
+        comm.forward(fhandle, fvhandle);
+        fhandle.verify(procs, start, end);
+        fvhandle.verify(procs, start, end);
+        comm.backward(fhandle, fvhandle);
+        fhandle.verify(procs, start, end);
+        fvhandle.verify(procs, start, end);
+        Dune::FusedDataHandle<MyDataHandle,VarDataHandle> fused(fhandle, fvhandle);
+        auto fexchange = comm.forwardBegin(fused);
+        comm.forwardEnd(fexchange);
+        fhandle.verify(procs, start, end);
+        fvhandle.verify(procs, start, end);
+        MPI_Barrier(MPI_COMM_WORLD);
+        if(rank==0)
+            std::cout<<"================ neighborhood collective ==============="<<std::endl;
+        MPI_Barrier(MPI_COMM_WORLD);
+        Dune::VariableSizeCommunicator<> ncomm(MPI_COMM_WORLD, inf, 6,
+                                               Dune::CommunicationBackend::neighborhoodCollective);
+        MyDataHandle nhandle(rank);
+        ncomm.forward(nhandle);
+        nhandle.verify(procs, start, end);
+        ncomm.backward(nhandle);
+        nhandle.verify(procs, start, end);
+        VarDataHandle nvhandle(rank);
+        auto nexchange = ncomm.forwardBegin(nvhandle);
+        ncomm.forwardEnd(nexchange);
+        nvhandle.verify(procs, start, end);
+        ncomm.backward(nvhandle);
+        nvhandle.verify(procs, start, end);
+        ncomm.forward(fhandle, fvhandle);
+        fhandle.verify(procs, start, end);
+        fvhandle.verify(procs, start, end);
+        Dune::VariableSizeCommunicator<>::SizeCache ncache;
+        for(int i=0; i<2; ++i)
+        {
+            ncomm.forward(chandle, ncache);
+            chandle.verify(procs, start, end);
+        }
+        ChangingDataHandle nchanging(rank, N/2, false);
+        Dune::VariableSizeCommunicator<>::SizeCache nchangingCache;
+        for(std::size_t extra : {0, 0, 2, 2, 0})
+        {
+            nchanging.extra = extra;
+            ncomm.forward(nchanging, nchangingCache);
+            nchanging.verify(inf);
+        }
     }
 
     MPI_Finalize();
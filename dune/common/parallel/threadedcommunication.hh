@@ -0,0 +1,287 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_PARALLEL_THREADEDCOMMUNICATION_HH
+#define DUNE_COMMON_PARALLEL_THREADEDCOMMUNICATION_HH
+
+/*!
+   \file
+   \brief Communication of a team of threads on each process.
+
+   \ingroup ParallelCommunication
+ */
+
+#if HAVE_MPI
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <mpi.h>
+
+#include <dune/common/binaryfunctions.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpicommunication.hh>
+
+namespace Dune
+{
+  /*! \brief Communication for hybrid programs running a team of threads
+      on each process.
+
+      The threads of the team are numbered 0, ..., threads()-1.
+
+      For point-to-point communication each thread gets its own
+      communication, see communication(). It uses a duplicate of the
+      communicator, so that messages of different threads never match each
+      other, whatever their tags. Different threads may use their
+      communications concurrently if the MPI library provides
+      `MPI_THREAD_MULTIPLE`, see concurrent(). With `MPI_THREAD_SERIALIZED`
+      the calls have to be guarded by lock().
+
+      Collective operations are called by all threads of the team. The
+      contributions of the threads are combined and thread 0 alone calls
+      MPI, which is therefore safe with `MPI_THREAD_FUNNELED` if thread 0
+      is the thread that initialized MPI:
+      \code
+      ThreadedCommunication comm(MPI_COMM_WORLD, threads);
+      // in thread t
+      double norm2 = comm.sum(t, localNorm2);
+      \endcode
+
+      Request the thread support with
+      MPIHelper::instance(argc, argv, requiredThreadLevel).
+   */
+  class ThreadedCommunication
+  {
+  public:
+    /*! \brief Creates the communication for a team of threads.
+
+        This constructor is collective on the communicator and has to be
+        called by a single thread.
+
+        \param comm The communicator of the processes.
+        \param threads The number of threads on each process.
+     */
+    ThreadedCommunication(MPI_Comm comm, int threads)
+      : comm_(comm), threads_(threads), slots_(threads, nullptr)
+    {
+      MPI_Query_thread(&threadLevel_);
+      communicators_.resize(threads_);
+      communications_.reserve(threads_);
+      for (int t = 0; t < threads_; ++t) {
+        MPI_Comm_dup(comm, &communicators_[t]);
+        communications_.emplace_back(communicators_[t]);
+      }
+    }
+
+    ThreadedCommunication(const ThreadedCommunication&) = delete;
+    ThreadedCommunication& operator=(const ThreadedCommunication&) = delete;
+
+    //! Has to be called collectively before MPI is finalized.
+    ~ThreadedCommunication()
+    {
+      int finalized = 0;
+      MPI_Finalized(&finalized);
+      if (finalized)
+        return;
+      for (MPI_Comm& comm : communicators_)
+        MPI_Comm_free(&comm);
+    }
+
+    //! The number of threads on each process.
+    int threads () const
+    {
+      return threads_;
+    }
+
+    //! The level of thread support provided by MPI.
+    int threadLevel () const
+    {
+      return threadLevel_;
+    }
+
+    //! Whether the threads may communicate concurrently.
+    bool concurrent () const
+    {
+      return threadLevel_ >= MPI_THREAD_MULTIPLE;
+    }
+
+    //! The communication of all threads, to be used by thread 0 only.
+    const Communication<MPI_Comm>& communication () const
+    {
+      return comm_;
+    }
+
+    /*! \brief The communication of a thread.
+
+        Messages sent with it are received by the communication of the
+        same thread on the other process.
+     */
+    const Communication<MPI_Comm>& communication (int thread) const
+    {
+      return communications_[thread];
+    }
+
+    /*! \brief A lock serializing the communication of the threads.
+
+        The lock is only acquired if the threads may not communicate
+        concurrently.
+     */
+    std::unique_lock<std::mutex> lock ()
+    {
+      if (concurrent())
+        return std::unique_lock<std::mutex>(serialize_, std::defer_lock);
+      return std::unique_lock<std::mutex>(serialize_);
+    }
+
+    /*! \brief Computes an operation over the values of all threads of all
+        processes.
+
+        The values of the threads of a process are combined in the order
+        of the threads, hence the result does not depend on their timing.
+
+        \tparam BinaryFunction The operation, e.g. std::plus<T>.
+     */
+    template<typename BinaryFunction, typename T>
+    T allreduce (int thread, const T& in)
+    {
+      slots_[thread] = &in;
+      arrive();
+      std::optional<T> out;
+      if (thread == 0) {
+        BinaryFunction op;
+        out = in;
+        for (int t = 1; t < threads_; ++t)
+          out = op(*out, *static_cast<const T*>(slots_[t]));
+        if (mayCallMPI())
+          out = comm_.template allreduce<BinaryFunction>(std::move(*out));
+        slots_[0] = &*out;
+      }
+      arrive();
+      if (thread != 0)
+        out = *static_cast<const T*>(slots_[0]);
+      // thread 0 keeps the result alive until all threads have copied it
+      arrive();
+      checkFunneled();
+      return std::move(*out);
+    }
+
+    //! Computes the sum over the values of all threads of all processes.
+    template<typename T>
+    T sum (int thread, const T& in)
+    {
+      return allreduce<std::plus<T> >(thread, in);
+    }
+
+    //! Computes the minimum over the values of all threads of all processes.
+    template<typename T>
+    T min (int thread, const T& in)
+    {
+      return allreduce<Min<T> >(thread, in);
+    }
+
+    //! Computes the maximum over the values of all threads of all processes.
+    template<typename T>
+    T max (int thread, const T& in)
+    {
+      return allreduce<Max<T> >(thread, in);
+    }
+
+    /*! \brief Calls a collective operation of the processes on behalf of
+        the threads.
+
+        All threads call this method. Thread 0 calls `f(communication())`,
+        e.g. a broadcast into data shared by the threads, and the other
+        threads wait for it. Its result is returned to all threads. f must
+        not throw, as the other threads would wait forever.
+     */
+    template<typename F>
+    auto collective (int thread, F&& f)
+    {
+      using Result = std::decay_t<std::invoke_result_t<F&, const Communication<MPI_Comm>&> >;
+      arrive();
+      if constexpr (std::is_void_v<Result>) {
+        if (thread == 0 && mayCallMPI())
+          f(comm_);
+        arrive();
+        checkFunneled();
+      }
+      else {
+        std::optional<Result> out;
+        if (thread == 0) {
+          if (mayCallMPI())
+            out.emplace(f(comm_));
+          slots_[0] = out ? &*out : nullptr;
+        }
+        arrive();
+        if (thread != 0 && slots_[0])
+          out.emplace(*static_cast<const Result*>(slots_[0]));
+        arrive();
+        checkFunneled();
+        return std::move(*out);
+      }
+    }
+
+    //! Waits until all threads of all processes have arrived.
+    void barrier (int thread)
+    {
+      collective(thread, [](const Communication<MPI_Comm>& comm){ comm.barrier(); });
+    }
+
+  private:
+    // Waits until all threads of the team have arrived.
+    void arrive ()
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      const std::size_t generation = generation_;
+      if (++arrived_ == threads_) {
+        arrived_ = 0;
+        ++generation_;
+        arrivedAll_.notify_all();
+      }
+      else
+        arrivedAll_.wait(lock, [&]{ return generation != generation_; });
+    }
+
+    // Whether the calling thread, i.e. thread 0, may call MPI. Records an
+    // error that is raised in all threads by checkFunneled().
+    bool mayCallMPI ()
+    {
+      int isMain = 1;
+      if (threadLevel_ < MPI_THREAD_SERIALIZED)
+        MPI_Is_thread_main(&isMain);
+      notMain_ = !isMain;
+      return isMain;
+    }
+
+    void checkFunneled () const
+    {
+      if (notMain_)
+        DUNE_THROW(InvalidStateException, "With MPI_THREAD_FUNNELED thread 0 has to be the thread that initialized MPI");
+    }
+
+    Communication<MPI_Comm> comm_;
+    int threads_;
+    int threadLevel_;
+    std::vector<MPI_Comm> communicators_;
+    std::vector<Communication<MPI_Comm> > communications_;
+    //! The values of the threads in a collective operation.
+    std::vector<const void*> slots_;
+    bool notMain_ = false;
+    std::mutex mutex_;
+    std::condition_variable arrivedAll_;
+    int arrived_ = 0;
+    std::size_t generation_ = 0;
+    std::mutex serialize_;
+  };
+
+} // end namespace Dune
+
+#endif // HAVE_MPI
+#endif // DUNE_COMMON_PARALLEL_THREADEDCOMMUNICATION_HH
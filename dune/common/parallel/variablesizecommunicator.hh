@@ -13,12 +13,18 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include <mpi.h>
 
 #include <dune/common/concept.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/communicationstatistics.hh>
+#include <dune/common/parallel/future.hh>
 #include <dune/common/parallel/interface.hh>
 #include <dune/common/parallel/mpitraits.hh>
 
@@ -289,6 +295,174 @@ private:
 
 } // end unnamed namespace
 
+namespace Impl {
+
+/**
+ * @brief A message buffer for items of type T writing to a buffer of bytes.
+ *
+ * Used by FusedDataHandle to pack the data of handles with different
+ * data types into one message.
+ */
+template<class T, class Buffer>
+class FusedMessageBuffer
+{
+  static_assert(std::is_trivially_copyable<T>::value,
+                "The data types of fused data handles have to be trivially copyable");
+public:
+  explicit FusedMessageBuffer(Buffer& buffer)
+    : buffer_(buffer)
+  {}
+
+  void write(const T& data)
+  {
+    const char* bytes = reinterpret_cast<const char*>(&data);
+    for(std::size_t i=0; i<sizeof(T); ++i)
+      buffer_.write(bytes[i]);
+  }
+
+  void read(T& data)
+  {
+    char* bytes = reinterpret_cast<char*>(&data);
+    for(std::size_t i=0; i<sizeof(T); ++i)
+      buffer_.read(bytes[i]);
+  }
+
+private:
+  Buffer& buffer_;
+};
+
+} // namespace Impl
+
+/**
+ * @addtogroup Common_Parallel
+ *
+ * @{
+ */
+/**
+ * @brief A data handle communicating the data of several data handles at once.
+ *
+ * The data of all handles at an index is packed into the same message, so
+ * several fields are exchanged with one message per neighbour and one size
+ * negotiation. Each handle is still called for gathering and scattering its
+ * own data. The entries are communicated as bytes, therefore the data types
+ * of the handles have to be trivially copyable. For each handle with a
+ * variable size the number of its items is sent along with its data. Handles
+ * with a fixed size have to have the same size on all processes.
+ *
+ * @tparam DataHandles The types of the fused handles, see VariableSizeCommunicator::forward().
+ */
+template<class... DataHandles>
+class FusedDataHandle
+{
+  static_assert(sizeof...(DataHandles)>0, "At least one data handle is needed");
+public:
+  typedef char DataType;
+
+  /**
+   * @brief The number of bytes per item of the maximum buffer size of the communicator.
+   *
+   * Thus the message buffers can hold as many entries as for each handle
+   * alone.
+   */
+  static constexpr std::size_t itemSize = (sizeof(typename DataHandles::DataType) + ...) + sizeof(std::size_t);
+
+  /**
+   * @brief Constructor.
+   * @param handles The handles to fuse. They have to stay alive until the communication is complete.
+   */
+  explicit FusedDataHandle(DataHandles&... handles)
+    : handles_(handles...)
+  {}
+
+  /** @brief Whether all handles have a fixed size. */
+  bool fixedSize()
+  {
+    return std::apply([](auto&... handles) {
+        return (Impl::callFixedSize(handles) && ...);
+      }, handles_);
+  }
+
+  /** @brief Get the number of bytes communicated for index i. */
+  std::size_t size(std::size_t i)
+  {
+    return std::apply([i](auto&... handles) {
+        return (entrySize(handles, i) + ...);
+      }, handles_);
+  }
+
+  /** @brief Gather the data of all handles at index i. */
+  template<class B>
+  void gather(B& buffer, std::size_t i)
+  {
+    std::apply([&buffer,i](auto&... handles) {
+        (gatherEntry(handles, buffer, i), ...);
+      }, handles_);
+  }
+
+  /** @brief Scatter the data of all handles to index i. */
+  template<class B>
+  void scatter(B& buffer, std::size_t i, [[maybe_unused]] std::size_t n)
+  {
+    std::apply([&buffer,i](auto&... handles) {
+        (scatterEntry(handles, buffer, i), ...);
+      }, handles_);
+  }
+
+private:
+  template<class DataHandle>
+  static std::size_t entrySize(DataHandle& handle, std::size_t i)
+  {
+    return (Impl::callFixedSize(handle) ? 0 : sizeof(std::size_t))
+      + handle.size(i)*sizeof(typename DataHandle::DataType);
+  }
+
+  template<class DataHandle, class B>
+  static void gatherEntry(DataHandle& handle, B& buffer, std::size_t i)
+  {
+    if(!Impl::callFixedSize(handle))
+      Impl::FusedMessageBuffer<std::size_t,B>(buffer).write(handle.size(i));
+    Impl::FusedMessageBuffer<typename DataHandle::DataType,B> items(buffer);
+    handle.gather(items, i);
+  }
+
+  // Like the communicator, entries of variable size without items are not scattered.
+  template<class DataHandle, class B>
+  static void scatterEntry(DataHandle& handle, B& buffer, std::size_t i)
+  {
+    std::size_t size;
+    if(Impl::callFixedSize(handle))
+      size = handle.size(i);
+    else {
+      Impl::FusedMessageBuffer<std::size_t,B>(buffer).read(size);
+      if(size == 0)
+        return;
+    }
+    Impl::FusedMessageBuffer<typename DataHandle::DataType,B> items(buffer);
+    handle.scatter(items, i, size);
+  }
+
+  std::tuple<DataHandles&...> handles_;
+};
+
+/** @} */
+
+namespace Impl {
+
+/**
+ * @brief The number of buffer items per item of the maximum buffer size.
+ */
+template<class DataHandle>
+struct MessageBufferScale
+  : std::integral_constant<std::size_t,1>
+{};
+
+template<class... DataHandles>
+struct MessageBufferScale<FusedDataHandle<DataHandles...> >
+  : std::integral_constant<std::size_t,FusedDataHandle<DataHandles...>::itemSize>
+{};
+
+} // namespace Impl
+
 /**
  * @addtogroup Common_Parallel
  *
@@ -325,6 +499,26 @@ private:
  * communicate a vector in-place, e.g. to sum up partial results from
  * different ranks.  Instead, have separate source and target vectors and copy
  * the source vector to the target vector before communicating.
+ *
+ * To overlap the communication with computations, it can be split into two
+ * phases by forwardBegin() and forwardEnd() (or backwardBegin() and
+ * backwardEnd() respectively).
+ *
+ * The data of several handles can be communicated at once by passing them
+ * all to forward() or backward(), or by communicating a FusedDataHandle.
+ * Then only one message per neighbour and direction is needed.
+ *
+ * For data handles with variable size the sizes of the entries are
+ * communicated before the data. If they rarely change between
+ * communications, they can be kept in a SizeCache that is passed along
+ * with the handle.
+ *
+ * With CommunicationBackend::neighborhoodCollective a distributed graph
+ * topology is created from the interface at construction. Then the sizes
+ * and the data are each exchanged by one call to MPI_Ineighbor_alltoallw
+ * with one message per neighbour, i.e. the maximum buffer size is ignored.
+ * The interface has to be symmetric and all processes have to communicate,
+ * even those with an empty interface.
  */
 template<class Allocator=std::allocator<std::pair<InterfaceInformation,InterfaceInformation> > >
 class VariableSizeCommunicator
@@ -344,20 +538,26 @@ public:
    *
    * The default size is either what the macro DUNE_MAX_COMMUNICATION_BUFFER_SIZE
    * is set to, or 32768 if it is not set.
+   * @param comm The MPI communicator to use.
+   * @param inf The communication interface.
+   * @param backend The MPI calls used for the communication.
    */
-  VariableSizeCommunicator(MPI_Comm comm, const InterfaceMap& inf)
-    : maxBufferSize_(32768), interface_(&inf)
+  VariableSizeCommunicator(MPI_Comm comm, const InterfaceMap& inf,
+                           CommunicationBackend backend = CommunicationBackend::pointToPoint)
+    : maxBufferSize_(32768), interface_(&inf), backend_(backend)
   {
-    MPI_Comm_dup(comm, &communicator_);
+    createCommunicator(comm);
   }
   /**
    * @brief Creates a communicator with the default maximum buffer size.
    * @param inf The communication interface.
+   * @param backend The MPI calls used for the communication.
    */
-  VariableSizeCommunicator(const Interface& inf)
-  : maxBufferSize_(32768), interface_(&inf.interfaces())
+  VariableSizeCommunicator(const Interface& inf,
+                           CommunicationBackend backend = CommunicationBackend::pointToPoint)
+  : maxBufferSize_(32768), interface_(&inf.interfaces()), backend_(backend)
   {
-    MPI_Comm_dup(inf.communicator(), &communicator_);
+    createCommunicator(inf.communicator());
   }
 #else
   /**
@@ -366,21 +566,24 @@ public:
    * The default size is either what the macro DUNE_MAX_COMMUNICATION_BUFFER_SIZE
    * is set to, or 32768 if it is not set.
    */
-  VariableSizeCommunicator(MPI_Comm comm, InterfaceMap& inf)
+  VariableSizeCommunicator(MPI_Comm comm, InterfaceMap& inf,
+                           CommunicationBackend backend = CommunicationBackend::pointToPoint)
     : maxBufferSize_(DUNE_PARALLEL_MAX_COMMUNICATION_BUFFER_SIZE),
-      interface_(&inf)
+      interface_(&inf), backend_(backend)
   {
-    MPI_Comm_dup(comm, &communicator_);
+    createCommunicator(comm);
   }
   /**
    * @brief Creates a communicator with the default maximum buffer size.
    * @param inf The communication interface.
+   * @param backend The MPI calls used for the communication.
    */
-  VariableSizeCommunicator(const Interface& inf)
+  VariableSizeCommunicator(const Interface& inf,
+                           CommunicationBackend backend = CommunicationBackend::pointToPoint)
   : maxBufferSize_(DUNE_PARALLEL_MAX_COMMUNICATION_BUFFER_SIZE),
-    interface_(&inf.interfaces())
+    interface_(&inf.interfaces()), backend_(backend)
   {
-    MPI_Comm_dup(inf.communicator(), &communicator_);
+    createCommunicator(inf.communicator());
   }
 #endif
   /**
@@ -388,22 +591,26 @@ public:
   * @param comm The MPI communicator to use.
   * @param inf The communication interface.
   * @param max_buffer_size The maximum buffer size allowed.
+  * @param backend The MPI calls used for the communication.
   */
-  VariableSizeCommunicator(MPI_Comm comm, const InterfaceMap& inf, std::size_t max_buffer_size)
-    : maxBufferSize_(max_buffer_size), interface_(&inf)
+  VariableSizeCommunicator(MPI_Comm comm, const InterfaceMap& inf, std::size_t max_buffer_size,
+                           CommunicationBackend backend = CommunicationBackend::pointToPoint)
+    : maxBufferSize_(max_buffer_size), interface_(&inf), backend_(backend)
   {
-    MPI_Comm_dup(comm, &communicator_);
+    createCommunicator(comm);
   }
 
   /**
   * @brief Creates a communicator with a specific maximum buffer size.
   * @param inf The communication interface.
   * @param max_buffer_size The maximum buffer size allowed.
+  * @param backend The MPI calls used for the communication.
   */
-  VariableSizeCommunicator(const Interface& inf, std::size_t max_buffer_size)
-    : maxBufferSize_(max_buffer_size), interface_(&inf.interfaces())
+  VariableSizeCommunicator(const Interface& inf, std::size_t max_buffer_size,
+                           CommunicationBackend backend = CommunicationBackend::pointToPoint)
+    : maxBufferSize_(max_buffer_size), interface_(&inf.interfaces()), backend_(backend)
   {
-    MPI_Comm_dup(inf.communicator(), &communicator_);
+    createCommunicator(inf.communicator());
   }
 
   ~VariableSizeCommunicator()
@@ -418,6 +625,7 @@ public:
   VariableSizeCommunicator(const VariableSizeCommunicator& other) {
     maxBufferSize_ = other.maxBufferSize_;
     interface_ = other.interface_;
+    backend_ = other.backend_;
     MPI_Comm_dup(other.communicator_, &communicator_);
   }
 
@@ -431,6 +639,7 @@ public:
 
     maxBufferSize_ = other.maxBufferSize_;
     interface_ = other.interface_;
+    backend_ = other.backend_;
     MPI_Comm_free(&communicator_);
     MPI_Comm_dup(other.communicator_, &communicator_);
 
@@ -462,6 +671,20 @@ public:
     communicate<true>(handle);
   }
 
+  /**
+   * @brief Communicate the data of several handles forward at once.
+   *
+   * The data of all handles is sent in one message per neighbour using a
+   * FusedDataHandle.
+   * @see forward() for the interface of the handles.
+   */
+  template<class DataHandle1, class DataHandle2, class... DataHandles>
+  void forward(DataHandle1& handle1, DataHandle2& handle2, DataHandles&... handles)
+  {
+    FusedDataHandle<DataHandle1,DataHandle2,DataHandles...> fused(handle1, handle2, handles...);
+    communicate<true>(fused);
+  }
+
   /**
    * @brief Communicate backwards.
    *
@@ -487,19 +710,287 @@ public:
     communicate<false>(handle);
   }
 
+  /**
+   * @brief Communicate the data of several handles backwards at once.
+   *
+   * The data of all handles is sent in one message per neighbour using a
+   * FusedDataHandle.
+   * @see forward() for the interface of the handles.
+   */
+  template<class DataHandle1, class DataHandle2, class... DataHandles>
+  void backward(DataHandle1& handle1, DataHandle2& handle2, DataHandles&... handles)
+  {
+    FusedDataHandle<DataHandle1,DataHandle2,DataHandles...> fused(handle1, handle2, handles...);
+    communicate<false>(fused);
+  }
+
+  /**
+   * @brief The sizes of the entries of a data handle with variable size kept
+   * between communications.
+   *
+   * A communication with a SizeCache stores the sizes it negotiated. In the
+   * following communications with the same cache, each process only sends
+   * a checksum of its sizes to each neighbour instead of the sizes. The
+   * sizes are communicated again between the neighbours whose checksum
+   * changed, the cached ones are reused for all others. With the
+   * neighbourhood collective the processes agree on whether any checksum
+   * changed and then communicate all sizes again. The cache belongs to the
+   * communicator it is used with and has no effect for handles with fixed
+   * size.
+   *
+   * invalidate() forces the next communication to exchange all sizes. As
+   * this needs other messages than a communication with valid cache, it has
+   * to be called on all processes.
+   */
+  class SizeCache
+  {
+  public:
+    /** @brief Communicate the sizes again in the next communication. */
+    void invalidate()
+    {
+      valid_[0] = valid_[1] = false;
+    }
+
+  private:
+    friend class VariableSizeCommunicator;
+
+    /** @brief Whether the cached sizes are valid, index 0 is for backward
+     * and index 1 for forward communication. */
+    bool valid_[2] = {false, false};
+    /** @brief The checksums of the sizes sent to each neighbour. */
+    std::vector<std::size_t> sendChecksums_[2];
+    /** @brief The checksums of the sizes received from each neighbour. */
+    std::vector<std::size_t> recvChecksums_[2];
+    /** @brief The sizes of the entries received from each neighbour. */
+    std::vector<std::vector<std::size_t> > sizes_[2];
+  };
+
+  /**
+   * @brief Communicate forward, reusing the sizes kept in a cache.
+   *
+   * @see forward() for the interface of the handle.
+   * @param handle A handle responsible for describing the data, gathering, and scattering it.
+   * @param sizeCache The sizes of the entries of previous communications with this cache.
+   */
+  template<class DataHandle>
+  void forward(DataHandle& handle, SizeCache& sizeCache)
+  {
+    communicate<true>(handle, &sizeCache);
+  }
+
+  /**
+   * @brief Communicate backwards, reusing the sizes kept in a cache.
+   *
+   * @see forward() for the interface of the handle.
+   * @param handle A handle responsible for describing the data, gathering, and scattering it.
+   * @param sizeCache The sizes of the entries of previous communications with this cache.
+   */
+  template<class DataHandle>
+  void backward(DataHandle& handle, SizeCache& sizeCache)
+  {
+    communicate<false>(handle, &sizeCache);
+  }
+
 private:
   template<bool FORWARD, class DataHandle>
-  void communicateSizes(DataHandle& handle,
-                        std::vector<InterfaceTracker>& recv_trackers);
+  struct ExchangeState;
+
+public:
+  /**
+   * @brief Handle of a communication started by forwardBegin() or backwardBegin().
+   *
+   * Models the interface of Dune::Future<void>, i.e. it can be wrapped
+   * into a Dune::Future. The communication only progresses while
+   * ready() is called or when waiting for its completion. Received
+   * messages are scattered into the data as soon as they arrive. If the
+   * handle is destroyed before, the communication is completed by the
+   * destructor.
+   *
+   * @tparam FORWARD True for a forward communication.
+   * @tparam DataHandle The type of the handle describing the data.
+   */
+  template<bool FORWARD, class DataHandle>
+  class Exchange
+  {
+    friend class VariableSizeCommunicator;
+    typedef ExchangeState<FORWARD,DataHandle> State;
+
+    Exchange(VariableSizeCommunicator& communicator, std::unique_ptr<State> state)
+      : communicator_(&communicator), state_(std::move(state)), valid_(true)
+    {}
+
+  public:
+    /** @brief Constructs an invalid handle. */
+    Exchange()
+      : communicator_(nullptr), valid_(false)
+    {}
+
+    Exchange(Exchange&& other)
+      : communicator_(other.communicator_), state_(std::move(other.state_)),
+        valid_(std::exchange(other.valid_, false))
+    {}
+
+    Exchange& operator=(Exchange&& other)
+    {
+      complete();
+      communicator_ = other.communicator_;
+      state_ = std::move(other.state_);
+      valid_ = std::exchange(other.valid_, false);
+      return *this;
+    }
+
+    /** @brief Completes a pending communication. */
+    ~Exchange()
+    {
+      complete();
+    }
+
+    /** @brief Wait for the completion of the communication. */
+    void wait()
+    {
+      if(!valid_)
+        DUNE_THROW(InvalidFutureException, "The exchange is not valid");
+      complete();
+    }
+
+    /**
+     * @brief Advance the communication without blocking.
+     * @return True if the communication is complete.
+     */
+    bool ready() const
+    {
+      if(!valid_)
+        DUNE_THROW(InvalidFutureException, "The exchange is not valid");
+      if(state_ && communicator_->progressExchange(*state_))
+        complete();
+      return !state_;
+    }
+
+    /** @brief Whether the handle belongs to a communication. */
+    bool valid() const
+    {
+      return valid_;
+    }
+
+    /** @brief Wait for the completion and invalidate the handle. */
+    void get()
+    {
+      wait();
+      valid_ = false;
+    }
+
+  private:
+    void complete() const
+    {
+      if(state_) {
+        communicator_->finishExchange(*state_);
+        state_.reset();
+      }
+    }
+
+    VariableSizeCommunicator* communicator_;
+    mutable std::unique_ptr<State> state_;
+    bool valid_;
+  };
+
+  /**
+   * @brief Start communicating forward.
+   *
+   * The communication is completed by forwardEnd() or the returned
+   * handle. In between computations can overlap the communication but
+   * the data described by the handle must not be accessed. Only one
+   * communication of a communicator can be in progress at a time.
+   *
+   * @see forward() for the interface of the DataHandle.
+   * @param handle A handle responsible for describing the data, gathering, and scattering it.
+   * The handle has to stay alive until the communication is complete.
+   * @return The handle to complete the communication with.
+   */
+  template<class DataHandle>
+  Exchange<true,DataHandle> forwardBegin(DataHandle& handle)
+  {
+    return begin<true>(handle);
+  }
+
+  /**
+   * @brief Start communicating forward, reusing the sizes kept in a cache.
+   *
+   * @see forwardBegin()
+   * @param handle A handle responsible for describing the data, gathering, and scattering it.
+   * @param sizeCache The sizes of previous communications, has to stay alive
+   * until the communication is complete.
+   * @return The handle to complete the communication with.
+   */
+  template<class DataHandle>
+  Exchange<true,DataHandle> forwardBegin(DataHandle& handle, SizeCache& sizeCache)
+  {
+    return begin<true>(handle, &sizeCache);
+  }
+
+  /**
+   * @brief Complete a communication started by forwardBegin().
+   * @param exchange The handle returned by forwardBegin().
+   */
+  template<class DataHandle>
+  void forwardEnd(Exchange<true,DataHandle>& exchange)
+  {
+    exchange.get();
+  }
+
+  /**
+   * @brief Start communicating backwards.
+   *
+   * @see forwardBegin()
+   * @param handle A handle responsible for describing the data, gathering, and scattering it.
+   * @return The handle to complete the communication with.
+   */
+  template<class DataHandle>
+  Exchange<false,DataHandle> backwardBegin(DataHandle& handle)
+  {
+    return begin<false>(handle);
+  }
+
+  /**
+   * @brief Start communicating backwards, reusing the sizes kept in a cache.
+   *
+   * @see forwardBegin()
+   * @param handle A handle responsible for describing the data, gathering, and scattering it.
+   * @param sizeCache The sizes of previous communications, has to stay alive
+   * until the communication is complete.
+   * @return The handle to complete the communication with.
+   */
+  template<class DataHandle>
+  Exchange<false,DataHandle> backwardBegin(DataHandle& handle, SizeCache& sizeCache)
+  {
+    return begin<false>(handle, &sizeCache);
+  }
+
+  /**
+   * @brief Complete a communication started by backwardBegin().
+   * @param exchange The handle returned by backwardBegin().
+   */
+  template<class DataHandle>
+  void backwardEnd(Exchange<false,DataHandle>& exchange)
+  {
+    exchange.get();
+  }
+
+private:
 
   /**
    * @brief Communicates data according to the interface.
    * @tparam forward If true sends data forwards, otherwise backwards along the interface.
    * @tparame DataHandle The type of the data handle @see forward for a description of the interface.
    * @param handle The handle describing the data and responsible for gather and scatter operations.
+   * @param sizeCache The cache of the sizes or nullptr.
    */
   template<bool forward,class DataHandle>
-  void communicate(DataHandle& handle);
+  void communicate(DataHandle& handle, SizeCache* sizeCache=nullptr);
+  /**
+   * @brief Starts a communication and returns the handle to complete it.
+   */
+  template<bool FORWARD, class DataHandle>
+  Exchange<FORWARD,DataHandle> begin(DataHandle& handle, SizeCache* sizeCache=nullptr);
   /**
    * @brief Initialize the trackers along the interface for the communication.
    * @tparam FORWARD If true we send in the forward direction.
@@ -514,23 +1005,113 @@ private:
                               std::vector<InterfaceTracker>& send_trackers,
                               std::vector<InterfaceTracker>& recv_trackers);
   /**
-   * @brief Communicate data with a fixed amount of data per entry.
-   * @tparam FORWARD If true we send in the forward direction.
-   * @tparam DataHandle DataHandle The type of the data handle.
-   * @param handle The handle describing the data and responsible for gather
-   * and scatter operations.
+   * @brief Set up the trackers and post the first requests of a communication.
+   * @param state The state of the communication.
    */
   template<bool FORWARD, class DataHandle>
-  void communicateFixedSize(DataHandle& handle);
-   /**
-   * @brief Communicate data with a variable amount of data per entry.
-   * @tparam FORWARD If true we send in the forward direction.
-   * @tparam DataHandle DataHandle The type of the data handle.
-   * @param handle The handle describing the data and responsible for gather
-   * and scatter operations.
+  void startExchange(ExchangeState<FORWARD,DataHandle>& state);
+  /**
+   * @brief Set up the requests for sending and receiving the data once the sizes are known.
+   * @param state The state of the communication.
    */
   template<bool FORWARD, class DataHandle>
-  void communicateVariableSize(DataHandle& handle);
+  void setupDataRequests(ExchangeState<FORWARD,DataHandle>& state);
+  /**
+   * @brief Start communicating the sizes of the entries.
+   *
+   * If the sizes are cached, only those of the neighbours marked for
+   * renegotiation are communicated.
+   * @param state The state of the communication.
+   */
+  template<bool FORWARD, class DataHandle>
+  void startSizeExchange(ExchangeState<FORWARD,DataHandle>& state);
+  /**
+   * @brief Start exchanging the checksums of the sizes with the neighbours.
+   * @param state The state of the communication.
+   */
+  template<bool FORWARD, class DataHandle>
+  void startChecksumExchange(ExchangeState<FORWARD,DataHandle>& state);
+  /**
+   * @brief Mark the neighbours whose sizes changed for renegotiation and
+   * set the cached sizes of all others at the receiving side.
+   * @param state The state of the communication.
+   * @return True if the sizes changed for any neighbour.
+   */
+  template<bool FORWARD, class DataHandle>
+  bool compareChecksums(ExchangeState<FORWARD,DataHandle>& state);
+  /**
+   * @brief Set the cached sizes of the entries received from a neighbour.
+   * @param state The state of the communication.
+   * @param i The position of the neighbour in the interface.
+   */
+  template<bool FORWARD, class DataHandle>
+  void useCachedSizes(ExchangeState<FORWARD,DataHandle>& state, std::size_t i);
+  /**
+   * @brief Store the communicated sizes in the cache if there is one.
+   * @param state The state of the communication.
+   */
+  template<bool FORWARD, class DataHandle>
+  void cacheSizes(ExchangeState<FORWARD,DataHandle>& state);
+  /**
+   * @brief Compute the checksums of the sizes of the entries sent to each neighbour.
+   * @param state The state of the communication.
+   */
+  template<bool FORWARD, class DataHandle>
+  void computeSendChecksums(ExchangeState<FORWARD,DataHandle>& state);
+  /**
+   * @brief Add the size of the next entry to a checksum.
+   */
+  static std::size_t addToChecksum(std::size_t checksum, std::size_t size)
+  {
+    return 31*checksum + size + 1;
+  }
+  /**
+   * @brief Check the requests of a communication and continue it without blocking.
+   *
+   * For data with a variable amount per entry the data is sent once all
+   * sizes have been communicated.
+   * @param state The state of the communication.
+   * @return True if all data was sent and received.
+   */
+  template<bool FORWARD, class DataHandle>
+  bool progressExchange(ExchangeState<FORWARD,DataHandle>& state);
+  /**
+   * @brief Continue a communication until it is complete.
+   * @param state The state of the communication.
+   */
+  template<bool FORWARD, class DataHandle>
+  void finishExchange(ExchangeState<FORWARD,DataHandle>& state);
+  /**
+   * @brief Start exchanging the sizes by a neighbourhood collective.
+   * @param state The state of the communication.
+   */
+  template<bool FORWARD, class DataHandle>
+  void startNeighborhoodExchange(ExchangeState<FORWARD,DataHandle>& state);
+  /**
+   * @brief Pack the data and start exchanging it by a neighbourhood collective.
+   * @param state The state of the communication.
+   */
+  template<bool FORWARD, class DataHandle>
+  void startNeighborhoodData(ExchangeState<FORWARD,DataHandle>& state);
+  /**
+   * @brief Check the neighbourhood collective of a communication and continue it.
+   * @param state The state of the communication.
+   * @return True if all data was received and unpacked.
+   */
+  template<bool FORWARD, class DataHandle>
+  bool progressNeighborhoodExchange(ExchangeState<FORWARD,DataHandle>& state);
+  /**
+   * @brief Set up the communicator according to the backend.
+   *
+   * Either duplicates comm or creates the graph topology of the interface.
+   */
+  void createCommunicator(MPI_Comm comm)
+  {
+    if(backend_ == CommunicationBackend::neighborhoodCollective)
+      communicator_ = Impl::createNeighborhoodCommunicator(comm, *interface_);
+    else
+      MPI_Comm_dup(comm, &communicator_);
+  }
   /**
    * @brief The maximum size if the buffers used for gather and scatter.
    *
@@ -550,8 +1131,13 @@ private:
    * @brief The communicator.
    *
    * This is a cloned communicator to ensure there are no interferences.
+   * For the neighbourhood collectives this is the graph communicator.
    */
   MPI_Comm communicator_;
+  /**
+   * @brief The MPI calls used for the communication.
+   */
+  CommunicationBackend backend_;
 };
 
 /** @} */
@@ -814,6 +1400,7 @@ struct UnpackSizeEntries{
   {
     MPI_Issend(&(iter->fixedSize), 1, MPITraits<std::size_t>::getType(),
                iter->rank(), 933881, communicator, &(*mIter1));
+    DUNE_COMMUNICATION_MESSAGE(sizeof(std::size_t));
   }
 }
 
@@ -831,13 +1418,19 @@ struct SetupSendRequest{
                   MPI_Comm comm) const
   {
     buffer.reset();
-    int size=PackEntries<DataHandle>()(handle, tracker, buffer);
+    int size;
+    {
+      DUNE_COMMUNICATION_PACK_PHASE;
+      size=PackEntries<DataHandle>()(handle, tracker, buffer);
+    }
     // Skip indices of zero size.
     while(!tracker.finished() &&  !handle.size(tracker.index()))
       tracker.moveToNextIndex();
-    if(size)
+    if(size) {
       MPI_Issend(buffer, size, MPITraits<typename DataHandle::DataType>::getType(),
                  tracker.rank(), 933399, comm, &request);
+      DUNE_COMMUNICATION_MESSAGE(size*sizeof(typename DataHandle::DataType));
+    }
   }
 };
 
@@ -917,6 +1510,7 @@ std::size_t checkAndContinue(DataHandle& handle,
   {
     InterfaceTracker& tracker=trackers[*index];
     setReceivingIndex(handle, *index);
+    DUNE_COMMUNICATION_PACK_PHASE;
     if(getCount)
     {
       // Get the number of entries received
@@ -1073,167 +1667,588 @@ void VariableSizeCommunicator<Allocator>::setupInterfaceTrackers(DataHandle& han
   }
 }
 
+/**
+ * @brief The state of a communication in progress.
+ *
+ * In the case of variable sizes the sizes are communicated first using a
+ * SizeDataHandle before the actual data is sent.
+ */
 template<class Allocator>
 template<bool FORWARD, class DataHandle>
-void VariableSizeCommunicator<Allocator>::communicateFixedSize(DataHandle& handle)
+struct VariableSizeCommunicator<Allocator>::ExchangeState
 {
-  std::vector<MPI_Request> size_send_req(interface_->size());
-  std::vector<MPI_Request> size_recv_req(interface_->size());
-
-  std::vector<InterfaceTracker> send_trackers;
-  std::vector<InterfaceTracker> recv_trackers;
-  setupInterfaceTrackers<FORWARD>(handle,send_trackers, recv_trackers);
-  sendFixedSize(send_trackers,  size_send_req, recv_trackers, size_recv_req, communicator_);
-
-  std::vector<MPI_Request> data_send_req(interface_->size(), MPI_REQUEST_NULL);
-  std::vector<MPI_Request> data_recv_req(interface_->size(), MPI_REQUEST_NULL);
   typedef typename DataHandle::DataType DataType;
-  std::vector<MessageBuffer<DataType> > send_buffers(interface_->size(), MessageBuffer<DataType>(maxBufferSize_)),
-    recv_buffers(interface_->size(), MessageBuffer<DataType>(maxBufferSize_));
-
 
-  setupRequests(handle, send_trackers, send_buffers, data_send_req,
-                SetupSendRequest<DataHandle>(), communicator_);
+  /**
+   * @brief Constructor.
+   * @param h The handle describing the data.
+   * @param neighbours The number of neighbours in the interface.
+   * @param maxBufferSize The size of the message buffers.
+   * @param pointToPoint Whether to allocate the message buffers for
+   * point-to-point communication. Otherwise they are created with the size
+   * of the messages once the sizes are known.
+   */
+  ExchangeState(DataHandle& h, std::size_t neighbours, std::size_t maxBufferSize, bool pointToPoint)
+    : handle(h), fixedSize(Impl::callFixedSize(h)), sizesCommunicated(fixedSize),
+      send_requests(neighbours, MPI_REQUEST_NULL), recv_requests(neighbours, MPI_REQUEST_NULL),
+      send_buffers(pointToPoint ? neighbours : 0,
+                   MessageBuffer<DataType>(maxBufferSize*Impl::MessageBufferScale<DataHandle>::value)),
+      recv_buffers(pointToPoint ? neighbours : 0,
+                   MessageBuffer<DataType>(maxBufferSize*Impl::MessageBufferScale<DataHandle>::value)),
+      size_handle(h, recv_trackers),
+      size_send_requests(neighbours, MPI_REQUEST_NULL), size_recv_requests(neighbours, MPI_REQUEST_NULL),
+      size_send_buffers(fixedSize || !pointToPoint ? 0 : neighbours, MessageBuffer<std::size_t>(maxBufferSize)),
+      size_recv_buffers(fixedSize || !pointToPoint ? 0 : neighbours, MessageBuffer<std::size_t>(maxBufferSize)),
+      no_size_to_send(0), no_size_to_recv(0), no_to_send(0), no_to_recv(0),
+      collective(MPI_REQUEST_NULL), complete(false), cache(nullptr), checksumsPending(false)
+  {}
 
-  std::size_t no_size_to_recv,  no_to_send, no_to_recv, old_size;
-  no_size_to_recv = no_to_send = no_to_recv = old_size = interface_->size();
+  ExchangeState(const ExchangeState&) = delete;
+  ExchangeState& operator=(const ExchangeState&) = delete;
+
+  /** @brief The handle describing the data. */
+  DataHandle& handle;
+  /** @brief Whether the number of data items per entry is fixed. */
+  bool fixedSize;
+  /** @brief Whether the sizes of the entries are known at the receiving side. */
+  bool sizesCommunicated;
+  std::vector<InterfaceTracker> send_trackers, recv_trackers;
+  std::vector<MPI_Request> send_requests, recv_requests;
+  std::vector<MessageBuffer<DataType> > send_buffers, recv_buffers;
+  /** @brief The handle for communicating the sizes into the receive trackers. */
+  SizeDataHandle<DataHandle> size_handle;
+  /**
+   * @brief The requests for communicating the sizes.
+   *
+   * In the case of fixed size these are used to send the size per entry.
+   */
+  std::vector<MPI_Request> size_send_requests, size_recv_requests;
+  std::vector<InterfaceTracker> size_send_trackers, size_recv_trackers;
+  std::vector<MessageBuffer<std::size_t> > size_send_buffers, size_recv_buffers;
+  /** @brief The numbers of neighbours we still communicate with. */
+  std::size_t no_size_to_send, no_size_to_recv, no_to_send, no_to_recv;
+  /** @brief The request of the neighbourhood collective in progress. */
+  MPI_Request collective;
+  /** @brief Whether the data of the neighbourhood collective was unpacked. */
+  bool complete;
+  /**
+   * @brief The counts, absolute addresses and types of the messages sent to
+   * (index 0) and received from (index 1) each neighbour.
+   */
+  std::vector<int> counts[2];
+  std::vector<MPI_Aint> displs[2];
+  std::vector<MPI_Datatype> types[2];
+  /** @brief The sizes of the entries sent to each neighbour. */
+  std::vector<std::vector<std::size_t> > sizes;
+  /** @brief The cached sizes of the handle or nullptr. */
+  SizeCache* cache;
+  /** @brief Whether the checksums of the cached sizes are being exchanged. */
+  bool checksumsPending;
+  /**
+   * @brief The checksums of the sizes sent to (index 0) and received from
+   * (index 1) each neighbour.
+   */
+  std::vector<std::size_t> checksums[2];
+  /** @brief The requests for receiving (first half) and sending the checksums. */
+  std::vector<MPI_Request> checksum_requests;
+  /**
+   * @brief Whether the sizes sent to (index 0) and received from (index 1)
+   * each neighbour are communicated again although they are cached.
+   */
+  std::vector<bool> renegotiate[2];
+  /**
+   * @brief Whether the sizes of this process (index 0) and of any process
+   * (index 1) changed, for the neighbourhood collective.
+   */
+  int changed[2] = {0, 0};
+};
 
-  // Skip empty interfaces.
-  typedef typename std::vector<InterfaceTracker>::const_iterator Iter;
-  for(Iter i=recv_trackers.begin(), end=recv_trackers.end(); i!=end; ++i)
-    if(i->empty())
-       --no_to_recv;
-  for(Iter i=send_trackers.begin(), end=send_trackers.end(); i!=end; ++i)
-    if(i->empty())
-      --no_to_send;
+template<class Allocator>
+template<bool FORWARD, class DataHandle>
+void VariableSizeCommunicator<Allocator>::startExchange(ExchangeState<FORWARD,DataHandle>& state)
+{
+  DUNE_COMMUNICATION_SCOPE("VariableSizeCommunicator::start");
+  DUNE_COMMUNICATION_NEIGHBOURS(interface_->size());
+  setupInterfaceTrackers<FORWARD>(state.handle, state.send_trackers, state.recv_trackers);
 
-  while(no_size_to_recv+no_to_send+no_to_recv)
+  if(backend_ == CommunicationBackend::neighborhoodCollective)
   {
-    // Receive the fixedsize and setup receives accordingly
-    if(no_size_to_recv)
-      no_size_to_recv -= receiveSizeAndSetupReceive(handle,recv_trackers, size_recv_req,
-                                                  data_recv_req, recv_buffers,
-                                                  communicator_);
-
-    // Check send completion and initiate other necessary sends
-    if(no_to_send)
-      no_to_send -= checkSendAndContinueSending(handle, send_trackers, data_send_req,
-                                              send_buffers, communicator_);
-    if(validRecvRequests(data_recv_req))
-      // Receive data and setup new unblocking receives if necessary
-      no_to_recv -= checkReceiveAndContinueReceiving(handle, recv_trackers, data_recv_req,
-                                                     recv_buffers, communicator_);
+    startNeighborhoodExchange(state);
+    return;
   }
 
-  // Wait for completion of sending the size.
-  //std::vector<MPI_Status> statuses(interface_->size(), MPI_STATUSES_IGNORE);
-  MPI_Waitall(size_send_req.size(), &(size_send_req[0]), MPI_STATUSES_IGNORE);
-
+  if(state.fixedSize)
+  {
+    sendFixedSize(state.send_trackers, state.size_send_requests,
+                  state.recv_trackers, state.size_recv_requests, communicator_);
+    setupRequests(state.handle, state.send_trackers, state.send_buffers, state.send_requests,
+                  SetupSendRequest<DataHandle>(), communicator_);
+
+    state.no_size_to_recv = state.no_to_send = state.no_to_recv = interface_->size();
+
+    // Skip empty interfaces.
+    typedef typename std::vector<InterfaceTracker>::const_iterator Iter;
+    for(Iter i=state.recv_trackers.begin(), end=state.recv_trackers.end(); i!=end; ++i)
+      if(i->empty())
+        --state.no_to_recv;
+    for(Iter i=state.send_trackers.begin(), end=state.send_trackers.end(); i!=end; ++i)
+      if(i->empty())
+        --state.no_to_send;
+  }
+  else if(state.cache && state.cache->valid_[FORWARD])
+    startChecksumExchange(state);
+  else
+    startSizeExchange(state);
 }
 
 template<class Allocator>
 template<bool FORWARD, class DataHandle>
-void VariableSizeCommunicator<Allocator>::communicateSizes(DataHandle& handle,
-                                                           std::vector<InterfaceTracker>& data_recv_trackers)
+void VariableSizeCommunicator<Allocator>::startSizeExchange(ExchangeState<FORWARD,DataHandle>& state)
 {
-  std::vector<InterfaceTracker> send_trackers;
-  std::vector<InterfaceTracker> recv_trackers;
-  std::size_t size = interface_->size();
-  std::vector<MPI_Request> send_requests(size, MPI_REQUEST_NULL);
-  std::vector<MPI_Request> recv_requests(size, MPI_REQUEST_NULL);
-  std::vector<MessageBuffer<std::size_t> >
-    send_buffers(size, MessageBuffer<std::size_t>(maxBufferSize_)),
-    recv_buffers(size, MessageBuffer<std::size_t>(maxBufferSize_));
-  SizeDataHandle<DataHandle> size_handle(handle,data_recv_trackers);
-  setupInterfaceTrackers<FORWARD>(size_handle,send_trackers, recv_trackers);
-  setupRequests(size_handle, send_trackers, send_buffers, send_requests,
-                                SetupSendRequest<SizeDataHandle<DataHandle> >(), communicator_);
-  setupRequests(size_handle, recv_trackers, recv_buffers, recv_requests,
-                SetupRecvRequest<SizeDataHandle<DataHandle> >(), communicator_);
+  // Communicate the sizes into the receive trackers first.
+  setupInterfaceTrackers<FORWARD>(state.size_handle, state.size_send_trackers,
+                                  state.size_recv_trackers);
+  // Skip the neighbours whose cached sizes are still valid
+  for(std::size_t i=0; i<state.renegotiate[0].size(); ++i)
+  {
+    if(!state.renegotiate[0][i])
+      state.size_send_trackers[i] = InterfaceTracker(state.size_send_trackers[i].rank(),
+                                                     InterfaceInformation(), 1);
+    if(!state.renegotiate[1][i])
+      state.size_recv_trackers[i] = InterfaceTracker(state.size_recv_trackers[i].rank(),
+                                                     InterfaceInformation(), 1);
+  }
+  setupRequests(state.size_handle, state.size_send_trackers, state.size_send_buffers,
+                state.size_send_requests, SetupSendRequest<SizeDataHandle<DataHandle> >(),
+                communicator_);
+  setupRequests(state.size_handle, state.size_recv_trackers, state.size_recv_buffers,
+                state.size_recv_requests, SetupRecvRequest<SizeDataHandle<DataHandle> >(),
+                communicator_);
 
   // Count valid requests that we have to wait for.
   auto valid_req_func =
     [](const MPI_Request& req) { return req != MPI_REQUEST_NULL; };
+  state.no_size_to_send = std::count_if(state.size_send_requests.begin(),
+                                        state.size_send_requests.end(), valid_req_func);
+  state.no_size_to_recv = std::count_if(state.size_recv_requests.begin(),
+                                        state.size_recv_requests.end(), valid_req_func);
+}
 
-  auto size_to_send = std::count_if(send_requests.begin(), send_requests.end(),
-                                    valid_req_func);
-  auto size_to_recv = std::count_if(recv_requests.begin(), recv_requests.end(),
-                                    valid_req_func);
+template<class Allocator>
+template<bool FORWARD, class DataHandle>
+void VariableSizeCommunicator<Allocator>::startChecksumExchange(ExchangeState<FORWARD,DataHandle>& state)
+{
+  const std::size_t neighbours = interface_->size();
+  computeSendChecksums(state);
+  state.checksums[1].assign(neighbours, 0);
+  state.checksum_requests.assign(2*neighbours, MPI_REQUEST_NULL);
 
-  while(size_to_send+size_to_recv)
+  typedef typename InterfaceMap::const_iterator IIter;
+  std::size_t i=0;
+  for(IIter inf=interface_->begin(), end=interface_->end(); inf!=end; ++inf, ++i)
   {
-    if(size_to_send)
-      size_to_send -=
-        checkSendAndContinueSending(size_handle, send_trackers, send_requests,
-                                    send_buffers, communicator_);
-    if(size_to_recv)
-      // Could have done this using checkSendAndContinueSending
-      // But the call below is more efficient as UnpackSizeEntries
-      // uses std::copy.
-      size_to_recv -=
-        checkAndContinue(size_handle, recv_trackers, recv_requests, recv_requests,
-                         recv_buffers, communicator_, UnpackSizeEntries<DataHandle>(),
-                         SetupRecvRequest<SizeDataHandle<DataHandle> >());
+    if(InterfaceInformationChooser<FORWARD>::getReceive(inf->second).size())
+      MPI_Irecv(&state.checksums[1][i], 1, MPITraits<std::size_t>::getType(),
+                inf->first, 933882, communicator_, &state.checksum_requests[i]);
+    if(InterfaceInformationChooser<FORWARD>::getSend(inf->second).size())
+    {
+      MPI_Issend(&state.checksums[0][i], 1, MPITraits<std::size_t>::getType(),
+                 inf->first, 933882, communicator_, &state.checksum_requests[neighbours+i]);
+      DUNE_COMMUNICATION_MESSAGE(sizeof(std::size_t));
+    }
   }
+  state.checksumsPending = true;
 }
 
 template<class Allocator>
 template<bool FORWARD, class DataHandle>
-void VariableSizeCommunicator<Allocator>::communicateVariableSize(DataHandle& handle)
+bool VariableSizeCommunicator<Allocator>::compareChecksums(ExchangeState<FORWARD,DataHandle>& state)
 {
+  const SizeCache& cache = *state.cache;
+  const std::size_t neighbours = interface_->size();
+  state.renegotiate[0].assign(neighbours, false);
+  state.renegotiate[1].assign(neighbours, false);
+  bool changed = false;
+  for(std::size_t i=0; i<neighbours; ++i)
+  {
+    // Both sides of a neighbour pair compare the same pair of checksums
+    state.renegotiate[0][i] = state.checksums[0][i] != cache.sendChecksums_[FORWARD][i];
+    state.renegotiate[1][i] = state.checksums[1][i] != cache.recvChecksums_[FORWARD][i];
+    if(!state.renegotiate[1][i])
+      useCachedSizes(state, i);
+    changed = changed || state.renegotiate[0][i] || state.renegotiate[1][i];
+  }
+  return changed;
+}
 
-  std::vector<InterfaceTracker> send_trackers;
-  std::vector<InterfaceTracker> recv_trackers;
-  setupInterfaceTrackers<FORWARD>(handle, send_trackers, recv_trackers);
-
-  std::vector<MPI_Request> send_requests(interface_->size(), MPI_REQUEST_NULL);
-  std::vector<MPI_Request> recv_requests(interface_->size(), MPI_REQUEST_NULL);
-  typedef typename DataHandle::DataType DataType;
-  std::vector<MessageBuffer<DataType> >
-    send_buffers(interface_->size(), MessageBuffer<DataType>(maxBufferSize_)),
-    recv_buffers(interface_->size(), MessageBuffer<DataType>(maxBufferSize_));
-
-  communicateSizes<FORWARD>(handle, recv_trackers);
+template<class Allocator>
+template<bool FORWARD, class DataHandle>
+void VariableSizeCommunicator<Allocator>::setupDataRequests(ExchangeState<FORWARD,DataHandle>& state)
+{
   // Setup requests for sending and receiving.
-  setupRequests(handle, send_trackers, send_buffers, send_requests,
+  setupRequests(state.handle, state.send_trackers, state.send_buffers, state.send_requests,
                 SetupSendRequest<DataHandle>(), communicator_);
-  setupRequests(handle, recv_trackers, recv_buffers, recv_requests,
+  setupRequests(state.handle, state.recv_trackers, state.recv_buffers, state.recv_requests,
                 SetupRecvRequest<DataHandle>(), communicator_);
 
   // Determine number of valid requests.
   auto valid_req_func =
     [](const MPI_Request& req) { return req != MPI_REQUEST_NULL;};
 
-  auto no_to_send = std::count_if(send_requests.begin(), send_requests.end(),
-                             valid_req_func);
-  auto no_to_recv = std::count_if(recv_requests.begin(), recv_requests.end(),
-                             valid_req_func);
-  while(no_to_send+no_to_recv)
+  state.no_to_send = std::count_if(state.send_requests.begin(), state.send_requests.end(),
+                                   valid_req_func);
+  state.no_to_recv = std::count_if(state.recv_requests.begin(), state.recv_requests.end(),
+                                   valid_req_func);
+  state.sizesCommunicated = true;
+}
+
+template<class Allocator>
+template<bool FORWARD, class DataHandle>
+void VariableSizeCommunicator<Allocator>::computeSendChecksums(ExchangeState<FORWARD,DataHandle>& state)
+{
+  state.checksums[0].assign(interface_->size(), 0);
+  typedef typename InterfaceMap::const_iterator IIter;
+  std::size_t i=0;
+  for(IIter inf=interface_->begin(), end=interface_->end(); inf!=end; ++inf, ++i)
   {
+    const InterfaceInformation& send = InterfaceInformationChooser<FORWARD>::getSend(inf->second);
+    for(std::size_t j=0; j<send.size(); ++j)
+      state.checksums[0][i] = addToChecksum(state.checksums[0][i], state.handle.size(send[j]));
+  }
+}
+
+template<class Allocator>
+template<bool FORWARD, class DataHandle>
+void VariableSizeCommunicator<Allocator>::useCachedSizes(ExchangeState<FORWARD,DataHandle>& state,
+                                                         std::size_t i)
+{
+  const std::vector<std::size_t>& sizes = state.cache->sizes_[FORWARD][i];
+  if(!state.recv_trackers[i].empty())
+    std::copy(sizes.begin(), sizes.end(), state.recv_trackers[i].getSizesPointer());
+}
+
+template<class Allocator>
+template<bool FORWARD, class DataHandle>
+void VariableSizeCommunicator<Allocator>::cacheSizes(ExchangeState<FORWARD,DataHandle>& state)
+{
+  if(!state.cache)
+    return;
+  SizeCache& cache = *state.cache;
+  std::vector<std::vector<std::size_t> >& sizes = cache.sizes_[FORWARD];
+  sizes.resize(interface_->size());
+  cache.recvChecksums_[FORWARD].assign(interface_->size(), 0);
+  std::size_t i=0;
+  typedef typename InterfaceMap::const_iterator IIter;
+  for(IIter inf=interface_->begin(), end=interface_->end(); inf!=end; ++inf, ++i)
+  {
+    std::size_t n = InterfaceInformationChooser<FORWARD>::getReceive(inf->second).size();
+    if(n)
+      sizes[i].assign(state.recv_trackers[i].getSizesPointer(),
+                      state.recv_trackers[i].getSizesPointer()+n);
+    else
+      sizes[i].clear();
+    for(std::size_t size : sizes[i])
+      cache.recvChecksums_[FORWARD][i] = addToChecksum(cache.recvChecksums_[FORWARD][i], size);
+  }
+  if(state.checksums[0].empty())
+    computeSendChecksums(state);
+  cache.sendChecksums_[FORWARD] = state.checksums[0];
+  cache.valid_[FORWARD] = true;
+}
+
+template<class Allocator>
+template<bool FORWARD, class DataHandle>
+bool VariableSizeCommunicator<Allocator>::progressExchange(ExchangeState<FORWARD,DataHandle>& state)
+{
+  if(backend_ == CommunicationBackend::neighborhoodCollective)
+    return progressNeighborhoodExchange(state);
+
+  if(state.fixedSize)
+  {
+    // Receive the fixedsize and setup receives accordingly
+    if(state.no_size_to_recv)
+      state.no_size_to_recv -= receiveSizeAndSetupReceive(state.handle, state.recv_trackers,
+                                                          state.size_recv_requests,
+                                                          state.recv_requests, state.recv_buffers,
+                                                          communicator_);
+
     // Check send completion and initiate other necessary sends
-    if(no_to_send)
-      no_to_send -= checkSendAndContinueSending(handle, send_trackers, send_requests,
-                                              send_buffers, communicator_);
-    if(no_to_recv)
+    if(state.no_to_send)
+      state.no_to_send -= checkSendAndContinueSending(state.handle, state.send_trackers,
+                                                      state.send_requests, state.send_buffers,
+                                                      communicator_);
+    if(validRecvRequests(state.recv_requests))
       // Receive data and setup new unblocking receives if necessary
-      no_to_recv -= checkReceiveAndContinueReceiving(handle, recv_trackers, recv_requests,
-                                                     recv_buffers, communicator_);
+      state.no_to_recv -= checkReceiveAndContinueReceiving(state.handle, state.recv_trackers,
+                                                           state.recv_requests, state.recv_buffers,
+                                                           communicator_);
+    return !(state.no_size_to_recv+state.no_to_send+state.no_to_recv);
+  }
+
+  if(state.checksumsPending)
+  {
+    int flag;
+    MPI_Testall(state.checksum_requests.size(), state.checksum_requests.data(), &flag,
+                MPI_STATUSES_IGNORE);
+    if(!flag)
+      return false;
+    state.checksumsPending = false;
+    if(!compareChecksums(state))
+    {
+      // All cached sizes are still valid
+      setupDataRequests(state);
+    }
+    else
+      startSizeExchange(state);
+  }
+
+  if(!state.sizesCommunicated)
+  {
+    if(state.no_size_to_send)
+      state.no_size_to_send -=
+        checkSendAndContinueSending(state.size_handle, state.size_send_trackers,
+                                    state.size_send_requests, state.size_send_buffers,
+                                    communicator_);
+    if(state.no_size_to_recv)
+      // Could have done this using checkSendAndContinueSending
+      // But the call below is more efficient as UnpackSizeEntries
+      // uses std::copy.
+      state.no_size_to_recv -=
+        checkAndContinue(state.size_handle, state.size_recv_trackers, state.size_recv_requests,
+                         state.size_recv_requests, state.size_recv_buffers, communicator_,
+                         UnpackSizeEntries<DataHandle>(),
+                         SetupRecvRequest<SizeDataHandle<DataHandle> >());
+    if(state.no_size_to_send+state.no_size_to_recv)
+      return false;
+
+    cacheSizes(state);
+    setupDataRequests(state);
   }
+
+  // Check send completion and initiate other necessary sends
+  if(state.no_to_send)
+    state.no_to_send -= checkSendAndContinueSending(state.handle, state.send_trackers,
+                                                    state.send_requests, state.send_buffers,
+                                                    communicator_);
+  if(state.no_to_recv)
+    // Receive data and setup new unblocking receives if necessary
+    state.no_to_recv -= checkReceiveAndContinueReceiving(state.handle, state.recv_trackers,
+                                                         state.recv_requests, state.recv_buffers,
+                                                         communicator_);
+  return !(state.no_to_send+state.no_to_recv);
+}
+
+template<class Allocator>
+template<bool FORWARD, class DataHandle>
+void VariableSizeCommunicator<Allocator>::finishExchange(ExchangeState<FORWARD,DataHandle>& state)
+{
+  DUNE_COMMUNICATION_SCOPE("VariableSizeCommunicator::finish");
+  // Packing and unpacking while waiting is recorded separately
+  DUNE_COMMUNICATION_WAIT_PHASE;
+  while(!progressExchange(state))
+  {}
+
+  if(state.fixedSize)
+    // Wait for completion of sending the size.
+    MPI_Waitall(state.size_send_requests.size(), state.size_send_requests.data(),
+                MPI_STATUSES_IGNORE);
 }
 
 template<class Allocator>
 template<bool FORWARD, class DataHandle>
-void VariableSizeCommunicator<Allocator>::communicate(DataHandle& handle)
+void VariableSizeCommunicator<Allocator>::startNeighborhoodExchange(ExchangeState<FORWARD,DataHandle>& state)
 {
-  if( interface_->size() == 0)
+  const std::size_t neighbours = interface_->size();
+  for(int i=0; i<2; ++i)
+  {
+    state.counts[i].assign(neighbours, 0);
+    state.displs[i].assign(neighbours, 0);
+    state.types[i].assign(neighbours, MPITraits<std::size_t>::getType());
+  }
+  state.sizesCommunicated = false;
+
+  // The neighbours of the graph are the keys of the interface in ascending order
+  typedef typename InterfaceMap::const_iterator IIter;
+  std::size_t i=0;
+  if(state.fixedSize)
+  {
+    // Exchange the number of data items per entry
+    for(; i<neighbours; ++i)
+    {
+      state.counts[0][i] = state.counts[1][i] = 1;
+      MPI_Get_address(&state.send_trackers[i].fixedSize, &state.displs[0][i]);
+      MPI_Get_address(&state.recv_trackers[i].fixedSize, &state.displs[1][i]);
+    }
+  }
+  else
+  {
+    // Exchange the number of data items of each entry
+    state.sizes.resize(neighbours);
+    for(IIter inf=interface_->begin(), end=interface_->end(); inf!=end; ++inf, ++i)
+    {
+      const InterfaceInformation& send = InterfaceInformationChooser<FORWARD>::getSend(inf->second);
+      const InterfaceInformation& recv = InterfaceInformationChooser<FORWARD>::getReceive(inf->second);
+      state.sizes[i].reserve(send.size());
+      for(std::size_t j=0; j<send.size(); ++j)
+        state.sizes[i].push_back(state.handle.size(send[j]));
+      state.counts[0][i] = send.size();
+      if(send.size())
+        MPI_Get_address(state.sizes[i].data(), &state.displs[0][i]);
+      state.counts[1][i] = recv.size();
+      if(recv.size())
+        MPI_Get_address(state.recv_trackers[i].getSizesPointer(), &state.displs[1][i]);
+    }
+    if(state.cache && state.cache->valid_[FORWARD])
+    {
+      // All processes take part in the collectives, so they decide together
+      // whether the sizes are communicated again.
+      computeSendChecksums(state);
+      state.changed[0] = state.checksums[0] != state.cache->sendChecksums_[FORWARD];
+      MPI_Iallreduce(&state.changed[0], &state.changed[1], 1, MPI_INT, MPI_LOR,
+                     communicator_, &state.collective);
+      state.checksumsPending = true;
+      return;
+    }
+  }
+  MPI_Ineighbor_alltoallw(MPI_BOTTOM, state.counts[0].data(), state.displs[0].data(), state.types[0].data(),
+                          MPI_BOTTOM, state.counts[1].data(), state.displs[1].data(), state.types[1].data(),
+                          communicator_, &state.collective);
+}
+
+template<class Allocator>
+template<bool FORWARD, class DataHandle>
+void VariableSizeCommunicator<Allocator>::startNeighborhoodData(ExchangeState<FORWARD,DataHandle>& state)
+{
+  typedef typename DataHandle::DataType DataType;
+  const std::size_t neighbours = interface_->size();
+  state.send_buffers.reserve(neighbours);
+  state.recv_buffers.reserve(neighbours);
+
+  typedef typename InterfaceMap::const_iterator IIter;
+  std::size_t i=0;
+  for(IIter inf=interface_->begin(), end=interface_->end(); inf!=end; ++inf, ++i)
+  {
+    const InterfaceInformation& send = InterfaceInformationChooser<FORWARD>::getSend(inf->second);
+    const InterfaceInformation& recv = InterfaceInformationChooser<FORWARD>::getReceive(inf->second);
+    std::size_t sendCount, recvCount;
+    if(state.fixedSize)
+    {
+      sendCount = state.send_trackers[i].fixedSize * send.size();
+      recvCount = state.recv_trackers[i].fixedSize * recv.size();
+    }
+    else
+    {
+      sendCount = std::accumulate(state.sizes[i].begin(), state.sizes[i].end(), std::size_t(0));
+      recvCount = recv.size()
+        ? std::accumulate(state.recv_trackers[i].getSizesPointer(),
+                          state.recv_trackers[i].getSizesPointer()+recv.size(), std::size_t(0))
+        : 0;
+    }
+
+    // One buffer per neighbour holding the whole message
+    state.send_buffers.emplace_back(sendCount);
+    state.recv_buffers.emplace_back(recvCount);
+    if(send.size()) {
+      DUNE_COMMUNICATION_PACK_PHASE;
+      PackEntries<DataHandle>()(state.handle, state.send_trackers[i], state.send_buffers[i]);
+    }
+    if(sendCount)
+      DUNE_COMMUNICATION_MESSAGE(sendCount*sizeof(DataType));
+
+    state.counts[0][i] = sendCount;
+    state.counts[1][i] = recvCount;
+    MPI_Get_address(static_cast<DataType*>(state.send_buffers[i]), &state.displs[0][i]);
+    MPI_Get_address(static_cast<DataType*>(state.recv_buffers[i]), &state.displs[1][i]);
+    state.types[0][i] = state.types[1][i] = MPITraits<DataType>::getType();
+  }
+  MPI_Ineighbor_alltoallw(MPI_BOTTOM, state.counts[0].data(), state.displs[0].data(), state.types[0].data(),
+                          MPI_BOTTOM, state.counts[1].data(), state.displs[1].data(), state.types[1].data(),
+                          communicator_, &state.collective);
+}
+
+template<class Allocator>
+template<bool FORWARD, class DataHandle>
+bool VariableSizeCommunicator<Allocator>::progressNeighborhoodExchange(ExchangeState<FORWARD,DataHandle>& state)
+{
+  if(state.complete)
+    return true;
+
+  int flag;
+  MPI_Test(&state.collective, &flag, MPI_STATUS_IGNORE);
+  if(!flag)
+    return false;
+
+  if(state.checksumsPending)
+  {
+    state.checksumsPending = false;
+    if(state.changed[1])
+      MPI_Ineighbor_alltoallw(MPI_BOTTOM, state.counts[0].data(), state.displs[0].data(), state.types[0].data(),
+                              MPI_BOTTOM, state.counts[1].data(), state.displs[1].data(), state.types[1].data(),
+                              communicator_, &state.collective);
+    else
+    {
+      // The cached sizes are still valid, directly exchange the data.
+      for(std::size_t i=0; i<state.recv_trackers.size(); ++i)
+        useCachedSizes(state, i);
+      state.sizesCommunicated = true;
+      startNeighborhoodData(state);
+    }
+    return false;
+  }
+
+  if(!state.sizesCommunicated)
+  {
+    // The sizes are known, now exchange the data.
+    state.sizesCommunicated = true;
+    cacheSizes(state);
+    startNeighborhoodData(state);
+    return false;
+  }
+
+  DUNE_COMMUNICATION_PACK_PHASE;
+  for(std::size_t i=0; i<state.recv_trackers.size(); ++i)
+    if(state.counts[1][i])
+      UnpackEntries<DataHandle>()(state.handle, state.recv_trackers[i], state.recv_buffers[i],
+                                  state.counts[1][i]);
+  state.complete = true;
+  return true;
+}
+
+template<class Allocator>
+template<bool FORWARD, class DataHandle>
+void VariableSizeCommunicator<Allocator>::communicate(DataHandle& handle, SizeCache* sizeCache)
+{
+  if( interface_->size() == 0 && backend_ == CommunicationBackend::pointToPoint)
+  {
     // Simply return as otherwise we will index an empty container
     // either for MPI_Wait_all or MPI_Test_some.
     return;
+  }
 
-  if(Impl::callFixedSize(handle))
-    communicateFixedSize<FORWARD>(handle);
-  else
-    communicateVariableSize<FORWARD>(handle);
+  ExchangeState<FORWARD,DataHandle> state(handle, interface_->size(), maxBufferSize_,
+                                          backend_ == CommunicationBackend::pointToPoint);
+  state.cache = sizeCache;
+  startExchange(state);
+  finishExchange(state);
+}
+
+template<class Allocator>
+template<bool FORWARD, class DataHandle>
+typename VariableSizeCommunicator<Allocator>::template Exchange<FORWARD,DataHandle>
+VariableSizeCommunicator<Allocator>::begin(DataHandle& handle, SizeCache* sizeCache)
+{
+  typedef ExchangeState<FORWARD,DataHandle> State;
+  if( interface_->size() == 0 && backend_ == CommunicationBackend::pointToPoint)
+  {
+    // Nothing to communicate, the exchange is complete right away.
+    return Exchange<FORWARD,DataHandle>(*this, std::unique_ptr<State>());
+  }
+
+  auto state = std::make_unique<State>(handle, interface_->size(), maxBufferSize_,
+                                       backend_ == CommunicationBackend::pointToPoint);
+  state->cache = sizeCache;
+  startExchange(*state);
+  return Exchange<FORWARD,DataHandle>(*this, std::move(state));
 }
 } // end namespace Dune
 
@@ -0,0 +1,243 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <string>
+
+#include <dune/common/densecholesky.hh>
+#include <dune/common/denselu.hh>
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/simd/loop.hh>
+#include <dune/common/simd/simd.hh>
+#include <dune/common/test/testsuite.hh>
+
+constexpr double tolerance = 1e-12;
+
+// Relative difference of x and y
+template<class T>
+double difference(const T& x, const T& y)
+{
+  using std::max;
+  auto d = x;
+  d -= y;
+  return d.infinity_norm() / max(1.0, (double)y.infinity_norm());
+}
+
+double difference(double x, double y)
+{
+  using std::abs;
+  using std::max;
+  return abs(x - y) / max(1.0, abs(y));
+}
+
+// Fills a matrix or vector with random entries
+template<class T>
+void fillRandom(T& A, std::mt19937& rng)
+{
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  for (std::size_t i = 0; i < A.N(); ++i)
+  {
+    if constexpr (Dune::Impl::IsDenseMatrix_v<T>)
+      for (std::size_t j = 0; j < A.M(); ++j)
+        A[i][j] = dist(rng);
+    else
+      A[i] = dist(rng);
+  }
+}
+
+// Compares DenseLU and DenseCholesky of the n x n matrices of type M with
+// DenseMatrix::solve and DenseMatrix::determinant
+template<class M, class V, class B>
+Dune::TestSuite testFactorizations(M A, V b, B rhs, const std::string& name)
+{
+  Dune::TestSuite suite(name);
+  std::mt19937 rng(A.N());
+  const std::size_t n = A.N();
+
+  // A general matrix, without pivoting it would break down in the first step
+  fillRandom(A, rng);
+  if (n > 1)
+    A[0][0] = 0.0;
+  fillRandom(b, rng);
+  fillRandom(rhs, rng);
+
+  Dune::DenseLU<M> lu(A);
+  suite.check(lu.N() == n, "N");
+  suite.check(lu.nonsingularLanes(), "nonsingularLanes");
+
+  V x = b, xref = b;
+  lu.solve(x, b);
+  A.solve(xref, b);
+  suite.check(difference(x, xref) < tolerance, "LU solve");
+  suite.check(difference(lu.determinant(), A.determinant()) < tolerance, "LU determinant");
+
+  // the columns of the multi-RHS solve agree exactly with single solves
+  B X = rhs;
+  lu.solve(X, rhs);
+  for (std::size_t k = 0; k < rhs.M(); ++k)
+  {
+    V column = b, solution = b;
+    for (std::size_t i = 0; i < n; ++i)
+      column[i] = rhs[i][k];
+    lu.solve(solution, column);
+    for (std::size_t i = 0; i < n; ++i)
+      suite.check(X[i][k] == solution[i], "LU multi-RHS solve") << i << "," << k;
+  }
+
+  // refactorization without pivoting of a diagonally dominant matrix
+  for (std::size_t i = 0; i < n; ++i)
+    A[i][i] = 2.0*n;
+  lu.factorize(A, false);
+  A.solve(xref, b, false);
+  lu.solve(x, b);
+  suite.check(difference(x, xref) < tolerance, "LU solve without pivoting");
+  suite.check(difference(lu.determinant(), A.determinant(false)) < tolerance,
+              "LU determinant without pivoting");
+
+  // symmetric positive definite matrix
+  M S = A;
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < i; ++j)
+      S[i][j] = S[j][i];
+  Dune::DenseCholesky<M> cholesky(S);
+  suite.check(cholesky.positiveDefiniteLanes(), "positiveDefiniteLanes");
+  S.solve(xref, b);
+  cholesky.solve(x, b);
+  suite.check(difference(x, xref) < tolerance, "Cholesky solve");
+  suite.check(difference(cholesky.determinant(), S.determinant()) < tolerance,
+              "Cholesky determinant");
+  B Xref = rhs;
+  lu.factorize(S);
+  lu.solve(Xref, rhs);
+  cholesky.solve(X, rhs);
+  suite.check(difference(X, Xref) < tolerance, "Cholesky multi-RHS solve");
+
+  // singular and indefinite matrices
+  if (n > 1)
+  {
+    M singular = A;
+    singular[n-1] = singular[0];
+    lu.factorize(singular);
+    suite.check(!lu.nonsingularLanes(), "singular lanes");
+    suite.check(lu.determinant() == 0.0, "singular determinant");
+    suite.checkThrow<Dune::FMatrixError>([&]{ lu.solve(x, b); }, "singular solve");
+
+    M indefinite = S;
+    indefinite[n-1][n-1] = -1.0;
+    cholesky.factorize(indefinite);
+    suite.check(!cholesky.positiveDefiniteLanes(), "indefinite lanes");
+    suite.checkThrow<Dune::FMatrixError>([&]{ cholesky.solve(x, b); }, "indefinite solve");
+  }
+
+  return suite;
+}
+
+// Factorizes lanes matrices at once, one of them singular and indefinite
+template<int n, std::size_t lanes>
+Dune::TestSuite testSimd()
+{
+  using T = Dune::LoopSIMD<double,lanes>;
+  Dune::TestSuite suite("Simd lanes " + std::to_string(lanes) + " n " + std::to_string(n));
+  std::mt19937 rng(n);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+  Dune::FieldMatrix<double,n,n> A[lanes];
+  Dune::FieldVector<double,n> b[lanes];
+  Dune::FieldMatrix<T,n,n> simdA;
+  Dune::FieldVector<T,n> simdB;
+  for (std::size_t l = 0; l < lanes; ++l)
+  {
+    fillRandom(A[l], rng);
+    // symmetric positive definite in all but the singular lane
+    for (int i = 0; i < n; ++i)
+    {
+      for (int j = 0; j < i; ++j)
+        A[l][i][j] = A[l][j][i];
+      A[l][i][i] = 2.0*n;
+      b[l][i] = dist(rng);
+    }
+    if (l == 1)
+      A[l][n-1] = 0.0;
+    for (int i = 0; i < n; ++i)
+    {
+      Dune::Simd::lane(l, simdB[i]) = b[l][i];
+      for (int j = 0; j < n; ++j)
+        Dune::Simd::lane(l, simdA[i][j]) = A[l][i][j];
+    }
+  }
+
+  Dune::DenseLU<Dune::FieldMatrix<T,n,n>> lu(simdA);
+  Dune::DenseCholesky<Dune::FieldMatrix<T,n,n>> cholesky(simdA);
+  const T det = lu.determinant();
+  for (std::size_t l = 0; l < lanes; ++l)
+  {
+    Dune::DenseLU<Dune::FieldMatrix<double,n,n>> scalar(A[l]);
+    suite.check(Dune::Simd::lane(l, lu.nonsingularLanes()) == (l != 1), "nonsingularLanes") << l;
+    suite.check(Dune::Simd::lane(l, cholesky.positiveDefiniteLanes()) == (l != 1),
+                "positiveDefiniteLanes") << l;
+    suite.check(difference(Dune::Simd::lane(l, det), scalar.determinant()) < tolerance,
+                "determinant") << l;
+  }
+  suite.checkThrow<Dune::FMatrixError>([&]{ lu.solve(simdB, simdB); }, "singular lane");
+  suite.checkThrow<Dune::FMatrixError>([&]{ cholesky.solve(simdB, simdB); }, "indefinite lane");
+
+  // without the singular lane, each lane is solved as the scalar matrix
+  Dune::Simd::lane(1, simdA[n-1][n-1]) = 2.0*n;
+  for (std::size_t l = 0; l < lanes; ++l)
+    for (int i = 0; i < n; ++i)
+      Dune::Simd::lane(l, simdA[n-1][i]) = Dune::Simd::lane(l, simdA[i][n-1]);
+  lu.factorize(simdA);
+  cholesky.factorize(simdA);
+  Dune::FieldVector<T,n> simdX, simdY;
+  lu.solve(simdX, simdB);
+  cholesky.solve(simdY, simdB);
+  for (std::size_t l = 0; l < lanes; ++l)
+  {
+    Dune::FieldMatrix<double,n,n> Al;
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < n; ++j)
+        Al[i][j] = Dune::Simd::lane(l, simdA[i][j]);
+    Dune::FieldVector<double,n> x, y;
+    Dune::DenseLU<Dune::FieldMatrix<double,n,n>>(Al).solve(x, b[l]);
+    Dune::DenseCholesky<Dune::FieldMatrix<double,n,n>>(Al).solve(y, b[l]);
+    for (int i = 0; i < n; ++i)
+    {
+      suite.check(difference(Dune::Simd::lane(l, simdX[i]), x[i]) < tolerance, "LU solve") << l << "," << i;
+      suite.check(difference(Dune::Simd::lane(l, simdY[i]), y[i]) < tolerance, "Cholesky solve") << l << "," << i;
+    }
+  }
+
+  return suite;
+}
+
+template<int n>
+Dune::TestSuite testFieldMatrix()
+{
+  return testFactorizations(Dune::FieldMatrix<double,n,n>(), Dune::FieldVector<double,n>(),
+                            Dune::FieldMatrix<double,n,3>(),
+                            "FieldMatrix<double," + std::to_string(n) + "," + std::to_string(n) + ">");
+}
+
+int main()
+{
+  Dune::TestSuite suite;
+  suite.subTest(testFieldMatrix<1>());
+  suite.subTest(testFieldMatrix<2>());
+  suite.subTest(testFieldMatrix<3>());
+  suite.subTest(testFieldMatrix<5>());
+  suite.subTest(testFieldMatrix<8>());
+  for (std::size_t n : {1, 4, 12})
+    suite.subTest(testFactorizations(Dune::DynamicMatrix<double>(n, n), Dune::DynamicVector<double>(n),
+                                     Dune::DynamicMatrix<double>(n, 5),
+                                     "DynamicMatrix<double> of size " + std::to_string(n)));
+  suite.subTest(testSimd<3,4>());
+  suite.subTest(testSimd<6,8>());
+  return suite.exit();
+}
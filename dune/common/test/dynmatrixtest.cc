@@ -7,6 +7,7 @@
 #define DUNE_FMatrix_WITH_CHECKING
 #endif
 
+#include <dune/common/classname.hh>
 #include <dune/common/dynmatrix.hh>
 #include <dune/common/dynvector.hh>
 #include <dune/common/ftraits.hh>
@@ -14,6 +15,11 @@
 
 #include <iostream>
 #include <algorithm>
+#include <complex>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "checkmatrixinterface.hh"
@@ -406,6 +412,130 @@ int test_determinant()
   return ret;
 }
 
+// Random entry of the matrices and vectors in test_blas
+template<class K>
+K random_entry(std::mt19937& rng)
+{
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  using real_type = typename FieldTraits<K>::real_type;
+  if constexpr (std::is_same_v<K, real_type>)
+    return dist(rng);
+  else
+    return K(dist(rng), dist(rng));
+}
+
+template<class K>
+DynamicMatrix<K> random_matrix(std::size_t n, std::size_t m, std::mt19937& rng)
+{
+  // small off-diagonal entries keep the matrix well conditioned and the
+  // determinant of moderate size
+  DynamicMatrix<K> A(n, m);
+  for (std::size_t i=0; i<n; ++i)
+    for (std::size_t j=0; j<m; ++j)
+      A[i][j] = random_entry<K>(rng) / K(m);
+  for (std::size_t i=0; i<n && i<m; ++i)
+    A[i][i] += (i % 2 ? -1 : 1);
+  return A;
+}
+
+template<class K>
+DynamicVector<K> random_vector(std::size_t n, std::mt19937& rng)
+{
+  DynamicVector<K> x(n);
+  for (auto& xi : x)
+    xi = random_entry<K>(rng);
+  return x;
+}
+
+// Compares the operations of DynamicMatrix that use BLAS and LAPACK for large
+// matrices with the generic implementation of DenseMatrix
+template<class K>
+int test_blas(std::size_t n, std::size_t m)
+{
+  using Base = DenseMatrix<DynamicMatrix<K>>;
+  using real_type = typename FieldTraits<K>::real_type;
+  const real_type tolerance = 100 * std::max(n, m) * std::numeric_limits<real_type>::epsilon();
+  int ret = 0;
+  auto check = [&](bool ok, const char* what) {
+    if (!ok) {
+      std::cerr << "test_blas<" << className<K>() << ">(" << n << "," << m << "): "
+                << what << " differs from DenseMatrix" << std::endl;
+      ++ret;
+    }
+  };
+  auto difference = [](const auto& x, const auto& y) {
+    auto d = x;
+    d -= y;
+    return real_type(d.infinity_norm() / std::max(real_type(1), real_type(y.infinity_norm())));
+  };
+
+  std::mt19937 rng(n*m);
+  const DynamicMatrix<K> A = random_matrix<K>(n, m, rng);
+  const Base& baseA = A;
+  const DynamicVector<K> x = random_vector<K>(m, rng);
+  const DynamicVector<K> xt = random_vector<K>(n, rng);
+
+  DynamicVector<K> y(n), yref(n);
+  A.mv(x, y);
+  baseA.mv(x, yref);
+  check(difference(y, yref) < tolerance, "mv");
+  A.umv(x, y);
+  baseA.umv(x, yref);
+  check(difference(y, yref) < tolerance, "umv");
+
+  DynamicVector<K> yt(m), ytref(m);
+  A.mtv(xt, yt);
+  baseA.mtv(xt, ytref);
+  check(difference(yt, ytref) < tolerance, "mtv");
+  A.umtv(xt, yt);
+  baseA.umtv(xt, ytref);
+  check(difference(yt, ytref) < tolerance, "umtv");
+
+  const DynamicMatrix<K> right = random_matrix<K>(m, m, rng);
+  DynamicMatrix<K> C = A, Cref = A;
+  C.rightmultiply(right);
+  static_cast<Base&>(Cref).rightmultiply(right);
+  check(difference(C, Cref) < tolerance, "rightmultiply");
+
+  const DynamicMatrix<K> left = random_matrix<K>(n, n, rng);
+  C = A, Cref = A;
+  C.leftmultiply(left);
+  static_cast<Base&>(Cref).leftmultiply(left);
+  check(difference(C, Cref) < tolerance, "leftmultiply");
+
+  if (n == m)
+  {
+    DynamicVector<K> s(n), sref(n);
+    A.solve(s, xt);
+    baseA.solve(sref, xt);
+    check(difference(s, sref) < tolerance, "solve");
+
+    DynamicMatrix<K> inverse = A, inverseref = A;
+    inverse.invert();
+    static_cast<Base&>(inverseref).invert();
+    check(difference(inverse, inverseref) < tolerance, "invert");
+
+    using std::abs;
+    const K det = baseA.determinant();
+    check(abs(A.determinant() - det) < tolerance * std::max(real_type(1), real_type(abs(det))),
+          "determinant");
+
+    DynamicMatrix<K> singular(n, n, K(1));
+    if (singular.determinant() != K(0))
+      check(false, "singular determinant");
+    try {
+      singular.invert();
+      check(false, "singular invert");
+    } catch (const FMatrixError&) {}
+    try {
+      singular.solve(s, xt);
+      check(false, "singular solve");
+    } catch (const FMatrixError&) {}
+  }
+
+  return ret;
+}
+
 int main()
 {
   try {
@@ -421,6 +551,15 @@ int main()
     for (int i=0; i<34; i++) B[i][i] = 1;
     B.invert();
     ret += test_invert_solve();
+
+    // sizes around DUNE_DYNAMICMATRIX_BLAS_THRESHOLD
+    for (auto [n, m] : {std::pair<std::size_t, std::size_t>{3, 100}, {100, 3}, {70, 90}, {90, 70}, {80, 80}, {40, 40}})
+    {
+      ret += test_blas<float>(n, m);
+      ret += test_blas<double>(n, m);
+      ret += test_blas<std::complex<float>>(n, m);
+      ret += test_blas<std::complex<double>>(n, m);
+    }
     return ret;
   }
   catch (Dune::Exception & e)
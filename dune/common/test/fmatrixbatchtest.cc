@@ -0,0 +1,208 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fmatrixbatch.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/test/testsuite.hh>
+
+// Relative difference of x and y
+template<class T>
+double difference(const T& x, const T& y)
+{
+  using std::abs;
+  using std::max;
+  auto d = x;
+  d -= y;
+  return d.infinity_norm() / max(1.0, (double)y.infinity_norm());
+}
+
+double difference(double x, double y)
+{
+  using std::abs;
+  using std::max;
+  return abs(x - y) / max(1.0, abs(y));
+}
+
+// Random, diagonally dominant matrices of the batch size
+template<int n, int m>
+std::vector<Dune::FieldMatrix<double,n,m>> randomMatrices(std::size_t size, std::mt19937& rng)
+{
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  std::vector<Dune::FieldMatrix<double,n,m>> matrices(size);
+  for (auto& A : matrices)
+  {
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < m; ++j)
+        A[i][j] = dist(rng);
+    for (int i = 0; i < n && i < m; ++i)
+      A[i][i] += (i % 2 ? -1.0 : 1.0) * m;
+  }
+  return matrices;
+}
+
+template<int n>
+std::vector<Dune::FieldVector<double,n>> randomVectors(std::size_t size, std::mt19937& rng)
+{
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  std::vector<Dune::FieldVector<double,n>> vectors(size);
+  for (auto& x : vectors)
+    for (auto& xi : x)
+      xi = dist(rng);
+  return vectors;
+}
+
+// Compares the batched operations with those of the single matrices.
+template<int n, int m, std::size_t lanes>
+Dune::TestSuite testBatch(std::size_t size)
+{
+  Dune::TestSuite suite("FieldMatrixBatch<double," + std::to_string(n) + "," + std::to_string(m)
+                        + "," + std::to_string(lanes) + "> of size " + std::to_string(size));
+  constexpr double tolerance = 1e-12;
+  std::mt19937 rng(n*m + size);
+  auto matrices = randomMatrices<n,m>(size, rng);
+  auto x = randomVectors<m>(size, rng);
+  auto xt = randomVectors<n>(size, rng);
+
+  Dune::FieldMatrixBatch<double,n,m,lanes> batch(matrices);
+  suite.check(batch.size() == size, "size");
+  suite.check(batch.blocks().size() == (size + lanes - 1) / lanes, "blocks");
+
+  std::vector<Dune::FieldMatrix<double,n,m>> copy(size);
+  batch.copyTo(copy);
+  for (std::size_t k = 0; k < size; ++k)
+  {
+    suite.check(copy[k] == matrices[k], "copyTo") << k;
+    suite.check(batch[k] == matrices[k], "operator[]") << k;
+  }
+
+  std::vector<Dune::FieldVector<double,n>> y(size);
+  batch.mv(x, y);
+  for (std::size_t k = 0; k < size; ++k)
+  {
+    Dune::FieldVector<double,n> yk;
+    matrices[k].mv(x[k], yk);
+    suite.check(difference(y[k], yk) < tolerance, "mv") << k;
+  }
+
+  std::vector<Dune::FieldVector<double,m>> yt(size);
+  batch.mtv(xt, yt);
+  for (std::size_t k = 0; k < size; ++k)
+  {
+    Dune::FieldVector<double,m> yk;
+    matrices[k].mtv(xt[k], yk);
+    suite.check(difference(yt[k], yk) < tolerance, "mtv") << k;
+  }
+
+  auto factors = randomMatrices<m,m>(size, rng);
+  Dune::FieldMatrixBatch<double,m,m,lanes> factorBatch(factors);
+  auto product = batch;
+  product.rightmultiply(factorBatch);
+  for (std::size_t k = 0; k < size; ++k)
+  {
+    auto Ak = matrices[k];
+    Ak.rightmultiply(factors[k]);
+    suite.check(difference(product[k], Ak) < tolerance, "rightmultiply") << k;
+  }
+
+  if constexpr (n == m)
+  {
+    std::vector<double> det(size);
+    batch.determinant(det);
+    for (std::size_t k = 0; k < size; ++k)
+      suite.check(difference(det[k], matrices[k].determinant()) < tolerance, "determinant") << k;
+
+    std::vector<Dune::FieldVector<double,n>> solution(size);
+    batch.solve(solution, xt);
+    for (std::size_t k = 0; k < size; ++k)
+    {
+      Dune::FieldVector<double,n> sk;
+      matrices[k].solve(sk, xt[k]);
+      suite.check(difference(solution[k], sk) < tolerance, "solve") << k;
+    }
+
+    // symmetric positive definite matrices
+    auto spd = matrices;
+    for (auto& Ak : spd)
+      for (int i = 0; i < n; ++i)
+      {
+        for (int j = 0; j < i; ++j)
+          Ak[i][j] = Ak[j][i];
+        Ak[i][i] = 2.0*n;
+      }
+    Dune::FieldMatrixBatch<double,n,m,lanes> spdBatch(spd);
+    spdBatch.choleskySolve(solution, xt);
+    for (std::size_t k = 0; k < size; ++k)
+    {
+      Dune::FieldVector<double,n> sk;
+      spd[k].solve(sk, xt[k]);
+      suite.check(difference(solution[k], sk) < tolerance, "choleskySolve") << k;
+    }
+    if (size > 0)
+    {
+      spd[size-1][0][0] = -1.0;
+      spdBatch.assign(spd);
+      suite.checkThrow<Dune::FMatrixError>([&]{ spdBatch.choleskySolve(solution, xt); },
+                                           "choleskySolve of indefinite matrix");
+    }
+
+    auto inverse = batch;
+    inverse.invert();
+    for (std::size_t k = 0; k < size; ++k)
+    {
+      auto Ak = matrices[k];
+      Ak.invert();
+      suite.check(difference(inverse[k], Ak) < tolerance, "invert") << k;
+    }
+
+    // Without pivoting
+    inverse = batch;
+    inverse.invert(false);
+    batch.determinant(det, false);
+    for (std::size_t k = 0; k < size; ++k)
+    {
+      auto Ak = matrices[k];
+      Ak.invert(false);
+      suite.check(difference(inverse[k], Ak) < tolerance, "invert without pivoting") << k;
+      suite.check(difference(det[k], matrices[k].determinant(false)) < tolerance,
+                  "determinant without pivoting") << k;
+    }
+
+    // A singular matrix makes the batch singular, as it makes the matrix
+    // singular for FieldMatrix.
+    if (n > 3 && size > 0)
+    {
+      matrices[size-1] = 0.0;
+      Dune::FieldMatrixBatch<double,n,m,lanes> singular(matrices);
+      suite.checkThrow<Dune::FMatrixError>([&]{ singular.invert(); }, "singular");
+      singular.determinant(det);
+      suite.check(det[size-1] == 0.0, "singular determinant");
+    }
+  }
+
+  return suite;
+}
+
+int main()
+{
+  Dune::TestSuite suite;
+  for (std::size_t size : {0, 1, 7, 8, 33})
+  {
+    suite.subTest(testBatch<1,1,8>(size));
+    suite.subTest(testBatch<2,2,8>(size));
+    suite.subTest(testBatch<3,3,8>(size));
+    suite.subTest(testBatch<8,8,8>(size));
+    suite.subTest(testBatch<3,3,4>(size));
+    suite.subTest(testBatch<6,6,4>(size));
+    suite.subTest(testBatch<2,3,8>(size));
+    suite.subTest(testBatch<4,2,4>(size));
+  }
+  return suite.exit();
+}
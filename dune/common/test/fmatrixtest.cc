@@ -12,6 +12,7 @@
 #include <cassert>
 #include <complex>
 #include <iostream>
+#include <limits>
 #include <type_traits>
 #include <vector>
 
@@ -20,6 +21,8 @@
 #include <dune/common/bigfloat.hh>
 #include <dune/common/classname.hh>
 #include <dune/common/deprecated.hh>
+#include <dune/common/denselu.hh>
+#include <dune/common/dynmatrix.hh>
 #include <dune/common/fmatrix.hh>
 #include <dune/common/fmatrixev.hh>
 #include <dune/common/ftraits.hh>
@@ -244,6 +247,62 @@ void test_mult(FieldMatrix<K, n, m>& A,
   A.usmhv(scalar2,fT,vT);
 }
 
+// Compares the matrix-matrix products with the plain triple loop. The
+// entries are small integers, so that the products are exact.
+template<class K, int n, int m, int p>
+void test_product()
+{
+  FieldMatrix<K,n,m> A;
+  FieldMatrix<K,m,p> B;
+  for (int i = 0; i < n; ++i)
+    for (int k = 0; k < m; ++k)
+      A[i][k] = K((3*i + 5*k) % 7) - K(3);
+  for (int k = 0; k < m; ++k)
+    for (int j = 0; j < p; ++j)
+      B[k][j] = K((2*k + 3*j) % 5) - K(2);
+
+  FieldMatrix<K,n,p> reference;
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < p; ++j)
+    {
+      reference[i][j] = 0;
+      for (int k = 0; k < m; ++k)
+        reference[i][j] += A[i][k] * B[k][j];
+    }
+
+  if (A * B != reference)
+    DUNE_THROW(FMatrixError, "operator* test failed for " << n << "x" << m << "x" << p);
+  if (A.rightmultiplyany(B) != reference)
+    DUNE_THROW(FMatrixError, "rightmultiplyany test failed for " << n << "x" << m << "x" << p);
+  if (B.leftmultiplyany(A) != reference)
+    DUNE_THROW(FMatrixError, "leftmultiplyany test failed for " << n << "x" << m << "x" << p);
+
+  if constexpr (m == p)
+  {
+    auto C = A;
+    C.rightmultiply(B);
+    if (C != reference)
+      DUNE_THROW(FMatrixError, "rightmultiply test failed for " << n << "x" << m << "x" << p);
+  }
+  if constexpr (n == m)
+  {
+    auto C = B;
+    C.leftmultiply(A);
+    if (C != reference)
+      DUNE_THROW(FMatrixError, "leftmultiply test failed for " << n << "x" << m << "x" << p);
+  }
+  if constexpr (n == m && m == p)
+  {
+    // the matrix multiplied with itself
+    auto C = A;
+    C.rightmultiply(C);
+    auto D = A;
+    D.leftmultiply(D);
+    if (C != A*A || D != A*A)
+      DUNE_THROW(FMatrixError, "self multiplication test failed for " << n);
+  }
+}
+
 template<class K, class K2, class K3, int n, int m>
 void test_matrix()
 {
@@ -635,6 +694,135 @@ int test_determinant()
   return ret;
 }
 
+// Compares the closed forms of invert, determinant and solve for small sizes
+// with the LU decomposition, lane-wise for Simd field types
+template<class K, int n>
+void test_closed_form()
+{
+  using std::abs;
+  using std::max;
+  using Scalar = Simd::Scalar<K>;
+  using real_type = Simd::Scalar<typename FieldTraits<K>::real_type>;
+  const real_type tolerance = 100 * std::numeric_limits<real_type>::epsilon();
+
+  auto check = [&](const K& value, const K& expected, const char* what) {
+    for (std::size_t l = 0; l < Simd::lanes(value); ++l)
+    {
+      const Scalar v = Simd::lane(l, value);
+      const Scalar e = Simd::lane(l, expected);
+      if (abs(v - e) > tolerance * max(real_type(1), real_type(abs(e))))
+        DUNE_THROW(FMatrixError, "closed form " << what << " of " << n << "x" << n << " "
+                   << className<K>() << " matrix is " << v << " in lane " << l
+                   << ", expected " << e);
+    }
+  };
+
+  // diagonally dominant, integer-valued entries that differ between lanes
+  FieldMatrix<K,n,n> A, I(0);
+  FieldVector<K,n> b;
+  for (int i = 0; i < n; ++i)
+  {
+    I[i][i] = 1;
+    for (std::size_t l = 0; l < Simd::lanes(b[i]); ++l)
+    {
+      Simd::lane(l, b[i]) = Scalar(i - int(l));
+      for (int j = 0; j < n; ++j)
+        Simd::lane(l, A[i][j]) = Scalar(i == j ? n + 1 + int(l) : (i*7 + j*3 + int(l)) % 5 - 2);
+    }
+  }
+  DenseLU<FieldMatrix<K,n,n>> lu(A);
+
+  check(A.determinant(), lu.determinant(), "determinant");
+
+  FieldVector<K,n> x, xref;
+  A.solve(x, b);
+  lu.solve(xref, b);
+  for (int i = 0; i < n; ++i)
+    check(x[i], xref[i], "solve");
+
+  FieldMatrix<K,n,n> inverse = A, inverseref, helpInverse, helpTransposed;
+  inverse.invert();
+  lu.solve(inverseref, I);
+  const K det = FMatrixHelp::invertMatrix(A, helpInverse);
+  const K detTransposed = FMatrixHelp::invertMatrix_retTransposed(A, helpTransposed);
+  check(det, lu.determinant(), "FMatrixHelp::invertMatrix determinant");
+  check(detTransposed, lu.determinant(), "FMatrixHelp::invertMatrix_retTransposed determinant");
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+    {
+      check(inverse[i][j], inverseref[i][j], "invert");
+      check(helpInverse[i][j], inverseref[i][j], "FMatrixHelp::invertMatrix");
+      check(helpTransposed[j][i], inverseref[i][j], "FMatrixHelp::invertMatrix_retTransposed");
+    }
+
+  if constexpr (Simd::lanes<K>() == 1)
+  {
+    DynamicMatrix<K> D = A;
+    check(D.determinant(), lu.determinant(), "DynamicMatrix determinant");
+    D.invert();
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < n; ++j)
+        check(D[i][j], inverseref[i][j], "DynamicMatrix invert");
+  }
+
+  // exactly singular in one lane
+  if (n > 1)
+  {
+    for (int j = 0; j < n; ++j)
+      Simd::lane(0, A[n-1][j]) = Simd::lane(0, A[0][j]);
+    lu.factorize(A);
+    check(A.determinant(), lu.determinant(), "singular determinant");
+    bool solveThrown = false, invertThrown = false;
+    try {
+      A.solve(x, b);
+    } catch (const FMatrixError&) {
+      solveThrown = true;
+    }
+    try {
+      A.invert();
+    } catch (const FMatrixError&) {
+      invertThrown = true;
+    }
+    // the 3x3 closed form of invert does not check for singular matrices
+    if (!solveThrown || (n != 3 && !invertThrown))
+      DUNE_THROW(FMatrixError, "closed form of singular " << n << "x" << n << " "
+                 << className<K>() << " matrix did not throw");
+  }
+}
+
+// solve with a float matrix and a double right hand side, which must convert
+// without narrowing in the closed forms
+template<int n>
+void test_mixed_solve()
+{
+  FieldMatrix<float,n,n> A;
+  FieldVector<double,n> b;
+  FieldVector<float,n> bf;
+  for (int i = 0; i < n; ++i)
+  {
+    b[i] = bf[i] = float(i + 1);
+    for (int j = 0; j < n; ++j)
+      A[i][j] = (i == j) ? float(n + 1) : float((i*7 + j*3) % 5 - 2);
+  }
+
+  FieldVector<float,n> x, xref;
+  A.solve(x, b);
+  A.solve(xref, bf);
+  if (x != xref)
+    DUNE_THROW(FMatrixError, "solve of a " << n << "x" << n
+               << " float matrix with a double right hand side gives " << x
+               << ", expected " << xref);
+
+  DynamicMatrix<float> D = A;
+  DynamicVector<float> y(n);
+  D.solve(y, b);
+  for (int i = 0; i < n; ++i)
+    if (y[i] != xref[i])
+      DUNE_THROW(FMatrixError, "solve of a " << n << "x" << n
+                 << " float DynamicMatrix with a double right hand side gives " << y
+                 << ", expected " << xref);
+}
+
 template<class ft>
 struct ScalarOperatorTest
 {
@@ -967,6 +1155,34 @@ int main()
     test_invert< std::complex< float >, 2 >();
     errors += test_invert_solve();
 
+    test_closed_form<double, 2>();
+    test_closed_form<double, 3>();
+    test_closed_form<double, 4>();
+    test_closed_form<float, 4>();
+    test_closed_form<std::complex<double>, 4>();
+    test_closed_form<Dune::LoopSIMD<double, 4>, 3>();
+    test_closed_form<Dune::LoopSIMD<double, 4>, 4>();
+    test_mixed_solve<3>();
+    test_mixed_solve<4>();
+    test_mixed_solve<5>();
+
+    // matrix-matrix products with and without the blocked kernel
+    test_product<double, 3, 3, 3>();
+    test_product<double, 4, 4, 4>();
+    test_product<double, 5, 7, 9>();
+    test_product<double, 8, 8, 8>();
+    test_product<double, 13, 16, 16>();
+    test_product<double, 6, 7, 17>();
+    test_product<double, 20, 20, 20>();
+    test_product<double, 23, 32, 25>();
+    test_product<double, 32, 32, 32>();
+    test_product<double, 33, 33, 33>();
+    test_product<float, 12, 12, 12>();
+    test_product<float, 21, 21, 21>();
+    test_product<int, 6, 6, 6>();
+    test_product<int, 18, 5, 18>();
+    test_product<std::complex<double>, 5, 5, 5>();
+
     {  // Test whether multiplying one-column matrices by scalars work
       FieldMatrix<double,3,1> A = {1,2,3};
       double v = 0;